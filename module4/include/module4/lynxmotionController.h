@@ -0,0 +1,127 @@
+/*******************************************************************************************************************
+*
+*   Interface file for the LynxMotion AL5D controller node
+*
+*   The node subscribes to the /lynxmotion_al5d/joints_positions/command topic and drives the physical robot
+*   through the SSC-32 servo controller, so that a robot program can control either the simulator or the
+*   physical robot simply by publishing joint angles on that topic.
+*
+*   Joint commands are passed from the ROS callback thread to a dedicated serial writer thread through a
+*   single-producer / single-consumer lock-free ring buffer so that a slow serial line never blocks message intake.
+*   The writer always sends the newest command in the ring and drops the stale ones; if the ring is full, the
+*   callback discards the oldest command to make room, so the newest setpoint is never lost.
+*   The writer sleeps on a condition variable while the ring is empty and is woken by the callback.
+*   It takes a command from the ring only when the serial port has sent everything before it, so that it never
+*   blocks on the port with a command that has gone stale in the meantime.
+*
+*   Audit Trail
+*   -----------
+*   17 October 2026: created
+*
+*   17 October 2026: the writer blocks on a condition variable instead of polling the ring every millisecond;
+*                    the gripper is commanded at twice the joint speed, as in grasp()
+*
+*   17 October 2026: a full ring discards its oldest command instead of the new one (pushOverwrite());
+*                    the writer waits for the serial port with serialPortReady() before taking a command
+*
+********************************************************************************************************************/
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <std_msgs/UInt64MultiArray.h>
+#include <module4/lynxmotionUtilities.h>
+
+
+/***************************************************************************************************************************
+
+   Definitions for the controller
+
+****************************************************************************************************************************/
+
+#define COMMAND_RING_SIZE 256    // must be a power of two
+#define STATUS_RATE       1      // Hz at which the queue depth and drop counters are published
+#define WRITER_POLL_TIME  5      // ms the writer waits for the serial port before checking again for a newer command
+
+struct JointCommand {
+   double joint_value[6];        // five joint angles in radians and the gripper distance in metres
+};
+
+
+/* Single-producer / single-consumer lock-free ring buffer                                                     */
+/* push() and pushOverwrite() must only be called from one thread and pop() from one other thread              */
+/* head and tail are free-running counters; the slot index is the counter modulo N                             */
+/*                                                                                                             */
+/* pushOverwrite() discards the oldest entry of a full ring by advancing tail, so both threads advance tail    */
+/* with compare-and-swap.  The slot it then reuses may be the one pop() is copying: pop() only keeps its copy  */
+/* if tail has not moved meanwhile, and otherwise tries again with the next entry.                             */
+
+template <typename T, unsigned int N>
+class CommandRing {
+public:
+   CommandRing() : head(0), tail(0) {}
+
+   bool push(const T &item) {   // producer: returns false if the ring is full
+      unsigned int h = head.load(std::memory_order_relaxed);
+      if (h - tail.load(std::memory_order_acquire) == N) return false;
+      slot[h & (N - 1)] = item;
+      head.store(h + 1, std::memory_order_release);
+      return true;
+   }
+
+   bool pushOverwrite(const T &item) {   // producer: returns false if the oldest entry was discarded to make room
+      unsigned int h = head.load(std::memory_order_relaxed);
+      unsigned int t = tail.load(std::memory_order_acquire);
+      bool discarded = false;
+      if (h - t == N) {                   // full: fails only if pop() has just taken the oldest entry itself
+         discarded = tail.compare_exchange_strong(t, t + 1, std::memory_order_acq_rel, std::memory_order_acquire);
+      }
+      slot[h & (N - 1)] = item;
+      head.store(h + 1, std::memory_order_release);
+      return !discarded;
+   }
+
+   bool pop(T &item) {          // consumer: returns false if the ring is empty
+      unsigned int t = tail.load(std::memory_order_acquire);
+      do {
+         if (head.load(std::memory_order_acquire) == t) return false;
+         item = slot[t & (N - 1)];
+      } while (!tail.compare_exchange_weak(t, t + 1, std::memory_order_acq_rel, std::memory_order_acquire));
+      return true;
+   }
+
+   unsigned int depth() const {
+      return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+   }
+
+private:
+   static_assert((N & (N - 1)) == 0, "CommandRing size must be a power of two");
+
+   T slot[N];
+   alignas(64) std::atomic<unsigned int> head;   // written by the producer only
+   alignas(64) std::atomic<unsigned int> tail;   // written by the consumer only
+};
+
+
+/* counters exposed on the status topic */
+
+struct ControllerStatistics {
+   std::atomic<unsigned long> received;          // commands received on the topic
+   std::atomic<unsigned long> sent;              // commands written to the serial port
+   std::atomic<unsigned long> dropped_stale;     // commands superseded by a newer one before they were sent
+   std::atomic<unsigned long> dropped_full;      // oldest commands discarded because the ring was full
+};
+
+
+/***************************************************************************************************************************
+
+   Function prototypes
+
+****************************************************************************************************************************/
+
+void jointCommandCallback(const std_msgs::Float64MultiArray::ConstPtr& msg);
+void startSerialWriter();
+void stopSerialWriter();
+void publishControllerStatus(ros::Publisher &pub);
+bool sendJointCommand(JointCommand &command);
@@ -12,6 +12,49 @@
 *   David Vernon
 *   13 October 2022
 *
+*   Added a persistent serial port connection to the SSC-32 servo controller:
+*   openSerialPort(), closeSerialPort(), flushSerialPort()
+*   17 October 2026
+*
+*   Added serialPortReady()
+*   17 October 2026
+*
+*   Added moveTrajectory(), computePose(), and executeGroupMove()
+*   17 October 2026
+*
+*   Added TRAJECTORY_RATE and GROUP_MOVE_LENGTH: moveTrajectory() streams interpolated setpoints
+*   17 October 2026
+*
+*   Rewrote the Frame class as a rigid transformation with value semantics: non-mutating operator*,
+*   constexpr construction, and AVX2 multiplication kernels
+*   17 October 2026
+*
+*   move() takes its Frame by const reference; added Frame::element() for reading a transformation outside the class
+*   17 October 2026
+*
+*   Frame::operator* is defined inline here; Frame is no longer declared alignas(32), which std::vector<Frame> does not
+*   honour before C++17
+*   17 October 2026
+*
+*   Added computeJointAnglesBatch()
+*   17 October 2026
+*
+*   Added the reachability map: buildReachabilityMap(), openReachabilityMap(), pose_reachable(), frame_reachable()
+*   17 October 2026
+*
+*   The reachability map stores dilated cells (REACHABILITY_VERSION 2, REACHABILITY_MARGIN): a clear bit rejects a pose
+*   17 October 2026
+*
+*   Added waitUntilReached()
+*   17 October 2026
+*
+*   Added startRobotConnection() and waitForRobotConnection(): one shared connection for setJointAngles() and grasp()
+*   17 October 2026
+*
+*   lynxmotionUtilities.cpp is now built as the al5d_core library, which is also linked by the robot nodes in module5;
+*   ROS_PACKAGE_NAME, MAX, and MIN are only defined if the including package has not already defined them
+*   17 October 2026
+*
 ********************************************************************************************************************
 
 
@@ -36,6 +79,13 @@
 #include <iostream>
 #include <math.h>
 #include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#if defined(__AVX2__) && defined(__FMA__)
+    #include <immintrin.h>
+#endif
 
 #ifdef ROS
     #include <ros/ros.h>
@@ -54,7 +104,15 @@ using namespace std;
 #include <float.h>
 #ifdef ROS
        #include <unistd.h>
-       #define ROS_PACKAGE_NAME "module4"
+       #include <fcntl.h>
+       #include <errno.h>
+       #include <poll.h>
+       #include <termios.h>
+       #include <sys/mman.h>
+       #include <sys/stat.h>
+       #ifndef ROS_PACKAGE_NAME                  // a package that links al5d_core defines its own name before including this file
+          #define ROS_PACKAGE_NAME "module4"
+       #endif
 #else
        #include <Windows.h>
 #endif
@@ -94,6 +152,8 @@ typedef char keyword[KEY_LENGTH];
 
 #define DEFAULT_SLEEP_TIME 5   
 #define COMMAND_SIZE 200
+#define SERIAL_QUEUE_SIZE 4096     // bytes of servo commands held while the serial port is busy
+#define SERIAL_FLUSH_TIMEOUT 1000  // ms to wait for queued commands to drain
 #define MAX_SERVOS 32
 #define MIN_PW 750  //lowest pulse width
 #define MAX_PW 2250 //highest pulsewidth
@@ -107,8 +167,12 @@ typedef char keyword[KEY_LENGTH];
 #define MIN_Z    0
 #define MAX_Z  380
 
+#ifndef MAX                                      // also defined by OpenCV
 #define MAX(x, y) (((x) > (y)) ? (x) : (y))
+#endif
+#ifndef MIN
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
+#endif
 
 /***************************************************************************************************************************
 
@@ -121,18 +185,38 @@ typedef char keyword[KEY_LENGTH];
    Author: David Vernon, Carnegie Mellon University Africa, Rwanda
    Date:   22/02/2017
 
+   All frames are rigid-body transformations, so a Frame stores only the 3x3 rotation and the translation, 
+   one row of [R | p] per row of coefficient[][]; the bottom row of the homogeneous matrix is always 0 0 0 1.
+   The product of two frames is a new frame: neither operand is modified.
+   trans() and the Frame constructors are constexpr so that constant frames can be built at compile time.
+   If compiled with -mavx2 -mfma (see AL5D_AVX2 in CMakeLists.txt), operator* uses AVX2 kernels,
+   one 256-bit register per row.
+   operator* is defined inline below so that it is inlined in the caller; the rows are loaded and stored
+   unaligned, so a Frame needs no more than the alignment of a double, e.g. in a std::vector<Frame>.
+   17/10/2026
+
 ****************************************************************************************************************************/
 
 #define MAX_MESSAGE_LENGTH 81
+#define TRAJECTORY_SEGMENT_TIME 200   // default time in ms between the waypoints of a trajectory
+#define TRAJECTORY_RATE       50      // Hz at which moveTrajectory() streams setpoints between the waypoints
+#define GROUP_MOVE_LENGTH     48      // characters in a five-servo SSC-32 group move, e.g. " #0P1480 #1P1550 #8P1560 #3P1440 #4P1470 T20 "
+#define WAIT_TOLERANCE        0.02    // radians: default joint angle tolerance for waitUntilReached()
+#define WAIT_TIMEOUT          5000    // ms: default timeout for waitUntilReached()
+#define WAIT_SETTLE_SAMPLES   5       // number of joint states without motion after which a moving robot has stopped
+#define JOINT_STATIONARY      0.0005  // change in joint position between two joint states below which a joint is not moving
+#define GRIPPER_TOLERANCE     0.001   // m: gripper distance tolerance for waitUntilReached()
+#define JOINT_STATE_TIMEOUT   1000    // ms without a joint state after which waitUntilReached() uses the estimated motion time
+#define ROBOT_CONNECTION_CHECK 1000   // ms between checks for a ROS shutdown while waiting for a subscriber to the command topic
 
 class Vector {
 public:
    Vector(double x=0, double y=0, double z=0, double w=1);
    void setValues(double x, double y, double z, double w);
-   void getValues(double &x, double &y, double &z, double &w);
+   void getValues(double &x, double &y, double &z, double &w) const;
    void printVector()const;
-   friend Vector operator+(Vector &a, Vector &b);
-   friend double dotProduct(Vector &a, Vector &b);
+   friend Vector operator+(Vector const& a, Vector const& b);
+   friend double dotProduct(Vector const& a, Vector const& b);
 private:
    double coefficient[4];
 };
@@ -140,35 +224,101 @@ private:
 
 class Frame {
 public:
-   Frame();
+   constexpr Frame()                                 // identity
+      : coefficient{{1, 0, 0, 0},
+                    {0, 1, 0, 0},
+                    {0, 0, 1, 0}} {}
+   constexpr Frame(double r00, double r01, double r02, double px,
+                   double r10, double r11, double r12, double py,
+                   double r20, double r21, double r22, double pz)
+      : coefficient{{r00, r01, r02, px},
+                    {r10, r11, r12, py},
+                    {r20, r21, r22, pz}} {}
    void printFrame()const;
-   Frame        &operator*(Frame const& h);
-   Frame        &operator=(Frame const& h);
-   friend Frame trans(float x, float y, float z);
+   constexpr double element(int i, int j) const {    // row i, column j of the 4x4 homogeneous transformation
+      return i < 3 ? coefficient[i][j] : (j == 3 ? 1 : 0);
+   }
+   Frame        operator*(Frame const& h) const;
    friend Frame rotx(float theta);
    friend Frame roty(float theta);
    friend Frame rotz(float theta);
-   friend Frame inv(Frame h);
-   friend bool  move(Frame h);
+   friend Frame inv(Frame const& h);
+   friend bool  move(Frame const& h);
+   friend bool  computePose(Frame const& T5, double &x, double &y, double &z, double &pitch, double &roll);
 private:
-   double coefficient[4][4];
+   double coefficient[3][4];                         // [R | p]
 };
 
+
+/* product of two rigid transformations                                                 */
+/*                                                                                      */
+/* [Ra | pa] [Rb | pb]   [Ra Rb | Ra pb + pa]                                           */
+/* [0  |  1] [0  |  1] = [0     |         1]                                            */
+/*                                                                                      */
+/* Row i of the result is a[i][0] b.row0 + a[i][1] b.row1 + a[i][2] b.row2 + a[i][3] e3 */
+/* where e3 = (0 0 0 1); with AVX2 each row is one 256-bit register                     */
+
+inline Frame Frame::operator*(Frame const& h) const { 
+
+   Frame result;
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+   const __m256d b0 = _mm256_loadu_pd(h.coefficient[0]);
+   const __m256d b1 = _mm256_loadu_pd(h.coefficient[1]);
+   const __m256d b2 = _mm256_loadu_pd(h.coefficient[2]);
+   const __m256d e3 = _mm256_set_pd(1, 0, 0, 0);
+   __m256d row;
+
+   for (int i=0; i<3; i++) {
+      row = _mm256_mul_pd(_mm256_set1_pd(coefficient[i][0]), b0);
+      row = _mm256_fmadd_pd(_mm256_set1_pd(coefficient[i][1]), b1, row);
+      row = _mm256_fmadd_pd(_mm256_set1_pd(coefficient[i][2]), b2, row);
+      row = _mm256_fmadd_pd(_mm256_set1_pd(coefficient[i][3]), e3, row);
+      _mm256_storeu_pd(result.coefficient[i], row);
+   }
+
+#else
+
+   for (int i=0; i<3; i++) {
+      for (int j=0; j<4; j++) {
+         result.coefficient[i][j] = coefficient[i][0] * h.coefficient[0][j]
+                                  + coefficient[i][1] * h.coefficient[1][j]
+                                  + coefficient[i][2] * h.coefficient[2][j];
+      }
+      result.coefficient[i][3] += coefficient[i][3];
+   }
+
+#endif
+
+   return result;
+}
+
 /* function prototypes */
 
-Vector operator+(Vector &a, Vector &b);
-double dotProduct(Vector &a, Vector &b);
-Frame trans(float x, float y, float z);
+Vector operator+(Vector const& a, Vector const& b);
+double dotProduct(Vector const& a, Vector const& b);
+constexpr Frame trans(float x, float y, float z) {
+   return Frame(1, 0, 0, x,
+                0, 1, 0, y,
+                0, 0, 1, z);
+}
 Frame rotx(float theta);
 Frame roty(float theta);
 Frame rotz(float theta);
-Frame inv(Frame h);
+Frame inv(Frame const& h);
 
-bool move(Frame T5);
+bool move(Frame const& T5);
+inline bool move(Frame& T5)  { return move(static_cast<Frame const&>(T5)); }   // with using namespace std, std::move() would
+inline bool move(Frame&& T5) { return move(static_cast<Frame const&>(T5)); }   // otherwise be the better match for these
+bool moveTrajectory(std::vector<Frame> &path, int segment_time = TRAJECTORY_SEGMENT_TIME);
+bool computePose(Frame const& T5, double &x, double &y, double &z, double &pitch, double &roll);
 void grasp(int d);
+bool waitUntilReached(double tolerance = WAIT_TOLERANCE, int timeout_ms = WAIT_TIMEOUT);
 
 void wait(int ms);
 void prompt_and_exit(int status);
+void prompt_and_continue();
 void print_message_to_file(FILE *fp, char message[]);
 
 
@@ -188,9 +338,14 @@ void print_message_to_file(FILE *fp, char message[]);
  */ 
 
 void goHome();
-void sendToSerialPort(char *command);
+bool openSerialPort(char *port, int baud);
+void closeSerialPort();
+bool flushSerialPort(int timeout_ms);
+bool serialPortReady(int timeout_ms);
+bool sendToSerialPort(char *command);
 void executeCommand(int channel, int pos, int speed);                           // single servo motor
 void executeCommand(int * channel, int * pos, int speed, int number_of_servos); // multiple servo motors
+void executeGroupMove(int * channel, int * pos, int number_of_servos, int time_ms); // multiple servo motors, timed
 
 // Helper function prototypes
 void fail(char *message);
@@ -213,7 +368,11 @@ void fail(char *message);
 
 
 bool computeJointAngles(double x, double y, double z, double pitch, double roll, double joint_angles[]);
+int  computeJointAnglesBatch(int n, const double x[], const double y[], const double z[], const double pitch[], const double roll[],
+                             double *joint_angles[5], unsigned char valid[]);
 bool setJointAngles(double joint_angles[]);
+void startRobotConnection();
+bool waitForRobotConnection();
 bool computeServoPositions(double joint_angles[], int servo_positions[]);
 
 //int  gotoPose(float x, float y, float z, float pitch, float roll);
@@ -229,6 +388,51 @@ void jointStates(const sensor_msgs::JointState::ConstPtr& msg);
 #endif
 
 
+/***************************************************************************************************************************
+
+   Reachability map
+
+   A bit-packed voxel map of the (x, y, z, pitch) wrist poses that are reachable by a given robot, i.e. poses for which 
+   computeJointAngles() has a solution and computeServoPositions() gives pulse widths between MIN_PW and MAX_PW 
+   for joints 1 to 4.  The map covers the working envelope MIN_X .. MAX_X, MIN_Y .. MAX_Y, MIN_Z .. MAX_Z with one 
+   sample every REACHABILITY_VOXEL_SIZE mm and REACHABILITY_PITCH_STEP degrees.
+   
+   The map is built for each robot configuration file by the reachabilityMap application and is memory-mapped at 
+   runtime so that a task planner can reject an unreachable pose with one bit lookup.  The bit of each cell between
+   samples is set if any sample within REACHABILITY_MARGIN samples of the cell is reachable, so a clear bit means 
+   that the pose is not reachable; a set bit means that it may be.  frame_reachable() rejects a pose whose bit is 
+   clear and confirms the others with the inverse kinematics.
+
+****************************************************************************************************************************/
+
+#define REACHABILITY_MAGIC       "AL5DRMAP"
+#define REACHABILITY_VERSION     2     // version 1 maps stored samples rather than dilated cells
+#define REACHABILITY_VOXEL_SIZE  10    // mm
+#define REACHABILITY_PITCH_MIN -180    // degrees; see computePose() for the pitch range
+#define REACHABILITY_PITCH_MAX    0
+#define REACHABILITY_PITCH_STEP  15    // degrees
+#define REACHABILITY_MARGIN      1     // samples by which the reachable samples are dilated into the cells of the map
+
+struct reachabilityMapHeaderType {
+   char  magic[8];                    // REACHABILITY_MAGIC, without the terminating null
+   int   version;
+   int   min_x, min_y, min_z;         // position of voxel (0, 0, 0) in mm
+   int   min_pitch;                   // pitch of pitch index 0 in degrees
+   int   voxel_size;                  // mm
+   int   pitch_step;                  // degrees
+   int   nx, ny, nz, npitch;          // number of samples, and of cells, along each axis
+   int   home[6];                     // calibration data of the robot for which the map was built
+   float degree[6];
+};
+
+bool buildReachabilityMap(char filename[]);
+bool openReachabilityMap(char filename[]);
+void closeReachabilityMap();
+bool pose_reachable(float x, float y, float z, float pitch);
+bool frame_reachable(Frame const& T5);
+void reachabilityMapFilename(char robot_configuration_filename[], char map_filename[]);
+
+
 /***************************************************************************************************************************
 
    Robot Configuration 
@@ -250,6 +454,8 @@ struct robotConfigurationDataType {
    bool  simulator;                   // flag to indicate that the simulator is being used
 };
 
+extern struct robotConfigurationDataType robotConfigurationData;   // defined in lynxmotionUtilities.cpp
+
 void readRobotConfigurationData(char filename[]);
 
 /***************************************************************************************************************************
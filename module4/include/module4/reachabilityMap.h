@@ -0,0 +1,31 @@
+/*******************************************************************************************************************
+*
+*   Interface file for the LynxMotion AL5D reachability map builder
+*
+*   Audit Trail
+*   -----------
+*   17 October 2026: created
+*
+********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ros/ros.h>
+#include <module4/lynxmotionUtilities.h>
+
+using namespace std;
+
+
+/***************************************************************************************************************************
+
+   Utility functions 
+
+****************************************************************************************************************************/
+
+void prompt_and_exit(int status);
+void prompt_and_continue();
+void display_error_and_exit(const char *error_message);
+void print_message_to_file(FILE *fp, char message[]);
+void fail(char *message);
+void wait(int ms);
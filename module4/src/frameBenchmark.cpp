@@ -0,0 +1,269 @@
+/*******************************************************************************************************************
+*   Benchmark of the Frame algebra
+*   ------------------------------
+*
+*   This application times the chain of transformations that pickAndPlace evaluates for every pose,
+*
+*      T6 = inv(Z) * object * object_grasp * object_approach * inv(E)
+*
+*   both including the construction of the frames with trans(), rotz(), and roty(), and with the frames built
+*   beforehand so that only inv() and operator* are timed, using two implementations:
+*
+*   - legacy: the original Frame class, a full 4x4 matrix with a mutating operator*, reproduced below
+*   - al5d_core: the current Frame class, a 3x4 rigid transformation with a non-mutating operator*
+*
+*   The poses are drawn at random from the workspace.  Every element of the two results is compared; the
+*   application reports the number of elements that differ and the largest difference.  With the scalar kernel
+*   and -ffp-contract=off the results are identical.  With the AVX2/FMA kernel (AL5D_AVX2) each product is rounded
+*   once rather than twice, so the results differ in the last bits.
+*
+*   Usage: frameBenchmark [number of chains, default 1000000]
+*
+*   The exit status is 0 if no element differs by more than FRAME_BENCHMARK_TOLERANCE and 1 otherwise.
+*
+*   Audit Trail
+*   -----------
+*   17 October 2026: created
+*
+*******************************************************************************************************************/
+
+#include <module4/lynxmotionUtilities.h>
+
+#define FRAME_BENCHMARK_DEFAULT_CHAINS 1000000
+#define FRAME_BENCHMARK_POSES          1024
+#define FRAME_BENCHMARK_TOLERANCE      1e-12
+
+
+/* the original Frame class, kept here as the reference */
+
+namespace legacy {
+
+class Frame {
+public:
+   Frame() {
+      for (int i=0; i<4; i++)
+         for (int j=0; j<4; j++)
+            coefficient[i][j] = (i == j) ? 1 : 0;
+   }
+   Frame &operator*(Frame const& h) {             // overwrites the left operand, as the original did
+      Frame  result;
+      double temp;
+      for (int i=0; i<4; i++) {
+         for (int j=0; j<4; j++) {
+            temp = 0;
+            for (int k=0; k<4; k++) temp = temp + coefficient[i][k] * h.coefficient[k][j];
+            result.coefficient[i][j] = temp;
+         }
+      }
+      for (int i=0; i<4; i++)
+         for (int j=0; j<4; j++)
+            coefficient[i][j] = result.coefficient[i][j];
+      return *this;
+   }
+   double coefficient[4][4];
+};
+
+Frame trans(float x, float y, float z) {
+   Frame result;
+   result.coefficient[0][3] = x;
+   result.coefficient[1][3] = y;
+   result.coefficient[2][3] = z;
+   return result;
+}
+
+Frame rotz(float theta) {
+   Frame  result;
+   double thetaRadians = (3.14159 * theta) / 180.0;
+   result.coefficient[0][0] = cos(thetaRadians);
+   result.coefficient[0][1] = -sin(thetaRadians);
+   result.coefficient[1][0] = sin(thetaRadians);
+   result.coefficient[1][1] = cos(thetaRadians);
+   return result;
+}
+
+Frame roty(float theta) {
+   Frame  result;
+   double thetaRadians = (3.14159 * theta) / 180.0;
+   result.coefficient[0][0] = cos(thetaRadians);
+   result.coefficient[0][2] = sin(thetaRadians);
+   result.coefficient[2][0] = -sin(thetaRadians);
+   result.coefficient[2][2] = cos(thetaRadians);
+   return result;
+}
+
+Frame inv(Frame h) {                              // by value, as the original was
+   Frame result;
+   for (int i=0; i<3; i++)
+      for (int j=0; j<3; j++)
+         result.coefficient[j][i] = h.coefficient[i][j];
+   for (int i=0; i<3; i++) {                      // dotProduct() divided by w = 1 exactly
+      result.coefficient[i][3] = -(h.coefficient[0][i] / 1 * h.coefficient[0][3] / 1 +
+                                   h.coefficient[1][i] / 1 * h.coefficient[1][3] / 1 +
+                                   h.coefficient[2][i] / 1 * h.coefficient[2][3] / 1);
+   }
+   return result;
+}
+
+} // namespace legacy
+
+
+/* one pose: the parameters that pickAndPlace reads from its input and configuration files */
+
+typedef struct {
+   float object_x, object_y, object_z, object_phi;
+   float grasp_x,  grasp_y,  grasp_z,  grasp_theta;
+   float approach_distance;
+   float effector_x, effector_y, effector_z;
+} poseType;
+
+
+typedef struct {
+   legacy::Frame E, Z, object, object_grasp, object_approach;
+} legacyFramesType;
+
+typedef struct {
+   Frame E, Z, object, object_grasp, object_approach;
+} framesType;
+
+
+static float uniform(float low, float high) {
+   return low + (high - low) * (float) rand() / (float) RAND_MAX;
+}
+
+
+static legacy::Frame legacyChain(poseType const& p) {
+
+   legacy::Frame E               = legacy::trans(p.effector_x, p.effector_y, p.effector_z);
+   legacy::Frame Z               = legacy::trans(0.0, 0.0, 0.0);
+   legacy::Frame object          = legacy::trans(p.object_x, p.object_y, p.object_z) * legacy::rotz(p.object_phi);
+   legacy::Frame object_grasp    = legacy::trans(p.grasp_x, p.grasp_y, p.grasp_z) * legacy::roty(p.grasp_theta);
+   legacy::Frame object_approach = legacy::trans(0, 0, -p.approach_distance);
+
+   return legacy::inv(Z) * object * object_grasp * object_approach * legacy::inv(E);
+}
+
+
+static Frame chain(poseType const& p) {
+
+   Frame E               = trans(p.effector_x, p.effector_y, p.effector_z);
+   Frame Z               = trans(0.0, 0.0, 0.0);
+   Frame object          = trans(p.object_x, p.object_y, p.object_z) * rotz(p.object_phi);
+   Frame object_grasp    = trans(p.grasp_x, p.grasp_y, p.grasp_z) * roty(p.grasp_theta);
+   Frame object_approach = trans(0, 0, -p.approach_distance);
+
+   return inv(Z) * object * object_grasp * object_approach * inv(E);
+}
+
+
+int main(int argc, char ** argv) {
+
+   int    number_of_chains = (argc > 1) ? atoi(argv[1]) : FRAME_BENCHMARK_DEFAULT_CHAINS;
+   static poseType         poses[FRAME_BENCHMARK_POSES];
+   static legacyFramesType legacy_frames[FRAME_BENCHMARK_POSES];
+   static framesType       frames[FRAME_BENCHMARK_POSES];
+   long   differing_elements = 0;
+   double max_difference     = 0;
+   double difference;
+   double legacy_ns, new_ns;
+   double legacy_product_ns, new_product_ns;
+   volatile double sink = 0;
+   int    i, j, k;
+
+   std::chrono::steady_clock::time_point start;
+
+   srand(1);
+
+   for (k=0; k<FRAME_BENCHMARK_POSES; k++) {
+      poses[k].object_x          = uniform(MIN_X, MAX_X);
+      poses[k].object_y          = uniform(MIN_Y, MAX_Y);
+      poses[k].object_z          = uniform(0, 50);
+      poses[k].object_phi        = uniform(-180, 180);
+      poses[k].grasp_x           = uniform(-20, 20);
+      poses[k].grasp_y           = uniform(-20, 20);
+      poses[k].grasp_z           = uniform(0, 30);
+      poses[k].grasp_theta       = uniform(90, 180);
+      poses[k].approach_distance = uniform(0, 60);
+      poses[k].effector_x        = 0;
+      poses[k].effector_y        = 0;
+      poses[k].effector_z        = uniform(10, 30);
+
+      legacy_frames[k].E               = legacy::trans(poses[k].effector_x, poses[k].effector_y, poses[k].effector_z);
+      legacy_frames[k].Z               = legacy::trans(0.0, 0.0, 0.0);
+      legacy_frames[k].object          = legacy::trans(poses[k].object_x, poses[k].object_y, poses[k].object_z) * legacy::rotz(poses[k].object_phi);
+      legacy_frames[k].object_grasp    = legacy::trans(poses[k].grasp_x, poses[k].grasp_y, poses[k].grasp_z) * legacy::roty(poses[k].grasp_theta);
+      legacy_frames[k].object_approach = legacy::trans(0, 0, -poses[k].approach_distance);
+
+      frames[k].E               = trans(poses[k].effector_x, poses[k].effector_y, poses[k].effector_z);
+      frames[k].Z               = trans(0.0, 0.0, 0.0);
+      frames[k].object          = trans(poses[k].object_x, poses[k].object_y, poses[k].object_z) * rotz(poses[k].object_phi);
+      frames[k].object_grasp    = trans(poses[k].grasp_x, poses[k].grasp_y, poses[k].grasp_z) * roty(poses[k].grasp_theta);
+      frames[k].object_approach = trans(0, 0, -poses[k].approach_distance);
+   }
+
+
+   /* compare every element of the two results */
+
+   for (k=0; k<FRAME_BENCHMARK_POSES; k++) {
+      legacy::Frame a = legacyChain(poses[k]);
+      Frame         b = chain(poses[k]);
+      for (i=0; i<4; i++) {
+         for (j=0; j<4; j++) {
+            difference = fabs(a.coefficient[i][j] - b.element(i, j));
+            if (a.coefficient[i][j] != b.element(i, j)) differing_elements++;
+            if (difference > max_difference) max_difference = difference;
+         }
+      }
+   }
+
+
+   /* time the two implementations */
+
+   start = std::chrono::steady_clock::now();
+   for (k=0; k<number_of_chains; k++) {
+      sink = sink + legacyChain(poses[k % FRAME_BENCHMARK_POSES]).coefficient[0][3];
+   }
+   legacy_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / number_of_chains;
+
+   start = std::chrono::steady_clock::now();
+   for (k=0; k<number_of_chains; k++) {
+      sink = sink + chain(poses[k % FRAME_BENCHMARK_POSES]).element(0, 3);
+   }
+   new_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / number_of_chains;
+
+   start = std::chrono::steady_clock::now();
+   for (k=0; k<number_of_chains; k++) {
+      legacyFramesType const& f = legacy_frames[k % FRAME_BENCHMARK_POSES];
+      sink = sink + (legacy::inv(f.Z) * f.object * f.object_grasp * f.object_approach * legacy::inv(f.E)).coefficient[0][3];
+   }
+   legacy_product_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / number_of_chains;
+
+   start = std::chrono::steady_clock::now();
+   for (k=0; k<number_of_chains; k++) {
+      framesType const& f = frames[k % FRAME_BENCHMARK_POSES];
+      sink = sink + (inv(f.Z) * f.object * f.object_grasp * f.object_approach * inv(f.E)).element(0, 3);
+   }
+   new_product_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / number_of_chains;
+
+
+   /* report */
+
+#if defined(__AVX2__) && defined(__FMA__)
+   printf("frameBenchmark: al5d_core Frame kernel: AVX2/FMA\n");
+#else
+   printf("frameBenchmark: al5d_core Frame kernel: scalar\n");
+#endif
+   printf("frameBenchmark: %d chains, building the frames: legacy %.1f ns per chain, al5d_core %.1f ns per chain (%.1fx)\n",
+          number_of_chains, legacy_ns, new_ns, new_ns > 0 ? legacy_ns / new_ns : 0.0);
+   printf("frameBenchmark: %d chains, frames prebuilt:      legacy %.1f ns per chain, al5d_core %.1f ns per chain (%.1fx)\n",
+          number_of_chains, legacy_product_ns, new_product_ns, new_product_ns > 0 ? legacy_product_ns / new_product_ns : 0.0);
+   printf("frameBenchmark: %ld of %d elements differ, largest difference %g\n",
+          differing_elements, FRAME_BENCHMARK_POSES * 16, max_difference);
+
+   if (max_difference > FRAME_BENCHMARK_TOLERANCE) {
+      printf("frameBenchmark: FAILED\n");
+      return 1;
+   }
+
+   printf("frameBenchmark: passed\n");
+   return 0;
+}
@@ -0,0 +1,128 @@
+/*******************************************************************************************************************
+*   Benchmark of the batched inverse kinematic solution
+*   ---------------------------------------------------
+*
+*   This application compares computeJointAnglesBatch() with computeJointAngles() over the whole workspace:
+*   x from MIN_X to MAX_X, y from MIN_Y to MAX_Y, and z from MIN_Z to MAX_Z in steps given by the first argument
+*   (default 5 mm), and pitch from REACHABILITY_PITCH_MIN to REACHABILITY_PITCH_MAX in steps of REACHABILITY_PITCH_STEP.
+*
+*   As in buildReachabilityMap(), each row of x samples is solved with one call to computeJointAnglesBatch();
+*   the same poses are then solved one at a time with computeJointAngles().  The application reports the time per
+*   pose of each, the number of poses whose reachability differs, and the largest difference between the joint
+*   angles of the poses that both solutions find reachable.
+*
+*   Usage: inverseKinematicsBenchmark [sample step in mm, default 5]
+*
+*   The exit status is 0 if the reachability of every pose agrees and no joint angle differs by more than
+*   IK_BENCHMARK_TOLERANCE radians, and 1 otherwise.
+*
+*   Audit Trail
+*   -----------
+*   17 October 2026: created
+*
+*******************************************************************************************************************/
+
+#include <module4/lynxmotionUtilities.h>
+
+#define IK_BENCHMARK_DEFAULT_STEP 5       // mm
+#define IK_BENCHMARK_TOLERANCE    1e-13   // radians
+
+
+int main(int argc, char ** argv) {
+
+   int    step = (argc > 1) ? atoi(argv[1]) : IK_BENCHMARK_DEFAULT_STEP;
+   int    nx;
+   int    i, j;
+   double yi, zi, pitch_i;
+
+   long   number_of_poses     = 0;
+   long   number_reachable    = 0;
+   long   reachability_differs = 0;
+   double max_difference      = 0;
+   double difference;
+   double batch_s  = 0;
+   double scalar_s = 0;
+
+   std::chrono::steady_clock::time_point start;
+
+   if (step <= 0) {
+      printf("inverseKinematicsBenchmark: the sample step must be a positive number of millimetres\n");
+      return 1;
+   }
+
+   nx = (MAX_X - MIN_X) / step + 1;
+
+   std::vector<double>        x(nx), y(nx), z(nx), pitch(nx), roll(nx);
+   std::vector<double>        angles(5 * nx);
+   std::vector<unsigned char> valid(nx);
+   std::vector<double>        scalar_angles(5 * nx);
+   std::vector<char>          scalar_valid(nx);
+   double                    *row_angles[5];
+
+   for (j=0; j<5; j++) row_angles[j] = &angles[j * nx];
+
+   for (i=0; i<nx; i++) {
+      x[i]    = MIN_X + i * step;
+      roll[i] = 0;
+   }
+
+   for (pitch_i = REACHABILITY_PITCH_MIN; pitch_i <= REACHABILITY_PITCH_MAX; pitch_i += REACHABILITY_PITCH_STEP) {
+      for (zi = MIN_Z; zi <= MAX_Z; zi += step) {
+         for (yi = MIN_Y; yi <= MAX_Y; yi += step) {
+
+            for (i=0; i<nx; i++) {
+               y[i]     = yi;
+               z[i]     = zi;
+               pitch[i] = pitch_i;
+            }
+
+            /* one row with the batched solution */
+
+            start = std::chrono::steady_clock::now();
+            number_reachable += computeJointAnglesBatch(nx, &x[0], &y[0], &z[0], &pitch[0], &roll[0], row_angles, &valid[0]);
+            batch_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            /* the same row one pose at a time */
+
+            start = std::chrono::steady_clock::now();
+            for (i=0; i<nx; i++) {
+               scalar_valid[i] = computeJointAngles(x[i], y[i], z[i], pitch[i], roll[i], &scalar_angles[5 * i]);
+            }
+            scalar_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            /* compare */
+
+            for (i=0; i<nx; i++) {
+               if (scalar_valid[i] != (valid[i] != 0)) {
+                  reachability_differs++;
+               }
+               else if (scalar_valid[i]) {
+                  for (j=0; j<5; j++) {
+                     difference = fabs(scalar_angles[5 * i + j] - row_angles[j][i]);
+                     if (difference > max_difference) max_difference = difference;
+                  }
+               }
+            }
+
+            number_of_poses += nx;
+         }
+      }
+   }
+
+
+   /* report */
+
+   printf("inverseKinematicsBenchmark: %ld poses sampled every %d mm, %ld reachable\n", number_of_poses, step, number_reachable);
+   printf("inverseKinematicsBenchmark: computeJointAngles() %.1f ns per pose, computeJointAnglesBatch() %.1f ns per pose (%.1fx)\n",
+          scalar_s * 1e9 / number_of_poses, batch_s * 1e9 / number_of_poses, batch_s > 0 ? scalar_s / batch_s : 0.0);
+   printf("inverseKinematicsBenchmark: reachability differs for %ld poses, largest joint angle difference %g radians\n",
+          reachability_differs, max_difference);
+
+   if (reachability_differs != 0 || max_difference > IK_BENCHMARK_TOLERANCE) {
+      printf("inverseKinematicsBenchmark: FAILED\n");
+      return 1;
+   }
+
+   printf("inverseKinematicsBenchmark: passed\n");
+   return 0;
+}
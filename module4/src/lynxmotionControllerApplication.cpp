@@ -0,0 +1,103 @@
+/*******************************************************************************************************************
+*   Controller node for a LynxMotion AL5D robot arm
+*   -----------------------------------------------
+*
+*   This application drives the physical robot from joint angles published on the
+*   /lynxmotion_al5d/joints_positions/command topic, i.e. the same topic used by the lynxmotion_al5d simulator.
+*   A robot program can therefore control either the simulator or the physical robot, depending on which of the
+*   two is running.
+*
+*   Each message contains six values: the five joint angles in radians and the gripper distance in metres.
+*
+*   The application reads one line from the input file lynxmotionControllerInput.txt.
+*   This contains the filename of the file with the robot calibration data (see pickAndPlaceApplication.cpp
+*   for a description of the configuration file).  The COM, BAUD, SPEED, CHANNEL, HOME, DEGREE, and WRIST keys are used.
+*
+*   Messages are received on the ROS callback thread and passed to a dedicated serial writer thread through
+*   a lock-free ring buffer; stale setpoints are dropped in favour of the newest.
+*   The queue depth and the received, sent, and dropped counters are published once a second as a
+*   std_msgs/UInt64MultiArray on the /lynxmotion_al5d/controller/status topic.
+*
+*   Audit Trail
+*   -----------
+*   17 October 2026: created
+*
+*******************************************************************************************************************/
+
+#include <module4/lynxmotionController.h>
+
+
+int main(int argc, char ** argv) {
+
+   ros::init(argc, argv, "lynxmotionController"); // Initialize the ROS system
+
+   extern robotConfigurationDataType robotConfigurationData;
+
+   bool debug = true;              // set this to false for silent mode
+
+   FILE *fp_in;                    // lynxmotionController input file
+   int  end_of_file;
+   char robot_configuration_filename[MAX_FILENAME_LENGTH];
+   char filename[MAX_FILENAME_LENGTH]  = {};
+   char directory[MAX_FILENAME_LENGTH] = {};
+
+   ros::NodeHandle n;
+   ros::Subscriber sub;
+   ros::Publisher  status_pub;
+   ros::AsyncSpinner spinner(1);   // the ROS callback thread: the producer for the command ring
+   ros::Rate rate(STATUS_RATE);
+
+
+   /* open the input file */
+   /* ------------------- */
+
+   strcat(directory, (ros::package::getPath(ROS_PACKAGE_NAME) + "/data/").c_str());
+   strcpy(filename, directory);
+   strcat(filename, "lynxmotionControllerInput.txt"); // Input filename matches the application name
+   if ((fp_in = fopen(filename, "r")) == 0) {
+      printf("Error can't open input lynxmotionControllerInput.txt\n");
+      prompt_and_exit(0);
+   }
+
+
+   /* get the robot configuration data */
+   /* -------------------------------- */
+
+   end_of_file = fscanf(fp_in, "%s", robot_configuration_filename); // read the configuration filename
+   if (end_of_file == EOF) {
+      printf("Fatal error: unable to read the robot configuration filename\n");
+      prompt_and_exit(1);
+   }
+   if (debug) printf("Robot configuration filename %s\n", robot_configuration_filename);
+
+   strcpy(filename, robot_configuration_filename);
+   strcpy(robot_configuration_filename, directory);
+   strcat(robot_configuration_filename, filename);
+
+   readRobotConfigurationData(robot_configuration_filename);
+
+   fclose(fp_in);
+
+
+   /* start the serial writer, then the subscriber */
+   /* -------------------------------------------- */
+
+   startSerialWriter();
+
+   sub        = n.subscribe("/lynxmotion_al5d/joints_positions/command", 10, &jointCommandCallback);
+   status_pub = n.advertise<std_msgs::UInt64MultiArray>("/lynxmotion_al5d/controller/status", 10);
+
+   spinner.start();
+
+   if (debug) printf("lynxmotionController: driving %s at %d baud\n", robotConfigurationData.com, robotConfigurationData.baud);
+
+   while (ros::ok()) {
+      publishControllerStatus(status_pub);
+      rate.sleep();
+   }
+
+   spinner.stop();
+   stopSerialWriter();
+
+   return 0;
+}
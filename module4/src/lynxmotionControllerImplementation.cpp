@@ -0,0 +1,195 @@
+/*******************************************************************************************************************
+ *   Controller node for a LynxMotion AL5D robot arm
+ *   -----------------------------------------------
+ *
+ *   Implementation file
+ *
+ *   The ROS callback thread copies each joint command into a lock-free ring buffer and returns immediately.
+ *   A dedicated serial writer thread drains the ring, keeps only the newest command, converts it to servo setpoints,
+ *   and writes it to the SSC-32.  The writer sleeps on a condition variable while the ring is empty, and waits for
+ *   the serial port to send the previous command before it drains the ring, so that it always sends the newest one.
+ *
+ *   Audit Trail
+ *   -----------
+ *   17 October 2026: created
+ *
+ *   17 October 2026: the writer blocks on writer_wakeup instead of polling the ring every millisecond;
+ *                    the gripper is commanded at twice the joint speed, as in grasp()
+ *
+ *   17 October 2026: a full ring discards the oldest command, not the newest; the writer no longer blocks in 
+ *                    flushSerialPort() while commands arrive: it waits for serialPortReady() in short slices
+ *
+ *
+ *******************************************************************************************************************/
+
+#include <module4/lynxmotionController.h>
+
+extern robotConfigurationDataType robotConfigurationData;
+
+static CommandRing<JointCommand, COMMAND_RING_SIZE> command_ring;
+static ControllerStatistics statistics;
+static std::atomic<bool> writer_running(false);
+static std::thread writer_thread;
+
+/* the writer sleeps on writer_wakeup while the ring is empty                                                 */
+/* the mutex is only held to test and wait, never while writing to the port, so the callback can't be held up */
+/* by the serial line; taking it before notifying ensures a wakeup is not lost between the test and the wait   */
+
+static std::mutex              writer_mutex;
+static std::condition_variable writer_wakeup;
+
+
+static void wakeWriter() {
+
+   { std::lock_guard<std::mutex> lock(writer_mutex); }
+   writer_wakeup.notify_one();
+}
+
+
+/*=======================================================*/
+/* Producer: ROS callback thread                         */
+/*=======================================================*/
+
+void jointCommandCallback(const std_msgs::Float64MultiArray::ConstPtr& msg) {
+
+   JointCommand command;
+
+   if (msg->data.size() < 6) {
+      ROS_WARN("lynxmotionController: ignoring command with %d values; expected 6", (int) msg->data.size());
+      return;
+   }
+
+   for (int i=0; i<6; i++) {
+      command.joint_value[i] = msg->data[i];
+   }
+
+   statistics.received++;
+
+   if (!command_ring.pushOverwrite(command)) {
+      statistics.dropped_full++;   // the writer has fallen COMMAND_RING_SIZE messages behind: the oldest was discarded
+   }
+
+   wakeWriter();
+}
+
+
+/*=======================================================*/
+/* Consumer: serial writer thread                        */
+/*=======================================================*/
+
+static void serialWriter() {
+
+   JointCommand command;
+   JointCommand newest;
+   int n;
+
+   while (writer_running.load()) {
+
+      /* sleep until there is a command or the writer is stopped */
+
+      {
+         std::unique_lock<std::mutex> lock(writer_mutex);
+         writer_wakeup.wait(lock, [] { return command_ring.depth() > 0 || !writer_running.load(); });
+      }
+
+      /* wait until the port has sent the previous command, in short slices so that newer commands replace */
+      /* the ones that arrive meanwhile and stopSerialWriter() is not held up                              */
+
+      while (writer_running.load() && !serialPortReady(WRITER_POLL_TIME)) {
+      }
+
+      /* drain the ring: only the newest setpoint is worth sending */
+
+      n = 0;
+      while (command_ring.pop(command)) {
+         newest = command;
+         n++;
+      }
+
+      if (n == 0) continue;
+
+      statistics.dropped_stale += n - 1;
+
+      if (sendJointCommand(newest)) {
+         statistics.sent++;
+      }
+   }
+
+   flushSerialPort(SERIAL_FLUSH_TIMEOUT);
+}
+
+
+/* convert the joint angles and gripper distance to servo setpoints and write them to the SSC-32:      */
+/* the five joints at the configured speed and the gripper at twice that speed, as grasp() commands it */
+
+bool sendJointCommand(JointCommand &command) {
+
+   bool debug = false;
+   int positions[6];
+
+   if (!computeServoPositions(command.joint_value, positions)) {
+      printf("sendJointCommand() error: not a valid pose for this robot\n");
+      return false;
+   }
+
+   /* gripper: a distance of d mm is given by home[5] + (30-d) * degree[5]; see grasp() */
+
+   positions[5] = robotConfigurationData.home[5] + (int) (float (30 - command.joint_value[5] * 1000) * robotConfigurationData.degree[5]);
+
+   if (debug) printf("sendJointCommand(): servo positions %d %d %d %d %d %d\n", positions[0], positions[1], positions[2], positions[3], positions[4], positions[5]);
+
+   executeCommand(robotConfigurationData.channel, positions, robotConfigurationData.speed, 5);
+   executeCommand(robotConfigurationData.channel[5], positions[5], robotConfigurationData.speed * 2);
+
+   return true;
+}
+
+
+void startSerialWriter() {
+
+   statistics.received      = 0;
+   statistics.sent          = 0;
+   statistics.dropped_stale = 0;
+   statistics.dropped_full  = 0;
+
+   if (!openSerialPort(robotConfigurationData.com, robotConfigurationData.baud)) {
+      display_error_and_exit("lynxmotionController: can't open the serial port ... quitting\n");
+   }
+
+   writer_running = true;
+   writer_thread  = std::thread(serialWriter);
+}
+
+
+void stopSerialWriter() {
+
+   writer_running = false;
+   wakeWriter();
+   if (writer_thread.joinable()) writer_thread.join();
+}
+
+
+/* publish queue depth, received, sent, dropped (stale), dropped (ring full) */
+
+void publishControllerStatus(ros::Publisher &pub) {
+
+   static std_msgs::UInt64MultiArray msg;
+
+   if (msg.layout.dim.empty()) {
+      msg.layout.dim.push_back(std_msgs::MultiArrayDimension());
+      msg.layout.dim[0].size   = 5;
+      msg.layout.dim[0].stride = 1;
+      msg.layout.dim[0].label  = "depth received sent dropped_stale dropped_full";
+      msg.data.resize(5);
+   }
+
+   msg.data[0] = command_ring.depth();
+   msg.data[1] = statistics.received.load();
+   msg.data[2] = statistics.sent.load();
+   msg.data[3] = statistics.dropped_stale.load();
+   msg.data[4] = statistics.dropped_full.load();
+
+   pub.publish(msg);
+}
+
+
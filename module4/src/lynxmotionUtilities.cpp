@@ -30,6 +30,67 @@
  *                     Created this lynxmotionUtilities.cpp file; previously these utilities were embedded in the 
  *                     implementation file
  *
+ *   17 October 2026:  Moved wait(), prompt_and_exit(), prompt_and_continue(), display_error_and_exit(),
+ *                     print_message_to_file(), and fail() here from the implementation files of the applications,
+ *                     so that every node that links al5d_core uses the same definitions
+ *
+ *   17 October 2026:  startRobotConnection() passes commandConnected() to advertise() as a ros::SubscriberStatusCallback;
+ *                     the bare function pointer was converted to the latch flag, so the callback was never registered
+ *
+ *   17 October 2026:  setJointAngles() and grasp() share one connection to the simulator, made by startRobotConnection(),
+ *                     and wait for a subscriber with a connect callback instead of spinning on getNumSubscribers()
+ *
+ *   17 October 2026:  setJointAngles() returns 1 after publishing a command to the simulator; it fell off the end of the function
+ *
+ *   17 October 2026:  setJointAngles() and grasp() publish a shared, preallocated command message with a fixed layout
+ *                     instead of rebuilding it and appending a new layout dimension on every call
+ *
+ *   17 October 2026:  jointStates() ignores a joint state message with fewer than six positions instead of reading past its end
+ *
+ *   17 October 2026:  estimateMotionEnd() updates, and waitUntilReached() reads, the estimated end of the motion 
+ *                     under joint_state_mutex
+ *
+ *   17 October 2026:  Added waitUntilReached() to block until the joint states published by the simulator reach the
+ *                     last command, or until the estimated end of the servo motion when there are no joint states;
+ *                     jointStates() is now serviced by a background spinner thread
+ *
+ *   17 October 2026:  The reachability map stores cells dilated by REACHABILITY_MARGIN samples: pose_reachable() rejects a
+ *                     pose in one lookup if its cell is clear, and frame_reachable() confirms a pose the map accepts 
+ *                     with the inverse kinematics
+ *
+ *   17 October 2026:  pose_reachable() accepts a pose if any sample at the corners of its map cell is reachable, rather than
+ *                     rounding to the nearest sample, and frame_reachable() checks a pose that the map rejects with the
+ *                     inverse kinematics, so the map no longer rejects reachable poses
+ *
+ *   17 October 2026:  Added the reachability map: a bit-packed voxel map of reachable wrist poses built by the
+ *                     reachabilityMap application and memory-mapped at runtime
+ *
+ *   17 October 2026:  computeJointAnglesBatch() uses atan2Batch() and acosBatch(), inline rational approximations, in place
+ *                     of the library atan2() and acos(), and its arrays are declared __restrict__, so that its loop is vectorised
+ *
+ *   17 October 2026:  Added computeJointAnglesBatch(), a branch-free structure-of-arrays inverse kinematic solution
+ *                     for evaluating many candidate poses at once
+ *
+ *   17 October 2026:  Frame::operator* is defined inline in lynxmotionUtilities.h so that it is inlined at each call without
+ *                     link-time optimisation
+ *
+ *   17 October 2026:  move() takes its Frame by const reference rather than copying a 32-byte aligned argument
+ *
+ *   17 October 2026:  Rewrote the Frame class as a rigid transformation (3x3 rotation and translation) with a 
+ *                     non-mutating operator*, constexpr trans(), and AVX2 multiplication kernels
+ *
+ *   17 October 2026:  moveTrajectory() streams setpoints interpolated between the waypoints at TRAJECTORY_RATE instead of
+ *                     releasing one waypoint per segment, so that the arm follows a continuous path
+ *
+ *   17 October 2026:  Added moveTrajectory() to compute the inverse kinematics for a whole path before moving
+ *                     and to send each waypoint as a timed SSC-32 group move
+ *
+ *   17 October 2026:  Added serialPortReady(), a non-blocking flushSerialPort() for the lynxmotionController writer thread
+ *
+ *   17 October 2026:  Replaced the system("echo ...") call in sendToSerialPort() with a persistent connection to the 
+ *                     SSC-32: the port is opened once, configured with termios, and written with non-blocking writes 
+ *                     through a write queue
+ *
  *
  *******************************************************************************************************************/
 
@@ -58,6 +119,26 @@ struct robotConfigurationDataType robotConfigurationData;
 ***********************************************************************************************************************/
 float joint_state_[6]; // Array to store the joint states
 
+/* joint state updates from the spinner thread, used by waitUntilReached() */
+
+static std::mutex                            joint_state_mutex;       // protects joint_state_[], joint_state_count, joint_state_time, and motion_end_estimate
+static std::condition_variable               joint_state_changed;     // signalled by jointStates()
+static unsigned long                         joint_state_count = 0;   // number of joint state messages received
+static std::chrono::steady_clock::time_point joint_state_time;        // time of the last joint state message
+static std::chrono::steady_clock::time_point motion_end_estimate;     // estimated end of the last servo command
+
+
+/* the connection shared by setJointAngles() and grasp(), see startRobotConnection() */
+
+static ros::NodeHandle                      *command_node    = NULL;
+static ros::AsyncSpinner                    *command_spinner = NULL;
+static ros::Publisher                        command_publisher;
+static ros::Subscriber                       joint_state_subscriber;
+static std::mutex                            connection_mutex;
+static std::condition_variable               connection_changed;      // signalled when a subscriber connects to the command topic
+
+static void estimateMotionEnd(int *channel, int *pos, int number_of_servos, int speed, int time_ms);
+
 Vector::Vector(double x, double y, double z, double w) { 
    coefficient[0] = x; 
    coefficient[1] = y;
@@ -72,7 +153,7 @@ void Vector::setValues(double x, double y, double z, double w) {
    coefficient[3] = w;
 }
 
-void Vector::getValues(double &x, double &y, double &z, double &w) { 
+void Vector::getValues(double &x, double &y, double &z, double &w) const { 
    x = coefficient[0]; 
    y = coefficient[1];
    z = coefficient[2];
@@ -88,14 +169,14 @@ void Vector::printVector()const {
    printf("\n\n");
 }
  
-Vector operator+(Vector &a, Vector &b) { 
+Vector operator+(Vector const& a, Vector const& b) { 
    return Vector(a.coefficient[0] / a.coefficient[3] + b.coefficient[0] / b.coefficient[3], 
                  a.coefficient[1] / a.coefficient[3] + b.coefficient[1] / b.coefficient[3], 
                  a.coefficient[2] / a.coefficient[3] + b.coefficient[2] / b.coefficient[3],
                  1); //friend access
 }
 
-double dotProduct(Vector &a, Vector &b) {
+double dotProduct(Vector const& a, Vector const& b) {
 
    double result;
 
@@ -106,127 +187,33 @@ double dotProduct(Vector &a, Vector &b) {
     return result;
 }
 
-Frame::Frame() { 
-   int i, j;
-   
-   for (i=0; i<4; i++) {
-      for (j=0; j<4; j++) {
-         if (i==j)
-            coefficient[i][j] = 1; 
-         else
-            coefficient[i][j] = 0; 
-      }
-   }
-}
-
 void Frame::printFrame()const {
    int i, j;
    
    printf("\n");
-   for (i=0; i<4; i++) {
+   for (i=0; i<3; i++) {
       for (j=0; j<4; j++) {
          printf("%4.1f ",coefficient[i][j]);
       }
       printf("\n");
    }
+   printf("%4.1f %4.1f %4.1f %4.1f \n", 0.0, 0.0, 0.0, 1.0); // bottom row of the homogeneous transformation
    printf("\n");
 }
- 
-Frame &Frame::operator*(Frame const& h) { 
-
-   Frame result;
-   double temp;
-   int i, j, k;
-   bool debug = false;
-
-   if (debug) {
-      printf("Operator *\n");
-      this->printFrame();
-      h.printFrame();
-   }
-
-   for (i=0; i<4; i++) {
-      for (j=0; j<4; j++) {
-         temp = 0;
-         for (k=0; k<4; k++) { 
-            temp = temp + (this->coefficient[i][k]) * (h.coefficient[k][j]);
-         } 
-         result.coefficient[i][j] = temp; 
-      }
-   } 
-
-   for (i=0; i<4; i++) {
-      for (j=0; j<4; j++) {
-         this->coefficient[i][j] = result.coefficient[i][j]; 
-      }
-   } 
-
-   if (debug) this->printFrame();
-
-   return *this;
-}
-
-Frame &Frame::operator=(Frame const& h) { 
-   int i, j;
-   bool debug = false;
-
-   if (debug) {
-      printf("Operator =\n");
-      h.printFrame();
-   }
-
-   for (i=0; i<4; i++) {
-      for (j=0; j<4; j++) {
-         this->coefficient[i][j] = h.coefficient[i][j];
-      }
-   }
-
-  if (debug) this->printFrame();
-
-   return *this;
-}
-
-/* translation by vector (x, y, z) */
-
-Frame trans(float x, float y, float z) {
-      
-   Frame result;
-
-   int i, j;
-   bool debug = false;
-
-   if (debug) {
-      printf("trans %f %f %f\n",x, y, z);
-   }
 
-   for (i=0; i<4; i++) {
-      for (j=0; j<4; j++) {
-         result.coefficient[i][j] = 0;
-      }
-   }
 
-   result.coefficient[0][0] = 1;
-   result.coefficient[1][1] = 1;
-   result.coefficient[2][2] = 1;
-   result.coefficient[3][3] = 1;
+/* product of two rigid transformations: see Frame::operator* in lynxmotionUtilities.h (inline) */
 
-   result.coefficient[0][3] = x;
-   result.coefficient[1][3] = y;
-   result.coefficient[2][3] = z;
 
-  if (debug) result.printFrame();
-
-  return result;
-}
+/* translation by vector (x, y, z): see trans() in lynxmotionUtilities.h (constexpr) */
 
 
 /* rotation about x axis by theta degrees */
 
 Frame rotx(float theta) {
          
-   Frame result;
    double thetaRadians;
-   int i, j;
+   double c, s;
    bool debug = false;
 
    if (debug) {
@@ -236,26 +223,12 @@ Frame rotx(float theta) {
    /* convert theta to radians */
 
    thetaRadians = (3.14159 * theta) / 180.0;
+   c = cos(thetaRadians);
+   s = sin(thetaRadians);
 
-   for (i=0; i<4; i++) {
-      for (j=0; j<4; j++) {
-         result.coefficient[i][j] = 0;
-      }
-   }
-
-   result.coefficient[0][0] = 1;
-   result.coefficient[0][1] = 0;
-   result.coefficient[0][2] = 0;
-
-   result.coefficient[1][0] = 0;
-   result.coefficient[1][1] = cos(thetaRadians);
-   result.coefficient[1][2] = -sin(thetaRadians);;
-
-   result.coefficient[2][0] = 0;
-   result.coefficient[2][1] = sin(thetaRadians);
-   result.coefficient[2][2] = cos(thetaRadians);
-
-   result.coefficient[3][3] = 1;
+   Frame result(1, 0,  0, 0,
+                0, c, -s, 0,
+                0, s,  c, 0);
 
   if (debug) result.printFrame();
 
@@ -267,9 +240,8 @@ Frame rotx(float theta) {
 
 Frame roty(float theta) {
          
-   Frame result;
    double thetaRadians;
-   int i, j;
+   double c, s;
    bool debug = false;
 
    if (debug) {
@@ -279,26 +251,12 @@ Frame roty(float theta) {
    /* convert theta to radians */
 
    thetaRadians = (3.14159 * theta) / 180.0;
+   c = cos(thetaRadians);
+   s = sin(thetaRadians);
 
-   for (i=0; i<4; i++) {
-      for (j=0; j<4; j++) {
-         result.coefficient[i][j] = 0;
-      }
-   }
-
-   result.coefficient[0][0] = cos(thetaRadians);
-   result.coefficient[0][1] = 0;
-   result.coefficient[0][2] = sin(thetaRadians);
-
-   result.coefficient[1][0] = 0;
-   result.coefficient[1][1] = 1;
-   result.coefficient[1][2] = 0;
-
-   result.coefficient[2][0] = -sin(thetaRadians);
-   result.coefficient[2][1] = 0;
-   result.coefficient[2][2] = cos(thetaRadians);
-
-   result.coefficient[3][3] = 1;
+   Frame result( c, 0, s, 0,
+                 0, 1, 0, 0,
+                -s, 0, c, 0);
 
   if (debug) result.printFrame();
 
@@ -306,13 +264,14 @@ Frame roty(float theta) {
 }
 
 
-Frame inv(Frame h) { 
+/* inverse of a rigid transformation: transpose the rotation and rotate the negated translation */
+/*                                                                                              */
+/* [R | p]^-1   [R^T | -R^T p]                                                                  */
 
-   Vector u, v;
-   Frame result;
+Frame inv(Frame const& h) { 
 
+   Frame result;
    int i, j;
-   //double dp;
    bool debug = false;
 
    if (debug) {
@@ -326,24 +285,12 @@ Frame inv(Frame h) {
       }
    }
 
-   for (j=0; j<4; j++) {
-      result.coefficient[3][j] = h.coefficient[3][j];    // copy the scaling part
+   for (i=0; i<3; i++) {
+      result.coefficient[i][3] = -(h.coefficient[0][i] * h.coefficient[0][3] +   // -n.p, -o.p, -a.p
+                                   h.coefficient[1][i] * h.coefficient[1][3] +
+                                   h.coefficient[2][i] * h.coefficient[2][3]);
    }
 
-   
-   v.setValues(h.coefficient[0][3], h.coefficient[1][3], h.coefficient[2][3], h.coefficient[3][3]); // p
-
-   u.setValues(h.coefficient[0][0], h.coefficient[1][0], h.coefficient[2][0], 1); // n
-   result.coefficient[0][3] = -dotProduct(u,v);
- 
-   u.setValues(h.coefficient[0][1], h.coefficient[1][1], h.coefficient[2][1], 1); // o 
-   result.coefficient[1][3] = -dotProduct(u,v);
- 
-   u.setValues(h.coefficient[0][2], h.coefficient[1][2], h.coefficient[2][2], 1); // a
-   result.coefficient[2][3] = -dotProduct(u,v);
- 
-   result.coefficient[3][3] = 1;
-
    if (debug) result.printFrame();
 
    return result;
@@ -354,9 +301,8 @@ Frame inv(Frame h) {
 
 Frame rotz(float theta) {
          
-   Frame result;
    double thetaRadians;
-   int i, j;
+   double c, s;
    bool debug = false;
 
    if (debug) {
@@ -366,26 +312,12 @@ Frame rotz(float theta) {
    /* convert theta to radians */
 
    thetaRadians = (3.14159 * theta) / 180.0;
+   c = cos(thetaRadians);
+   s = sin(thetaRadians);
 
-   for (i=0; i<4; i++) {
-      for (j=0; j<4; j++) {
-         result.coefficient[i][j] = 0;
-      }
-   }
-
-   result.coefficient[0][0] = cos(thetaRadians);
-   result.coefficient[0][1] = -sin(thetaRadians);
-   result.coefficient[0][2] = 0;
-
-   result.coefficient[1][0] = sin(thetaRadians);
-   result.coefficient[1][1] = cos(thetaRadians);
-   result.coefficient[1][2] = 0;
-
-   result.coefficient[2][0] = 0;
-   result.coefficient[2][1] = 0;
-   result.coefficient[2][2] = 1;
-
-   result.coefficient[3][3] = 1;
+   Frame result(c, -s, 0, 0,
+                s,  c, 0, 0,
+                0,  0, 1, 0);
 
   if (debug) result.printFrame();
 
@@ -405,22 +337,48 @@ Frame rotz(float theta) {
 /*                                                                                                  */
 /* Refactored code to use computeJointAngles() and setJointAngles()                                 */
 /* David Vernon 28/6//2020                                                                          */
+/*                                                                                                  */
+/* Moved the extraction of the pose parameters to computePose() so that it can be shared            */
+/* with moveTrajectory()                                                                            */
+/* 17/10/2026                                                                                       */
+
+
+bool move(Frame const& T5) {
+
+   double px, py, pz; // components of position vector
+   double pitch;
+   double roll;
+
+   double jointAngles[6]; // six angles: five for the pose (joints 1 to 5), all in radians, and one for the gripper in metres 
+
+   if (computePose(T5, px, py, pz, pitch, roll) == false) {
+      return false; // approach vector and arm are not aligned ... pose is not achievable
+   }
+
+   //gotoPose((float) px, (float) py, (float) pz, (float) pitch, (float) roll);
+
+   computeJointAngles(px, py, pz, pitch, roll, jointAngles);
+
+   setJointAngles(jointAngles);
+
+   return true;
+}
+
 
+/* computePose()                                                                                    */
+/*                                                                                                  */
+/* Extract the wrist position and the pitch and roll angles (in degrees) from the T5 frame          */
+/* Return false if the pose is not achievable                                                       */
 
-bool move(Frame T5) {
+bool computePose(Frame const& T5, double &px, double &py, double &pz, double &pitch, double &roll) {
 
    bool debug = false;
 
    double ax, ay, az; // components of approach vector
-   double ox, oy, oz; // components of orientation vector
-   double px, py, pz; // components of position vector
+   double ox, oy;     // components of orientation vector
 
    double tolerance = 0.1; // 0.001 to allow for a non-zero x and y translation in the specification of E. DV 29/10/2021
    double r;
-   double pitch;
-   double roll;
-
-   double jointAngles[6]; // six angles: five for the pose (joints 1 to 5), all in radians, and one for the gripper in metres 
 
    /* check to see if the pose is achievable:                                                                */
    /* the approach vector must be aligned with (i.e. in same plane as) the vector from the base to the wrist */
@@ -430,7 +388,6 @@ bool move(Frame T5) {
 
    ox = T5.coefficient[0][1];
    oy = T5.coefficient[1][1];
-   oz = T5.coefficient[2][1];
 
    ax = T5.coefficient[0][2];
    ay = T5.coefficient[1][2];
@@ -473,12 +430,6 @@ bool move(Frame T5) {
          printf("move(): x, y, z, pitch, roll: %4.1f %4.1f %4.1f %4.1f %4.1f \n", px, py, pz, pitch, roll);
       }
 
-      //gotoPose((float) px, (float) py, (float) pz, (float) pitch, (float) roll);
-
-      computeJointAngles(px, py, pz, pitch, roll, jointAngles);
-
-      setJointAngles(jointAngles);
-
       return true;
    }
    else {
@@ -491,6 +442,113 @@ bool move(Frame T5) {
 }
 
 
+/* moveTrajectory()                                                                                 */
+/*                                                                                                  */
+/* Move the robot through a sequence of T5 frames, one every segment_time milliseconds              */
+/*                                                                                                  */
+/* The inverse kinematics are computed for the whole path before the robot moves so that an        */
+/* unachievable waypoint is detected up front and the robot is never left part-way along the path. */
+/*                                                                                                  */
+/* The robot is sent to the first waypoint and given segment_time milliseconds to reach it.        */
+/* The path is then streamed as a continuous sequence of setpoints, interpolated linearly in joint  */
+/* space between the waypoints, at TRAJECTORY_RATE:                                                 */
+/*   - with the simulator, each setpoint is published as a joint angle command                      */
+/*   - with the physical robot, each setpoint is sent to the SSC-32 as a group-move command with a  */
+/*     move time (T) equal to the streaming period, so that the servos never stop between them.     */
+/*     The period is lengthened if the serial port cannot send a group move in the time, e.g. at   */
+/*     9600 baud                                                                                    */
+/*                                                                                                  */
+/* Returns false, without moving the robot, if any waypoint is not achievable                       */
+
+bool moveTrajectory(std::vector<Frame> &path, int segment_time) {
+
+   bool debug = false;
+
+   double px, py, pz;
+   double pitch;
+   double roll;
+   double setpoint[5];
+   double fraction;
+   int    positions[6];
+   int    n = (int) path.size();
+   int    period;                           // ms between setpoints
+   int    steps;                            // setpoints per segment
+   int    i, j, k;
+
+   std::vector<double> joint_path(5 * n);   // joint angles for each waypoint, in radians
+
+   std::chrono::steady_clock::time_point start_time;
+
+   if (n == 0) return true;
+
+   /* compute the inverse kinematics for the whole path first */
+
+   for (i=0; i<n; i++) {
+
+      if (computePose(path[i], px, py, pz, pitch, roll) == false) {
+         printf("moveTrajectory(): waypoint %d of %d not achievable\n", i+1, n);
+         return false;
+      }
+
+      if (computeJointAngles(px, py, pz, pitch, roll, &joint_path[5*i]) == false) {
+         printf("moveTrajectory(): no inverse kinematic solution for waypoint %d of %d\n", i+1, n);
+         return false;
+      }
+   }
+
+   /* streaming period: TRAJECTORY_RATE, or as fast as the serial port can send a group move (10 bits per character) */
+
+   period = 1000 / TRAJECTORY_RATE;
+
+   if (!robotConfigurationData.simulator && robotConfigurationData.baud > 0) {
+      period = MAX(period, (GROUP_MOVE_LENGTH * 10 * 1000 + robotConfigurationData.baud - 1) / robotConfigurationData.baud);
+   }
+
+   steps = MAX(1, (segment_time + period / 2) / period);
+
+   if (debug) printf("moveTrajectory(): %d waypoints, %d ms per segment, %d setpoints per segment\n", n, segment_time, steps);
+
+   /* move to the first waypoint */
+
+   start_time = std::chrono::steady_clock::now();
+
+   if (robotConfigurationData.simulator) {
+      setJointAngles(&joint_path[0]);
+   }
+   else {
+      computeServoPositions(&joint_path[0], positions);
+      executeGroupMove(robotConfigurationData.channel, positions, 5, segment_time);
+   }
+
+   std::this_thread::sleep_until(start_time + std::chrono::milliseconds(segment_time));
+
+   /* stream the interpolated setpoints; the schedule is kept in microseconds so that rounding does not accumulate */
+
+   for (k=1; k <= (n-1) * steps; k++) {
+
+      i        = (k - 1) / steps;                          // the setpoint lies between waypoints i and i+1
+      fraction = (double) (k - i * steps) / steps;
+
+      for (j=0; j<5; j++) {
+         setpoint[j] = joint_path[5*i + j] + fraction * (joint_path[5*(i+1) + j] - joint_path[5*i + j]);
+      }
+
+      if (robotConfigurationData.simulator) {
+         setJointAngles(setpoint);
+      }
+      else {
+         computeServoPositions(setpoint, positions);
+         executeGroupMove(robotConfigurationData.channel, positions, 5, segment_time / steps);
+      }
+
+      std::this_thread::sleep_until(start_time + std::chrono::milliseconds(segment_time) 
+                                               + std::chrono::microseconds((1000L * segment_time * k) / steps));
+   }
+
+   return true;
+}
+
+
 /*********************************************************************/
 /*                                                                   */
 /* Inverse kinematics for LynxMotion AL5D robot manipulator          */
@@ -685,280 +743,958 @@ bool computeJointAngles(double x, double y, double z, double pitch_angle_d, doub
 }
 
 
-/* setJointAngles()
+/* computeJointAnglesBatch()
+
+   Batched version of computeJointAngles() for evaluating many candidate wrist poses, e.g. all the candidate grasps of an object
+
+   Inputs and outputs are structure-of-arrays: element i of x[], y[], z[], pitch[], and roll[] (mm and degrees) is one pose,
+   and element i of joint_angles[0][] ... joint_angles[4][] are the corresponding five joint angles in radians.
+   valid[i] is set to 1 if the pose is reachable and 0 otherwise; the joint angles of an unreachable pose are not meaningful.
+   Returns the number of reachable poses.
+
+   The solution is the same as computeJointAngles() but the loop body is branch-free and makes no library calls, 
+   so that the compiler can vectorise it:
+
+   - the reachability test is a mask computed from the arguments of the two acos() calls instead of a test for NaN 
+     after the event, and the arguments are clamped so that every lane computes a finite value
+   - the roll special cases are selected arithmetically
+   - atan2() and acos() are replaced by atan2Batch() and acosBatch(), inline rational approximations with selects
+     in place of branches; they agree with the library functions to within a few units in the last place
+
+   The joint angles agree with computeJointAngles() to within 1e-13 radians; see src/inverseKinematicsBenchmark.cpp.
+*/
+
+static const double HUM_SQ        = A3 * A3;
+static const double ULN_SQ        = A4 * A4;
+static const double DEG_PER_RAD   = 180.0 / M_PI;
+static const double RAD_PER_DEG   = M_PI / 180.0;
+
+
+/* atan2Batch()
+
+   atan2(y, x) without branches or library calls
    
-   Servo the robot by setting the joint angles.
+   The ratio of the smaller to the larger of |x| and |y| is reduced to [-0.34, 0.66] and the arctangent is evaluated with
+   the rational approximation of the Cephes library (S. L. Moshier, atan.c); the quadrant is then restored with selects.
+   atan2Batch(0, 0) is 0, as is atan2(0, 0).
+*/
 
-   If using ROS, this is effected by publishing the joint angles on the /lynxmotion_al5d/joints_positions/command topic 
+static inline double atan2Batch(double y, double x) {
+
+   const double P0 = -8.750608600031904122785E-1;
+   const double P1 = -1.615753718733365076637E1;
+   const double P2 = -7.500855792314704667340E1;
+   const double P3 = -1.228866684490136173410E2;
+   const double P4 = -6.485021904942025371773E1;
+   const double Q0 =  2.485846490142306297962E1;
+   const double Q1 =  1.650270098316988542046E2;
+   const double Q2 =  4.328810604912902668951E2;
+   const double Q3 =  4.853903996359136964868E2;
+   const double Q4 =  1.945506571482613964425E2;
+   const double MOREBITS = 6.123233995736765886130E-17;   // pi/4 - (double) (pi/4)
+
+   double ax  = fabs(x);
+   double ay  = fabs(y);
+   double num = ay < ax ? ay : ax;
+   double den = ay < ax ? ax : ay;
+   double t   = num / (den > 0 ? den : 1.0);               // in [0, 1]
+
+   bool   big = t > 0.66;
+   double v   = (t - 1) / (t + 1);                        // arctan(t) = pi/4 + arctan((t - 1) / (t + 1))
+   double u   = big ? v : t;
+   double z   = u * u;
+   double p   = (((P0 * z + P1) * z + P2) * z + P3) * z + P4;
+   double q   = ((((z + Q0) * z + Q1) * z + Q2) * z + Q3) * z + Q4;
+   double r   = u + u * z * p / q;
+
+   r = big     ? (M_PI_4 + 0.5 * MOREBITS) + r : r;
+   r = ay > ax ? (M_PI_2 + MOREBITS) - r       : r;       // |y| > |x|: arctan(|y|/|x|) = pi/2 - arctan(|x|/|y|)
+   r = x < 0   ? (M_PI + 2 * MOREBITS) - r     : r;       // second and third quadrants
+
+   return copysign(r, y);
+}
 
-   If not using ROS but controlling the robot directly from either Ubuntu or  Windows, this is effected by 
-   transforming from joint angles to servo position values and writing the servo position values to the COM port
- 
-   David Vernon
-   28 June 2020
 
+/* acosBatch()
+
+   acos(c) = 2 atan2(sqrt(1 - c), sqrt(1 + c)) for c in [-1, 1], without branches or library calls
 */
 
-bool setJointAngles(double joint_angles[]) {
+static inline double acosBatch(double c) {
 
-   static bool first_call = true;
+   return 2 * atan2Batch(sqrt(1 - c), sqrt(1 + c));
+}
 
-   bool debug = false; 
-   int positions[6];       
-   bool valid_pose;
 
-   static ros::NodeHandle n;                        // ROS node
-   static ros::Publisher  pub_;                     // publisher
-   static ros::Subscriber sub;                      // subscriber
-   static ros::Rate rate(2);                        // Loop at 2Hz until the node is shut down
-   static std_msgs::Float64MultiArray msg;
-   static std::vector<float> joints_values;
+int computeJointAnglesBatch(int n, const double * __restrict__ x, const double * __restrict__ y, const double * __restrict__ z,
+                            const double * __restrict__ pitch, const double * __restrict__ roll,
+                            double *joint_angles[5], unsigned char * __restrict__ valid) {
 
-   if (debug) printf("setJointAngles(): angles %4.2f %4.2f %4.2f %4.2f %4.2f\n", joint_angles[0], joint_angles[1],joint_angles[2],joint_angles[3],joint_angles[4]);
+   int number_valid = 0;
 
- 
-   if (robotConfigurationData.simulator) {
-      
-      if (first_call) {
-         pub_ = n.advertise<std_msgs::Float64MultiArray>("/lynxmotion_al5d/joints_positions/command", 1000);
-         sub = n.subscribe("/lynxmotion_al5d/joint_states", 1000, &jointStates);
-	
-         /* Waiting for the publisher to be ready to publish the message */
-	   
-         while (pub_.getNumSubscribers()<1) {
-	     
-            // waiting for a connection to publisher
+   double * __restrict__ bas_angle       = joint_angles[0];
+   double * __restrict__ shl_angle       = joint_angles[1];
+   double * __restrict__ elb_angle       = joint_angles[2];
+   double * __restrict__ wri_pitch_angle = joint_angles[3];
+   double * __restrict__ wri_roll_angle  = joint_angles[4];
 
-            if (debug) printf("Waiting for connection to publisher \n");	     
-         }
-         first_call = false; // only need to do this the first time
-      }
+   for (int i=0; i<n; i++) {
 
-      /* copy joint angles to the globally-accessible structure so that they can be used when constucting the topic message in the grasp() function */
+      double bas_angle_r = atan2Batch(x[i], y[i]);
+      double rdist       = (float) sqrt(x[i] * x[i] + y[i] * y[i]);
+
+      double wrist_z     = z[i] - D1;
+      double wrist_y     = rdist;
+      double s_w         = wrist_z * wrist_z + wrist_y * wrist_y;
+      double s_w_sqrt    = sqrt(s_w);
+
+      /* the arguments of acos() are computed exactly as in computeJointAngles() so that the reachability tests agree */
+
+      double a1          = atan2Batch(wrist_z, wrist_y);
+      double cos_a2      = ((HUM_SQ - ULN_SQ) + s_w) / (2 * A3 * s_w_sqrt);
+      double cos_elb     = (s_w - HUM_SQ - ULN_SQ) / (2 * A3 * A4);
+
+      bool   reachable   = (s_w_sqrt > 0) & (cos_a2 >= -1) & (cos_a2 <= 1) & (cos_elb >= -1) & (cos_elb <= 1);
+
+      cos_a2  = MIN(MAX(cos_a2,  -1.0), 1.0);
+      cos_elb = MIN(MAX(cos_elb, -1.0), 1.0);
+
+      double shl_angle_r = a1 + (float) acosBatch(cos_a2);
+      double elb_angle_r = -acosBatch(cos_elb);
+
+      /* wrist pitch and roll: see computeJointAngles() for the reasons for the 90 degree offsets */
+
+      int    pitch_d     = (int) pitch[i];
+      double up          = (pitch_d == 0);                         // directed vertically up
+      double down        = (pitch_d == -180) | (pitch_d == 180);   // directed vertically down
+      double bas_angle_d = bas_angle_r * DEG_PER_RAD;
+
+      double wri_pitch_angle_d = (pitch[i] - elb_angle_r * DEG_PER_RAD) - shl_angle_r * DEG_PER_RAD + 90;
+      double wri_roll_angle_d  = roll[i] + 90 + (up - down) * bas_angle_d;
+
+      bas_angle[i]       = bas_angle_r;
+      shl_angle[i]       = shl_angle_r;
+      elb_angle[i]       = elb_angle_r;
+      wri_pitch_angle[i] = wri_pitch_angle_d * RAD_PER_DEG;
+      wri_roll_angle[i]  = wri_roll_angle_d  * RAD_PER_DEG;
+
+      valid[i]      = reachable;
+      number_valid += reachable;
+   }
+
+   return number_valid;
+}
+
+
+/* publishJointCommand()
+
+   Publish the six values in robotConfigurationData.current_joint_value[] on the /lynxmotion_al5d/joints_positions/command topic:
+   five joint angles in radians and the gripper distance in metres.
+
+   The message is shared by setJointAngles() and grasp().  Its layout and data array are set up on the first call
+   and the values are then written in place, so publishing a command does not allocate memory or grow the layout.
+   The message is published on the shared publisher of the robot connection, once a subscriber has connected.
+*/
+
+static std_msgs::Float64MultiArray joint_command;
+
+static void publishJointCommand() {
+
+   startRobotConnection();
+   waitForRobotConnection();
+
+   if (joint_command.data.size() != 6) {
+      joint_command.layout.dim.resize(1);
+      joint_command.layout.dim[0].size   = 6;
+      joint_command.layout.dim[0].stride = 1;
+      joint_command.layout.dim[0].label  = "joints";
+      joint_command.data.resize(6);
+   }
+
+   for (int i=0; i<6; i++) {
+      joint_command.data[i] = robotConfigurationData.current_joint_value[i];
+   }
+
+   command_publisher.publish(joint_command);
+}
+
+
+/* setJointAngles()
+   
+   Servo the robot by setting the joint angles.
+
+   If using ROS, this is effected by publishing the joint angles on the /lynxmotion_al5d/joints_positions/command topic 
+
+   If not using ROS but controlling the robot directly from either Ubuntu or  Windows, this is effected by 
+   transforming from joint angles to servo position values and writing the servo position values to the COM port
+ 
+   David Vernon
+   28 June 2020
+
+*/
+
+bool setJointAngles(double joint_angles[]) {
+
+   bool debug = false; 
+   int positions[6];       
+   bool valid_pose;
+
+   if (debug) printf("setJointAngles(): angles %4.2f %4.2f %4.2f %4.2f %4.2f\n", joint_angles[0], joint_angles[1],joint_angles[2],joint_angles[3],joint_angles[4]);
+
+ 
+   if (robotConfigurationData.simulator) {
+      
+      /* copy joint angles to the globally-accessible structure so that they can be used when constucting the topic message in the grasp() function */
+
+      for (int i=0; i<5; i++) {
+         robotConfigurationData.current_joint_value[i] = joint_angles[i];
+      }
+
+      /* now publish the topic message with all six joint values: five for the joint angles and one for the gripper */
+
+      publishJointCommand();
+
+      if (computeServoPositions(joint_angles, positions)) {
+         estimateMotionEnd(robotConfigurationData.channel, positions, 5, robotConfigurationData.speed, 0);
+      }
+
+      return 1;
+   }
+   else {
+
+      /* Direct control of the physical robot */
+      /* ------------------------------------ */
+
+      /*** the lynxmotionController node subscribes to the /lynxmotion_al5d/joints_positions/command topic and drives the physical robot, so setting SIMULATOR TRUE    ***/
+      /*** and running that node instead of the simulator publishes the joint angles to the real robot; this direct path is kept for use without a ROS master         ***/
+      /*** better still, move the inverse kinematics too and publish a pose (vector & quaternion) instead of the joint angles                                           ***/
+
+      valid_pose = computeServoPositions(joint_angles, positions);
+
+      if (valid_pose) {
+        
+         if (debug) printf("setJointAngles(): servo positions %d %d %d %d %d \n", positions[0], positions[1],  positions[2], positions[3], positions[4]);
+
+         executeCommand(robotConfigurationData.channel, positions, robotConfigurationData.speed, 5);
+
+         return 1;
+      }
+      else {
+         printf("setJointAngles() error: not a valid pose for this robot\n");
+         return 0;
+      }
+   }
+}
+
+/* computeServoPositions()
+   
+   Transform from joint angles to servo position values
+ 
+   David Vernon
+   28 June 2020
+
+*/
+
+bool computeServoPositions(double joint_angles[], int positions[]) {
+
+    int homeOffset[6];  
+
+    bool debug = false; 
+    int i;
+
+    if (debug) 
+	   printf("computeServoPositions(): joint angles %4.2f %4.2f %4.2f %4.2f %4.2f\n", joint_angles[0], joint_angles[1],joint_angles[2],joint_angles[3],joint_angles[4]);
+
+    double bas_pos;
+    double shl_pos;
+    double elb_pos;
+    double wri_pitch_pos;
+    double wri_roll_pos;
+
+    /* Set the servo angles corresponding to joint angles for the home position */
+
+    for (i=0; i<5; i++) {
+       homeOffset[i] = (int) ((float)robotConfigurationData.home[i] / robotConfigurationData.degree[i]);
+    }
+
+
+    // Calculate servo positions
+
+    bas_pos       = degrees(joint_angles[0])                  + homeOffset[0];
+    shl_pos       = (degrees(joint_angles[1]) - (float) 90.0) + homeOffset[1];  // joint angle after compensating for the -90 degrees for the home configuration
+    elb_pos       = (-degrees(joint_angles[2]) - (float) 90.0) + homeOffset[2];  // joint angle after compensating for the -90 degrees for the home configuration
+    wri_pitch_pos = degrees(joint_angles[3])                  + homeOffset[3];
+    if (robotConfigurationData.lightweightWrist == true) {
+       wri_roll_pos  = - degrees(joint_angles[4])             + homeOffset[4];            
+    }
+    else {
+       wri_roll_pos  =   degrees(joint_angles[4])             + homeOffset[4];  // roll servo rotates in reverse with the medium duty wrist attachment
+    }
+
+    //if (wri_roll_pos > 90) wri_roll_pos = wri_roll_pos - 180; // NEW CHECK
+    //if (wri_roll_pos < 90) wri_roll_pos = wri_roll_pos + 180; // NEW CHECK
+	
+    positions[0] = (int)(bas_pos       * robotConfigurationData.degree[0]);
+    positions[1] = (int)(shl_pos       * robotConfigurationData.degree[1]);
+    positions[2] = (int)(elb_pos       * robotConfigurationData.degree[2]);
+    positions[3] = (int)(wri_pitch_pos * robotConfigurationData.degree[3]);
+    positions[4] = (int)(wri_roll_pos  * robotConfigurationData.degree[4]);
+
+    if (debug) {
+	   printf("computeServoPositions(): servo positions ");
+	   for (i=0; i<=4; i++) {   
+		  printf("%4d ",positions[i]);
+	   }
+       printf("\n");
+    }
+
+    return true;  
+}
+
+void grasp(int d) { // d is distance between finger tips:  0 <= d <= 30 mm
+
+  /* The gripper is controlled by servo 6
+   *
+   * The calibration data are stored in element 5 of the home[], degree[], and channel[] arrays
+   * in the global robotConfigurationData structure
+   *
+   * The gripper is approximately 30mm apart (i.e. fully open) when at the servo setpoint given by home[5]
+   *
+   * A (closing) distance of 1 mm is given by the PW defined by degree[5] array
+   * and, a gripper opening distance of d mm is given by home[5] + (30-d) * degree[5]
+   */
+
+   bool debug = false;
+   int pw;
+   
+   if (robotConfigurationData.simulator) {
+
+       /* copy the gripper distance angles to the globally-accessible structure so that it can be used when constucting the topic message in the setJointAngles() function */
+
+       robotConfigurationData.current_joint_value[5] = ((double) d) / 1000;
+   
+       
+       /* now publish the topic message with all six joint values: five for the joint angles and one for the gripper */
+
+       publishJointCommand();
+
+       pw = robotConfigurationData.home[5] + (int) (float (30-d) * robotConfigurationData.degree[5]);
+       estimateMotionEnd(&robotConfigurationData.channel[5], &pw, 1, robotConfigurationData.speed * 2, 0);
+   }
+   else {
+  
+      /* direct control of physical robot */
+
+      /*** the lynxmotionController node subscribes to the /lynxmotion_al5d/joints_positions/command topic and drives the physical robot, so setting SIMULATOR TRUE    ***/
+      /*** and running that node instead of the simulator publishes the joint angles to the real robot; this direct path is kept for use without a ROS master         ***/
+      /*** better still, move the inverse kinematics too and publish a pose (vector & quaternion) instead of the joint angles                                           ***/
+
+      pw = robotConfigurationData.home[5] + (int) (float (30-d) * robotConfigurationData.degree[5]);
+
+      if (debug) {
+         printf("grasp: %d\n",d);
+        // printf("grasp: d %d  PW %d\n", d, pw);
+      }
+   
+      executeCommand(robotConfigurationData.channel[5], pw, robotConfigurationData.speed * 2);
+   }
+}
+
+
+int pose_within_working_env(float x, float y, float z)
+{
+    if((int)x <= MAX_X && (int) x > MIN_X && (int)y <= MAX_Y && (int) y > MIN_Y && (int)z <= MAX_Z && (int) z > MIN_Z ) return 1;
+    else return 0;
+}
+
+
+/*=======================================================*/
+/* Reachability map                                      */ 
+/*=======================================================*/
+
+/* the map that is currently open: mapped read-only so that several processes share the same physical pages */
+
+static void          *reachability_map_base = NULL;
+static size_t         reachability_map_size = 0;
+static const reachabilityMapHeaderType *reachability_map_header = NULL;
+static const unsigned char             *reachability_map_bits   = NULL;
+
+
+/* reachabilityMapFilename()
+ 
+   Derive the map filename from the robot configuration filename: robot_1_config.txt -> robot_1_reachability.map 
+*/
+
+void reachabilityMapFilename(char robot_configuration_filename[], char map_filename[]) {
+
+   char *suffix;
+
+   strcpy(map_filename, robot_configuration_filename);
+
+   if ((suffix = strstr(map_filename, "_config.txt")) != NULL) {
+      *suffix = '\0';
+   }
+   else if ((suffix = strrchr(map_filename, '.')) != NULL) {
+      *suffix = '\0';
+   }
+
+   strcat(map_filename, "_reachability.map");
+}
+
+
+/* buildReachabilityMap()
+ 
+   Sweep the working envelope through the inverse kinematics and the servo calibration of the robot described by 
+   robotConfigurationData, and write the bit-packed map to filename.
+
+   Each row of x samples is solved with one call to computeJointAnglesBatch(); only the poses that have a solution 
+   are then passed to computeServoPositions() to check the servo limits.  The roll angle is not part of the map.
+
+   The map stores cells, not samples: cell (ix, iy, iz, ip) lies between samples ix .. ix+1, iy .. iy+1, etc., and 
+   its bit is set if any sample within REACHABILITY_MARGIN samples of the cell is reachable.  The margin covers 
+   reachable poses in a cell whose own corner samples are all unreachable, e.g. at the edge of the reachable pitch 
+   range, so that a cleared bit means that no pose in the cell is reachable.
+*/
+
+bool buildReachabilityMap(char filename[]) {
+
+   bool debug = false;
+
+   reachabilityMapHeaderType header;
+   FILE *fp_out;
+   int ix, iy, iz, ip;
+   int j;
+   long int index;
+   long int number_of_samples;
+   long int number_reachable = 0;
+   long int number_of_cells  = 0;
+   long int stride;
+   int  n;
+   bool within_limits;
+   int positions[6];
+   double joint_angles[6];
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, REACHABILITY_MAGIC, sizeof(header.magic));
+   header.version    = REACHABILITY_VERSION;
+   header.min_x      = MIN_X;
+   header.min_y      = MIN_Y;
+   header.min_z      = MIN_Z;
+   header.min_pitch  = REACHABILITY_PITCH_MIN;
+   header.voxel_size = REACHABILITY_VOXEL_SIZE;
+   header.pitch_step = REACHABILITY_PITCH_STEP;
+   header.nx         = (MAX_X - MIN_X) / REACHABILITY_VOXEL_SIZE + 1;
+   header.ny         = (MAX_Y - MIN_Y) / REACHABILITY_VOXEL_SIZE + 1;
+   header.nz         = (MAX_Z - MIN_Z) / REACHABILITY_VOXEL_SIZE + 1;
+   header.npitch     = (REACHABILITY_PITCH_MAX - REACHABILITY_PITCH_MIN) / REACHABILITY_PITCH_STEP + 1;
+
+   for (j=0; j<6; j++) {
+      header.home[j]   = robotConfigurationData.home[j];
+      header.degree[j] = robotConfigurationData.degree[j];
+   }
+
+   number_of_samples = (long int) header.nx * header.ny * header.nz * header.npitch;
+
+   std::vector<unsigned char> sample(number_of_samples, 0);   // one byte per sample while the map is built
+   std::vector<unsigned char> dilated(number_of_samples);
+   std::vector<unsigned char> bits((number_of_samples + 7) / 8, 0);
+
+   /* one row of x samples at a time, structure-of-arrays for computeJointAnglesBatch() */
+
+   std::vector<double> x(header.nx), y(header.nx), z(header.nx), pitch(header.nx), roll(header.nx, 0);
+   std::vector<double> angles(5 * header.nx);
+   std::vector<unsigned char> valid(header.nx);
+   double *row_angles[5];
+
+   for (j=0; j<5; j++) {
+      row_angles[j] = &angles[j * header.nx];
+   }
+
+   for (ix=0; ix<header.nx; ix++) {
+      x[ix] = header.min_x + ix * header.voxel_size;
+   }
+
+   index = 0;
+
+   for (ip=0; ip<header.npitch; ip++) {
+      for (iz=0; iz<header.nz; iz++) {
+         for (iy=0; iy<header.ny; iy++) {
+
+            for (ix=0; ix<header.nx; ix++) {
+               y[ix]     = header.min_y     + iy * header.voxel_size;
+               z[ix]     = header.min_z     + iz * header.voxel_size;
+               pitch[ix] = header.min_pitch + ip * header.pitch_step;
+            }
+
+            computeJointAnglesBatch(header.nx, &x[0], &y[0], &z[0], &pitch[0], &roll[0], row_angles, &valid[0]);
+
+            for (ix=0; ix<header.nx; ix++, index++) {
+
+               if (!valid[ix]) continue;
+
+               for (j=0; j<5; j++) {
+                  joint_angles[j] = row_angles[j][ix];
+               }
+               computeServoPositions(joint_angles, positions);
+
+               within_limits = true;
+               for (j=0; j<4; j++) {
+                  if (positions[j] < MIN_PW || positions[j] > MAX_PW) within_limits = false;
+               }
+
+               if (within_limits) {
+                  sample[index] = 1;
+                  number_reachable++;
+               }
+            }
+         }
+      }
+   }
+
+   /* dilate the samples into cells, one axis at a time: along each axis, cell i is set if any sample           */
+   /* i - REACHABILITY_MARGIN .. i + 1 + REACHABILITY_MARGIN is set                                             */
+
+   int size[4] = {header.nx, header.ny, header.nz, header.npitch};
+   int axis;
+   int lo, hi, k;
+
+   stride = 1;
+
+   for (axis=0; axis<4; axis++) {
+
+      n = size[axis];
+
+      for (index=0; index<number_of_samples; index++) {
+
+         j  = (int) ((index / stride) % n);                  // position of this cell along the axis
+         lo = MAX(j - REACHABILITY_MARGIN,     0);
+         hi = MIN(j + 1 + REACHABILITY_MARGIN, n - 1);
+
+         dilated[index] = 0;
+         for (k=lo; k<=hi && !dilated[index]; k++) {
+            dilated[index] = sample[index + (k - j) * stride];
+         }
+      }
+
+      sample.swap(dilated);
+      stride *= n;
+   }
+
+   for (index=0; index<number_of_samples; index++) {
+      if (sample[index]) {
+         bits[index >> 3] |= (unsigned char) (1 << (index & 7));
+         number_of_cells++;
+      }
+   }
+
+   if ((fp_out = fopen(filename, "wb")) == NULL) {
+      printf("buildReachabilityMap(): can't open %s\n", filename);
+      return false;
+   }
+
+   if (fwrite(&header, sizeof(header), 1, fp_out) != 1 || fwrite(&bits[0], 1, bits.size(), fp_out) != bits.size()) {
+      printf("buildReachabilityMap(): error writing %s\n", filename);
+      fclose(fp_out);
+      return false;
+   }
+
+   fclose(fp_out);
+
+   if (debug) printf("buildReachabilityMap(): %ld of %ld samples reachable, %ld cells set\n", number_reachable, number_of_samples, number_of_cells);
+
+   return true;
+}
+
+
+/* openReachabilityMap()
+ 
+   Memory-map the reachability map in filename and make it the map used by pose_reachable()
+   Returns false, leaving no map open, if the file does not exist, is not a valid map, 
+   or was built for a robot with different calibration data
+*/
+
+bool openReachabilityMap(char filename[]) {
+
+   int fd;
+   int j;
+   struct stat file_status;
+   const reachabilityMapHeaderType *header;
+   long int number_of_samples;
+   bool calibrated = true;
+   void *base;
+
+   closeReachabilityMap();
+
+   if ((fd = open(filename, O_RDONLY)) < 0) {
+      return false;
+   }
+
+   if (fstat(fd, &file_status) < 0 || file_status.st_size < (off_t) sizeof(reachabilityMapHeaderType)) {
+      close(fd);
+      printf("openReachabilityMap(): %s is not a reachability map\n", filename);
+      return false;
+   }
+
+   base = mmap(NULL, file_status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd); // the mapping keeps its own reference to the file
+
+   if (base == MAP_FAILED) {
+      printf("openReachabilityMap(): can't map %s: %s\n", filename, strerror(errno));
+      return false;
+   }
+
+   header = (const reachabilityMapHeaderType *) base;
+   number_of_samples = (long int) header->nx * header->ny * header->nz * header->npitch;
+
+   if (memcmp(header->magic, REACHABILITY_MAGIC, sizeof(header->magic)) != 0 || header->version != REACHABILITY_VERSION ||
+       file_status.st_size != (off_t) (sizeof(reachabilityMapHeaderType) + (number_of_samples + 7) / 8)) {
+      printf("openReachabilityMap(): %s is not a reachability map\n", filename);
+      munmap(base, file_status.st_size);
+      return false;
+   }
+
+   for (j=0; j<6; j++) {
+      if (header->home[j] != robotConfigurationData.home[j] || header->degree[j] != robotConfigurationData.degree[j]) calibrated = false;
+   }
+
+   if (!calibrated) {
+      printf("openReachabilityMap(): %s was built for different calibration data; rebuild it with reachabilityMap\n", filename);
+      munmap(base, file_status.st_size);
+      return false;
+   }
+
+   reachability_map_base   = base;
+   reachability_map_size   = file_status.st_size;
+   reachability_map_header = header;
+   reachability_map_bits   = (const unsigned char *) base + sizeof(reachabilityMapHeaderType);
+
+   return true;
+}
+
+
+void closeReachabilityMap() {
+
+   if (reachability_map_base != NULL) {
+      munmap(reachability_map_base, reachability_map_size);
+   }
+
+   reachability_map_base   = NULL;
+   reachability_map_size   = 0;
+   reachability_map_header = NULL;
+   reachability_map_bits   = NULL;
+}
+
+
+/* pose_reachable()
+ 
+   Look up the wrist pose (x, y, z, pitch) in the reachability map
+
+   Returns false if the pose is certainly not reachable, i.e. the bit of the map cell that contains it is clear
+   (see buildReachabilityMap()); this costs one bit lookup.  Returns true if the pose may be reachable: the cell can 
+   also contain unreachable poses, so the caller must confirm the pose with the inverse kinematics, as 
+   frame_reachable() does.
+
+   If no map is open, or the pose lies outside the map, the map has no information and the pose is reported as
+   possibly reachable so that the decision is left to the inverse kinematics
+*/
+
+bool pose_reachable(float x, float y, float z, float pitch) {
+
+   const reachabilityMapHeaderType *h = reachability_map_header;
+   int ix, iy, iz, ip;
+   long int index;
+
+   if (h == NULL) return true;
+
+   ix = (int) floorf((x     - h->min_x)     / h->voxel_size);
+   iy = (int) floorf((y     - h->min_y)     / h->voxel_size);
+   iz = (int) floorf((z     - h->min_z)     / h->voxel_size);
+   ip = (int) floorf((pitch - h->min_pitch) / h->pitch_step);
+
+   if ((unsigned) ix >= (unsigned) h->nx || (unsigned) iy >= (unsigned) h->ny || 
+       (unsigned) iz >= (unsigned) h->nz || (unsigned) ip >= (unsigned) h->npitch) {
+      return true;
+   }
+
+   index = (((long int) ip * h->nz + iz) * h->ny + iy) * h->nx + ix;
+
+   return (reachability_map_bits[index >> 3] >> (index & 7)) & 1;
+}
+
+
+/* frame_reachable()
+ 
+   Extract the wrist pose from a T5 frame and decide whether the robot can reach it
+
+   The reachability map is consulted first and a pose that it rejects is rejected without any inverse kinematics.
+   A pose that the map accepts is then checked exactly, with the same test that was used to build the map: 
+   computeJointAngles() has a solution and computeServoPositions() gives pulse widths between MIN_PW and MAX_PW 
+   for joints 1 to 4.
+*/
+
+bool frame_reachable(Frame const& T5) {
+
+   double px, py, pz; 
+   double pitch;
+   double roll;
+   double joint_angles[6];
+   int    positions[6];
+   int    j;
+
+   if (computePose(T5, px, py, pz, pitch, roll) == false) {
+      return false; 
+   }
+
+   if (pose_reachable((float) px, (float) py, (float) pz, (float) pitch) == false) {
+      return false;
+   }
+
+   if (computeJointAngles(px, py, pz, pitch, roll, joint_angles) == false) {
+      return false;
+   }
+
+   computeServoPositions(joint_angles, positions);
+
+   for (j=0; j<4; j++) {
+      if (positions[j] < MIN_PW || positions[j] > MAX_PW) return false;
+   }
+
+   return true;
+}
+
+
+#ifdef ROS
+void jointStates(const sensor_msgs::JointState::ConstPtr& msg)
+{
+  
+    /* The messages are echoed starting from the gripper then the joints */
+    /* This runs on the spinner thread: waitUntilReached() is woken each time the joint states are updated */
+
+    if (msg->position.size() < 6) {
+       ROS_WARN_THROTTLE(1, "jointStates(): ignoring joint states with %d positions; expected 6", (int) msg->position.size());
+       return;
+    }
+
+    std::lock_guard<std::mutex> lock(joint_state_mutex);
+
+    joint_state_[5] = msg->position[0];
+    joint_state_[0] = msg->position[1];
+    joint_state_[1] = msg->position[2];
+    joint_state_[2] = msg->position[3];
+    joint_state_[3] = msg->position[4];
+    joint_state_[4] = msg->position[5];
+
+    joint_state_count++;
+    joint_state_time = std::chrono::steady_clock::now();
+
+    joint_state_changed.notify_all();
+}
+#endif
+
+
+/*=======================================================*/
+/* Motion completion                                     */ 
+/*=======================================================*/
+
+/* startRobotConnection()
+
+   Set up the single connection to the simulator, or to the lynxmotionController node, that is shared by 
+   setJointAngles() and grasp(): one node handle, one publisher on the /lynxmotion_al5d/joints_positions/command topic,
+   and one subscriber to the /lynxmotion_al5d/joint_states topic, all serviced by a background spinner thread.
+
+   The function returns immediately; a subscriber connecting to the command topic is signalled by commandConnected(). 
+   The callback is wrapped in a ros::SubscriberStatusCallback: a bare function pointer converts to bool and would 
+   select the advertise() overload that takes the latch flag instead.
+   Call it at startup so that the connection is made while the application is reading its input; 
+   it is also called by the first command if it has not been called already.
+*/
+
+static void commandConnected(const ros::SingleSubscriberPublisher &subscriber) {
+
+   std::lock_guard<std::mutex> lock(connection_mutex);
+   connection_changed.notify_all();
+}
+
+
+void startRobotConnection() {
+
+   if (command_node != NULL) return;
+
+   command_node           = new ros::NodeHandle;
+   command_publisher      = command_node->advertise<std_msgs::Float64MultiArray>("/lynxmotion_al5d/joints_positions/command", 1000,
+                                                                                    ros::SubscriberStatusCallback(&commandConnected));
+   joint_state_subscriber = command_node->subscribe("/lynxmotion_al5d/joint_states", 1000, &jointStates);
+
+   command_spinner = new ros::AsyncSpinner(1);
+   command_spinner->start();
+}
 
-      for (int i=0; i<5; i++) {
-         robotConfigurationData.current_joint_value[i] = joint_angles[i];
-      }
 
-      /* now construct the topic message with all six joint values: five for the joint angles and one for the gripper */
-      /* use the values in robotConfigurationData.current_joint_value[]                                               */
-	
-      joints_values = {robotConfigurationData.current_joint_value[0],
-                       robotConfigurationData.current_joint_value[1],
-   		       robotConfigurationData.current_joint_value[2],
-		       robotConfigurationData.current_joint_value[3],
-		       robotConfigurationData.current_joint_value[4],
-		       robotConfigurationData.current_joint_value[5]};
-	   
-      msg.layout.dim.push_back(std_msgs::MultiArrayDimension());
-      msg.layout.dim[0].size = joints_values.size();
-      msg.layout.dim[0].stride = 1;
-      msg.layout.dim[0].label = "joints";
-
-      msg.data.clear();
-      msg.data.insert(msg.data.end(), joints_values.begin(), joints_values.end());
-
-      pub_.publish(msg); // publishing the message
-   }
-   else {
+/* waitForRobotConnection()
 
-      /* Direct control of the physical robot */
-      /* ------------------------------------ */
+   Block, without polling, until a subscriber is connected to the command topic.
+   Returns false if ROS is shut down first.
+*/
 
-      /*** this code needs to be moved to a dedicated lynxmotionController node which will subscribe to the /lynxmotion_al5d/joints_positions/command topic (see above) ***/
-      /*** we can then run either the lynxmotion simulator or the lynxmotionController depending on whether we are using the simulator or the real robot                ***/
-      /*** better still, move the inverse kinematics too and publish a pose (vector & quaternion) instead of the joint angles                                           ***/
+bool waitForRobotConnection() {
 
-      valid_pose = computeServoPositions(joint_angles, positions);
+   bool debug = false;
 
-      if (valid_pose) {
-        
-         if (debug) printf("setJointAngles(): servo positions %d %d %d %d %d \n", positions[0], positions[1],  positions[2], positions[3], positions[4]);
+   std::unique_lock<std::mutex> lock(connection_mutex);
 
-         executeCommand(robotConfigurationData.channel, positions, robotConfigurationData.speed, 5);
+   while (command_publisher.getNumSubscribers() < 1) {
 
-         return 1;
-      }
-      else {
-         printf("setJointAngles() error: not a valid pose for this robot\n");
-         return 0;
-      }
+      if (!ros::ok()) return false;
+
+      if (debug) printf("Waiting for connection to publisher \n");
+
+      connection_changed.wait_for(lock, std::chrono::milliseconds(ROBOT_CONNECTION_CHECK)); // recheck ros::ok() periodically
    }
+
+   return true;
 }
 
-/* computeServoPositions()
-   
-   Transform from joint angles to servo position values
- 
-   David Vernon
-   28 June 2020
 
+/* estimateMotionEnd()
+
+   Estimate when the servos will reach the setpoints of a command that has just been issued.
+   This is used by waitUntilReached() when no joint states are being published, e.g. when controlling the physical robot.
+   The SSC-32 moves each servo at speed microseconds of pulse width per second (see pickAndPlaceApplication.cpp), 
+   or, for a timed group move, brings all the servos to their setpoints after time_ms milliseconds. 
+   The previous setpoint of each channel is remembered; if it is not known, a full MIN_PW to MAX_PW traverse is assumed.
 */
 
-bool computeServoPositions(double joint_angles[], int positions[]) {
+static void estimateMotionEnd(int *channel, int *pos, int number_of_servos, int speed, int time_ms) {
 
-    int homeOffset[6];  
+   static int  last_position[MAX_SERVOS];
+   static bool last_position_known[MAX_SERVOS] = {false};
 
-    bool debug = false; 
-    int i;
+   std::chrono::steady_clock::time_point end_time;
+   int distance;
+   int motion_time = time_ms;
+   int i;
 
-    if (debug) 
-	   printf("computeServoPositions(): joint angles %4.2f %4.2f %4.2f %4.2f %4.2f\n", joint_angles[0], joint_angles[1],joint_angles[2],joint_angles[3],joint_angles[4]);
+   std::lock_guard<std::mutex> lock(joint_state_mutex);   // motion_end_estimate is read by waitUntilReached()
 
-    double bas_pos;
-    double shl_pos;
-    double elb_pos;
-    double wri_pitch_pos;
-    double wri_roll_pos;
+   for (i=0; i<number_of_servos; i++) {
 
-    /* Set the servo angles corresponding to joint angles for the home position */
+      if (channel[i] < 0 || channel[i] >= MAX_SERVOS) continue;
 
-    for (i=0; i<5; i++) {
-       homeOffset[i] = (int) ((float)robotConfigurationData.home[i] / robotConfigurationData.degree[i]);
-    }
+      distance = last_position_known[channel[i]] ? abs(pos[i] - last_position[channel[i]]) : MAX_PW - MIN_PW;
 
+      if (time_ms == 0 && speed > 0) {
+         motion_time = MAX(motion_time, (int) ((1000L * distance) / speed));
+      }
 
-    // Calculate servo positions
+      last_position[channel[i]]       = pos[i];
+      last_position_known[channel[i]] = true;
+   }
 
-    bas_pos       = degrees(joint_angles[0])                  + homeOffset[0];
-    shl_pos       = (degrees(joint_angles[1]) - (float) 90.0) + homeOffset[1];  // joint angle after compensating for the -90 degrees for the home configuration
-    elb_pos       = (-degrees(joint_angles[2]) - (float) 90.0) + homeOffset[2];  // joint angle after compensating for the -90 degrees for the home configuration
-    wri_pitch_pos = degrees(joint_angles[3])                  + homeOffset[3];
-    if (robotConfigurationData.lightweightWrist == true) {
-       wri_roll_pos  = - degrees(joint_angles[4])             + homeOffset[4];            
-    }
-    else {
-       wri_roll_pos  =   degrees(joint_angles[4])             + homeOffset[4];  // roll servo rotates in reverse with the medium duty wrist attachment
-    }
+   end_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(motion_time);
 
-    //if (wri_roll_pos > 90) wri_roll_pos = wri_roll_pos - 180; // NEW CHECK
-    //if (wri_roll_pos < 90) wri_roll_pos = wri_roll_pos + 180; // NEW CHECK
-	
-    positions[0] = (int)(bas_pos       * robotConfigurationData.degree[0]);
-    positions[1] = (int)(shl_pos       * robotConfigurationData.degree[1]);
-    positions[2] = (int)(elb_pos       * robotConfigurationData.degree[2]);
-    positions[3] = (int)(wri_pitch_pos * robotConfigurationData.degree[3]);
-    positions[4] = (int)(wri_roll_pos  * robotConfigurationData.degree[4]);
+   if (end_time > motion_end_estimate) motion_end_estimate = end_time;
+}
 
-    if (debug) {
-	   printf("computeServoPositions(): servo positions ");
-	   for (i=0; i<=4; i++) {   
-		  printf("%4d ",positions[i]);
-	   }
-       printf("\n");
-    }
 
-    return true;  
-}
+/* waitUntilReached()
 
-void grasp(int d) { // d is distance between finger tips:  0 <= d <= 30 mm
+   Block until the robot has reached the joint angles and gripper distance of the last setJointAngles() and grasp() 
+   commands, i.e. robotConfigurationData.current_joint_value[], or until timeout_ms milliseconds have elapsed.
 
-  /* The gripper is controlled by servo 6
-   *
-   * The calibration data are stored in element 5 of the home[], degree[], and channel[] arrays
-   * in the global robotConfigurationData structure
-   *
-   * The gripper is approximately 30mm apart (i.e. fully open) when at the servo setpoint given by home[5]
-   *
-   * A (closing) distance of 1 mm is given by the PW defined by degree[5] array
-   * and, a gripper opening distance of d mm is given by home[5] + (30-d) * degree[5]
-   */
+   When the /lynxmotion_al5d/joint_states topic is being published, the function waits on a condition variable 
+   that is signalled by jointStates() and re-tests the joint states each time they are updated.  
+   The target is reached when
+     - each of the five joint angles is within tolerance radians of its setpoint, and
+     - the gripper is within GRIPPER_TOLERANCE metres of its setpoint or its setpoint has not changed since the last call.
+   It is also reached if the robot has moved and then stopped for WAIT_SETTLE_SAMPLES joint states, e.g. when the gripper 
+   closes on an object that is wider than the commanded distance.
+
+   When no joint states have been received for JOINT_STATE_TIMEOUT milliseconds, the function sleeps until the 
+   time at which the servo-controller is estimated to finish the last command (see estimateMotionEnd()).
+
+   Returns false if the timeout expired first.
+*/
 
-   static bool first_call = true;
+bool waitUntilReached(double tolerance, int timeout_ms) {
 
    bool debug = false;
-   int pw;
-   
-   static ros::NodeHandle n;                        // ROS node
-   static ros::Publisher  pub_;                     // publisher
-   static ros::Subscriber sub;                      // subscriber
-   static ros::Rate rate(2);                        // Loop at 2Hz until the node is shut down
-   static std_msgs::Float64MultiArray msg;
-   static std::vector<float> joints_values;
 
-   if (robotConfigurationData.simulator) {
+   static float last_gripper_target = -1;          // gripper setpoint at the last call
 
-      if (first_call) {
-         pub_ = n.advertise<std_msgs::Float64MultiArray>("/lynxmotion_al5d/joints_positions/command", 1000);
-         sub = n.subscribe("/lynxmotion_al5d/joint_states", 1000, &jointStates);
-	
-         /* Waiting for the publisher to be ready to publish the message */
-	   
-         while (pub_.getNumSubscribers()<1) {
-	     
-            // waiting for a connection to publisher
+   std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+   std::chrono::steady_clock::time_point motion_end;
+   std::unique_lock<std::mutex> lock(joint_state_mutex);
 
-            if (debug) printf("Waiting for connection to publisher \n");	     
-         }
-         first_call = false; // only need to do this the first time
-       }
+   float initial_state[6];
+   float previous_state[6];
+   unsigned long seen;
+   bool gripper_target_changed;
+   bool within_tolerance;
+   bool moved = false;
+   bool stationary;
+   int  settled = 0;
+   int  i;
 
-       /* copy the gripper distance angles to the globally-accessible structure so that it can be used when constucting the topic message in the setJointAngles() function */
+   gripper_target_changed = (robotConfigurationData.current_joint_value[5] != last_gripper_target);
+   last_gripper_target    =  robotConfigurationData.current_joint_value[5];
 
-       robotConfigurationData.current_joint_value[5] = ((double) d) / 1000;
-   
-       
-       /* now construct the topic message with all six joint values: five for the joint angles and one for the gripper */
-       /* use the values in robotConfigurationData.current_joint_value[]                                               */
+   if (joint_state_count == 0 || std::chrono::steady_clock::now() - joint_state_time > std::chrono::milliseconds(JOINT_STATE_TIMEOUT)) {
 
- 
-       joints_values = {robotConfigurationData.current_joint_value[0],
-                        robotConfigurationData.current_joint_value[1],
-		        robotConfigurationData.current_joint_value[2],
-		        robotConfigurationData.current_joint_value[3],
-		        robotConfigurationData.current_joint_value[4],
-		        robotConfigurationData.current_joint_value[5]};
-	
-       msg.layout.dim.push_back(std_msgs::MultiArrayDimension());
-       msg.layout.dim[0].size = joints_values.size();
-       msg.layout.dim[0].stride = 1;
-       msg.layout.dim[0].label = "joints";
+      /* no joint states: fall back to the estimated completion time of the servo commands */
+
+      motion_end = motion_end_estimate;
 
-       msg.data.clear();
-       msg.data.insert(msg.data.end(), joints_values.begin(), joints_values.end());
+      lock.unlock();
 
-       pub_.publish(msg); // publishing the message
+      if (debug) printf("waitUntilReached(): no joint states; waiting for the estimated end of the motion\n");
+
+      if (motion_end > deadline) {
+         std::this_thread::sleep_until(deadline);
+         return false;
+      }
+      std::this_thread::sleep_until(motion_end);
+      return true;
    }
-   else {
-  
-      /* direct control of physical robot */
 
-      /*** this code needs to be moved to a dedicated lynxmotionController node which will subscribe to the /lynxmotion_al5d/joints_positions/command topic (see above) ***/
-      /*** we can then run either the lynxmotion simulator or the lynxmotionController depending on whether we are using the simulator or the real robot                ***/
-      /*** better still, move the inverse kinematics too and publish a pose (vector & quaternion) instead of the joint angles                                           ***/
+   for (i=0; i<6; i++) {
+      initial_state[i]  = joint_state_[i];
+      previous_state[i] = joint_state_[i];
+   }
+   seen = joint_state_count - 1;    // test the current joint states before waiting for new ones
 
-      pw = robotConfigurationData.home[5] + (int) (float (30-d) * robotConfigurationData.degree[5]);
+   while (true) {
 
-      if (debug) {
-         printf("grasp: %d\n",d);
-        // printf("grasp: d %d  PW %d\n", d, pw);
+      if (!joint_state_changed.wait_until(lock, deadline, [&seen] { return joint_state_count != seen; })) {
+         if (debug) printf("waitUntilReached(): timeout\n");
+         return false;
       }
-   
-      executeCommand(robotConfigurationData.channel[5], pw, robotConfigurationData.speed * 2);
-   }
-}
+      seen = joint_state_count;
 
+      within_tolerance = true;
+      for (i=0; i<5; i++) {
+         if (fabs(joint_state_[i] - robotConfigurationData.current_joint_value[i]) > tolerance) within_tolerance = false;
+      }
+      if (gripper_target_changed && fabs(joint_state_[5] - robotConfigurationData.current_joint_value[5]) > GRIPPER_TOLERANCE) {
+         within_tolerance = false;
+      }
 
-int pose_within_working_env(float x, float y, float z)
-{
-    if((int)x <= MAX_X && (int) x > MIN_X && (int)y <= MAX_Y && (int) y > MIN_Y && (int)z <= MAX_Z && (int) z > MIN_Z ) return 1;
-    else return 0;
-}
+      if (within_tolerance) return true;
 
-#ifdef ROS
-void jointStates(const sensor_msgs::JointState::ConstPtr& msg)
-{
-  
-    /* The messages are echoed starting from the gripper then the joints */
-    joint_state_[5] = msg->position[0];
-    joint_state_[0] = msg->position[1];
-    joint_state_[1] = msg->position[2];
-    joint_state_[2] = msg->position[3];
-    joint_state_[3] = msg->position[4];
-    joint_state_[4] = msg->position[5];
-   
+      stationary = true;
+      for (i=0; i<6; i++) {
+         if (fabs(joint_state_[i] - initial_state[i])  > JOINT_STATIONARY) moved      = true;
+         if (fabs(joint_state_[i] - previous_state[i]) > JOINT_STATIONARY) stationary = false;
+         previous_state[i] = joint_state_[i];
+      }
+
+      settled = (moved && stationary) ? settled + 1 : 0;
+
+      if (settled >= WAIT_SETTLE_SAMPLES) {
+         if (debug) printf("waitUntilReached(): robot stopped before reaching the target\n");
+         return true;
+      }
+   }
 }
-#endif
 
 
 
@@ -1384,6 +2120,29 @@ void executeCommand(int *channel, int *pos, int speed, int number_of_servos) {
     }
      
     sendToSerialPort(command);
+
+    estimateMotionEnd(channel, pos, number_of_servos, robotConfigurationData.speed, 0);
+}
+
+
+/* execute a timed group move: all servos start and arrive together after time_ms milliseconds */
+
+void executeGroupMove(int *channel, int *pos, int number_of_servos, int time_ms) {
+
+    char command[COMMAND_SIZE] = {0};
+    char temp[COMMAND_SIZE];
+
+    for(int i =0; i< number_of_servos; i++) {
+        sprintf(temp, " #%dP%d", channel[i], pos[i]);
+        strcat(command, temp);
+    }
+
+    sprintf(temp, " T%d ", time_ms);
+    strcat(command, temp);
+
+    sendToSerialPort(command);
+
+    estimateMotionEnd(channel, pos, number_of_servos, 0, time_ms);
 }
 
 
@@ -1396,26 +2155,219 @@ void executeCommand(int channel, int pos, int speed) {
     sprintf(command, " #%dP%dS%d ", channel, pos, speed); // David Vernon ... added space before # ... without this port 0 is not affected
                                                           // also removed the <CR> after the command
     sendToSerialPort(command);
+
+    estimateMotionEnd(&channel, &pos, 1, speed, 0);
+}
+
+
+/* Persistent serial port connection to the SSC-32 servo controller                                    */
+/*                                                                                                     */
+/* The port is opened once, on the first command, using robotConfigurationData.com and .baud           */
+/* Commands are written with non-blocking writes; any bytes the driver can't accept immediately are    */
+/* held in a write queue and sent on the next call or by flushSerialPort()                             */
+/* This replaces the original fork/exec of "echo <command> > <port>" and the sleep after each command  */
+
+static int  serial_fd = -1;                       // file descriptor of the open port; -1 if closed
+static char serial_queue[SERIAL_QUEUE_SIZE];      // bytes waiting to be written to the port
+static int  serial_queue_length = 0;
+static bool serial_open_failed  = false;          // report a failure to open the port once, not on every command
+
+
+static speed_t baudToSpeed(int baud) {
+
+   switch (baud) {
+   case 9600:   return B9600;
+   case 19200:  return B19200;
+   case 38400:  return B38400;
+   case 57600:  return B57600;
+   case 115200: return B115200;
+   default:     return 0;
+   }
+}
+
+
+bool openSerialPort(char *port, int baud) {
+
+   static bool registered_close = false;
+
+   bool debug = false;
+   struct termios options;
+   speed_t speed;
+
+   if (serial_fd >= 0) return true;  // already open
+
+   if ((speed = baudToSpeed(baud)) == 0) {
+      printf("openSerialPort() error: unsupported baud rate %d\n", baud);
+      return false;
+   }
+
+   if ((serial_fd = open(port, O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0) {
+      printf("openSerialPort() error: can't open %s: %s\n", port, strerror(errno));
+      return false;
+   }
+
+   if (tcgetattr(serial_fd, &options) < 0) {
+      printf("openSerialPort() error: can't read the attributes of %s: %s\n", port, strerror(errno));
+      close(serial_fd);
+      serial_fd = -1;
+      return false;
+   }
+
+   /* raw 8N1, no flow control, reads return immediately */
+
+   cfmakeraw(&options);
+   cfsetispeed(&options, speed);
+   cfsetospeed(&options, speed);
+   options.c_cflag |=  (CLOCAL | CREAD);
+   options.c_cflag &= ~(CSTOPB | CRTSCTS);
+   options.c_cc[VMIN]  = 0;
+   options.c_cc[VTIME] = 0;
+
+   if (tcsetattr(serial_fd, TCSANOW, &options) < 0) {
+      printf("openSerialPort() error: can't configure %s: %s\n", port, strerror(errno));
+      close(serial_fd);
+      serial_fd = -1;
+      return false;
+   }
+
+   tcflush(serial_fd, TCIOFLUSH);
+   serial_queue_length = 0;
+
+   /* make sure the last commands, e.g. goHome(), reach the controller before the application exits */
+
+   if (!registered_close) {
+      atexit(closeSerialPort);
+      registered_close = true;
+   }
+
+   if (debug) printf("openSerialPort(): %s at %d baud\n", port, baud);
+
+   return true;
+}
+
+
+/* write as much of the queue as the port will accept without blocking */
+/* return false only on a write error                                  */
+
+static bool drainSerialQueue() {
+
+   ssize_t n;
+
+   while (serial_queue_length > 0) {
+
+      n = write(serial_fd, serial_queue, serial_queue_length);
+
+      if (n > 0) {
+         serial_queue_length -= (int) n;
+         memmove(serial_queue, serial_queue + n, serial_queue_length);
+      }
+      else if (n < 0 && errno == EINTR) {
+         continue;
+      }
+      else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+         return true;  // port busy: the rest stays queued
+      }
+      else {
+         printf("sendToSerialPort() error: write to %s failed: %s\n", robotConfigurationData.com, strerror(errno));
+         serial_queue_length = 0;
+         return false;
+      }
+   }
+   return true;
+}
+
+
+/* wait until the write queue is empty or timeout_ms has elapsed */
+
+bool flushSerialPort(int timeout_ms) {
+
+   struct pollfd pfd;
+
+   if (serial_fd < 0) return true;
+
+   pfd.fd     = serial_fd;
+   pfd.events = POLLOUT;
+
+   while (serial_queue_length > 0) {
+      if (!drainSerialQueue()) return false;
+      if (serial_queue_length == 0) break;
+      if (poll(&pfd, 1, timeout_ms) <= 0) {
+         printf("flushSerialPort() error: %d bytes not written to %s\n", serial_queue_length, robotConfigurationData.com);
+         return false;
+      }
+   }
+   return true;
+}
+
+
+/* true if the write queue is empty, after waiting at most timeout_ms for the port to accept what is queued   */
+/* unlike flushSerialPort(), a timeout is not reported: the caller can do something else and try again         */
+
+bool serialPortReady(int timeout_ms) {
+
+   struct pollfd pfd;
+
+   if (serial_fd < 0) return true;
+
+   if (!drainSerialQueue() || serial_queue_length == 0) return true;  // on a write error the queue is discarded
+
+   pfd.fd     = serial_fd;
+   pfd.events = POLLOUT;
+
+   if (poll(&pfd, 1, timeout_ms) > 0) {
+      drainSerialQueue();
+   }
+   return serial_queue_length == 0;
+}
+
+
+void closeSerialPort() {
+
+   if (serial_fd >= 0) {
+      flushSerialPort(SERIAL_FLUSH_TIMEOUT);
+      tcdrain(serial_fd);
+      close(serial_fd);
+      serial_fd = -1;
+   }
 }
 
 
-/* send the command to the serial port with the echo OS primitive */
-/* do this with the system() function                             */
+/* queue the command, terminated with a carriage return, and write it to the SSC-32 */
 
-void sendToSerialPort(char *command)
+bool sendToSerialPort(char *command)
 {
-    bool debug = false;  
-    char execcommand[COMMAND_SIZE];
+    bool debug = false;
+    int  length;
 
-    if (debug && false) printf("execute(): %s \n", command);
+    if (debug) printf("sendToSerialPort(): %s \n", command);
 
-    sprintf(execcommand, "echo \"%s\" > %s", command, robotConfigurationData.com);
+    if (serial_fd < 0) {
+       if (serial_open_failed) return false;
+       if (!openSerialPort(robotConfigurationData.com, robotConfigurationData.baud)) {
+          serial_open_failed = true;
+          return false;
+       }
+    }
 
-    if (debug) printf("%s\n", execcommand);
-        
-    system(execcommand);
+    length = (int) strlen(command);
+
+    if (serial_queue_length + length + 1 > SERIAL_QUEUE_SIZE) {
 
-    wait(DEFAULT_SLEEP_TIME); 
+       /* the controller isn't keeping up: give the queue a chance to drain before dropping the command */
+
+       flushSerialPort(SERIAL_FLUSH_TIMEOUT);
+
+       if (serial_queue_length + length + 1 > SERIAL_QUEUE_SIZE) {
+          printf("sendToSerialPort() error: write queue full; command dropped: %s\n", command);
+          return false;
+       }
+    }
+
+    memcpy(serial_queue + serial_queue_length, command, length);
+    serial_queue_length += length;
+    serial_queue[serial_queue_length++] = '\r';
+
+    return drainSerialQueue();
 }
 
 
@@ -1496,3 +2448,53 @@ int kill_brick(std::string name) {
     return 0;
 }    
 
+
+/*=======================================================*/
+/* Utility functions                                     */ 
+/*=======================================================*/
+
+void display_error_and_exit(const char error_message[]) {
+   printf("%s\n", error_message);
+   printf("Hit any key to continue >>");
+   getchar();
+   exit(0);
+}
+
+void prompt_and_exit(int status) {
+   printf("Press any key to continue and close terminal ... \n");
+   getchar();
+   #ifdef ROS
+      // Reset terminal to canonical mode, in case the application turned it off
+      static const int STDIN = 0;
+      termios term;
+      tcgetattr(STDIN, &term);
+      term.c_lflag |= (ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+   #endif
+   exit(status);
+}
+
+void prompt_and_continue() {
+   printf("Press any key to continue ... \n");
+   getchar();
+}
+
+void wait(int ms)
+{
+#ifdef ROS
+   usleep(ms * 1000);
+#else
+   Sleep(ms);
+#endif
+}
+
+void print_message_to_file(FILE *fp, char message[]) {
+   fprintf(fp,"The message is: %s\n", message);
+}
+
+void fail(char *message) {
+    printf("%s\n", message);
+    printf("Enter any character to finish >>");
+    getchar();
+    exit(1);
+}
@@ -130,6 +130,23 @@
 *   David Vernon
 *   13 October 2022
 *
+*   The continuous path approach and depart phases now compute all the waypoints first and execute them 
+*   with a single call to moveTrajectory() instead of one move() and wait() per waypoint
+*   17 October 2026
+*
+*   The pick and place poses are checked against the robot's reachability map, if there is one, before the robot moves
+*   17 October 2026
+*
+*   Replaced the fixed wait() after each move() and grasp() with waitUntilReached() so that the next motion starts 
+*   as soon as the robot has reached the previous pose
+*   17 October 2026
+*
+*   Quit if waitUntilReached() times out instead of commanding the next motion regardless
+*   17 October 2026
+*
+*   Connect to the simulator at startup with startRobotConnection()
+*   17 October 2026
+*
 *******************************************************************************************************************/
 
 #include <stdlib.h>
@@ -150,9 +167,10 @@ int main(int argc, char ** argv) {
    FILE *fp_in;                    // pickAndPlace input file
    int  end_of_file; 
    char robot_configuration_filename[MAX_FILENAME_LENGTH];
+   char reachability_map_filename[MAX_FILENAME_LENGTH];
    char filename[MAX_FILENAME_LENGTH]  = {};
    char directory[MAX_FILENAME_LENGTH] = {};
-   int  small_delay = 200;
+   int  small_delay = 200;         // time in ms between the waypoints of the continuous path trajectories
    
    /* Frame objects */
    
@@ -166,6 +184,8 @@ int main(int argc, char ** argv) {
    Frame destination;
    Frame centre;
 
+   std::vector<Frame> path;        // waypoints for the continuous path approach and depart phases
+
    
    /* data variables */
 
@@ -235,6 +255,18 @@ int main(int argc, char ** argv) {
 
    readRobotConfigurationData(robot_configuration_filename);
 
+   if (robotConfigurationData.simulator) {
+      startRobotConnection();  // connect to the simulator in the background while the rest of the input is read
+   }
+
+   /* the reachability map is optional: build it with the reachabilityMap application */
+
+   reachabilityMapFilename(robot_configuration_filename, reachability_map_filename);
+
+   if (openReachabilityMap(reachability_map_filename)) {
+      if (debug) printf("Reachability map %s\n", reachability_map_filename);
+   }
+
    
    /* get the object pose data */
    /* ------------------------ */
@@ -301,6 +333,19 @@ int main(int argc, char ** argv) {
    object_depart   = trans(0,0,-final_depart_distance);                                          // frame defined w.r.t. grasp frame
 
 
+   /* reject an unreachable pick or place pose before the robot moves                                    */
+   /* the reachability map, if there is one, rejects a pose in a cell with no reachable samples with a   */
+   /* bit lookup; a pose it accepts is confirmed with the inverse kinematics                              */
+
+   if (frame_reachable(inv(Z) * object * object_grasp * inv(E)) == false) {
+      display_error_and_exit("the object pose is not reachable ... quitting\n");
+   }
+
+   if (frame_reachable(inv(Z) * destination * object_grasp * inv(E)) == false) {
+      display_error_and_exit("the destination pose is not reachable ... quitting\n");
+   }
+
+
    /* move to the centre pose */
    /* ----------------------------- */
 
@@ -310,7 +355,7 @@ int main(int argc, char ** argv) {
 
    if (move(T6) == false) display_error_and_exit("move error ... quitting\n");
 
-   wait(2000);
+   if (waitUntilReached() == false) display_error_and_exit("timeout waiting for the robot ... quitting\n");
    
    /* open the gripper */
    /* ----------------- */
@@ -319,10 +364,10 @@ int main(int argc, char ** argv) {
    
    grasp(GRIPPER_OPEN);
 
-   if (robotConfigurationData.simulator) {
-      wait(2000); // wait to allow the simulator to go to the home pose before beginning
-                  // we need to do this because the simulator does not initialize in the home pose
-   }
+   /* this also allows the simulator to go to the centre pose before beginning                  */
+   /* we need to do this because the simulator does not initialize in the home pose             */
+
+   if (waitUntilReached() == false) display_error_and_exit("timeout waiting for the robot ... quitting\n");
    
 
    /* move to the pick approach pose */
@@ -334,27 +379,27 @@ int main(int argc, char ** argv) {
 
    if (move(T6) == false) display_error_and_exit("move error ... quitting\n");;
 
-   wait(2000); 
+   if (waitUntilReached() == false) display_error_and_exit("timeout waiting for the robot ... quitting\n");
 
 
    if (continuous_path) {
 
       /* incrementally decrease the approach distance */
+      /* compute all the waypoints and then execute them as a single trajectory */
      
+      path.clear();
       approach_distance = initial_approach_distance - delta;
    
       while (approach_distance >= 0) {
 	
 	 object_approach   = trans(0,0,-approach_distance);
 	 
-         T6 = inv(Z) * object * object_grasp * object_approach * inv(E);
-	 
-         if (move(T6) == false) display_error_and_exit("move error ... quitting\n");  
-
-	 wait(small_delay);
+         path.push_back(inv(Z) * object * object_grasp * object_approach * inv(E));
 	 
          approach_distance = approach_distance - delta;                              
       }
+
+      if (moveTrajectory(path, small_delay) == false) display_error_and_exit("move error ... quitting\n");  
    }
 
  
@@ -368,7 +413,7 @@ int main(int argc, char ** argv) {
 
    if (move(T6) == false) display_error_and_exit("move error ... quitting\n");
 
-   wait(1000); 
+   if (waitUntilReached() == false) display_error_and_exit("timeout waiting for the robot ... quitting\n");
 
    
    /* close the gripper */
@@ -378,7 +423,7 @@ int main(int argc, char ** argv) {
 
    grasp(GRIPPER_CLOSED); // just less than the width of the brick, in mm, to apply some lateral pressure
 
-   wait(2000);
+   if (waitUntilReached() == false) display_error_and_exit("timeout waiting for the robot ... quitting\n");
 
            
    /* move to pick depart pose */
@@ -389,21 +434,21 @@ int main(int argc, char ** argv) {
    if (continuous_path) {
 
       /* incrementally increase depart distance */
+      /* compute all the waypoints and then execute them as a single trajectory */
 
+      path.clear();
       depart_distance = delta;
       
       while (depart_distance <= final_depart_distance) {
 
 	 object_depart   = trans(0,0,-depart_distance);
 
-         T6 = inv(Z) * object * object_grasp * object_depart * inv(E);          
-                                                                              
-         if (move(T6) == false) display_error_and_exit("move error ... quitting\n"); 
-
-	 wait(small_delay);
+         path.push_back(inv(Z) * object * object_grasp * object_depart * inv(E));
 
 	 depart_distance = depart_distance + delta;
       }
+
+      if (moveTrajectory(path, small_delay) == false) display_error_and_exit("move error ... quitting\n"); 
    }
 
    
@@ -411,7 +456,7 @@ int main(int argc, char ** argv) {
 
    if (move(T6) == false) display_error_and_exit("move error ... quitting\n");;
 
-   wait(2000);
+   if (waitUntilReached() == false) display_error_and_exit("timeout waiting for the robot ... quitting\n");
 
    
    /* move to destination approach pose */
@@ -425,7 +470,7 @@ int main(int argc, char ** argv) {
 
    if (move(T6) == false) display_error_and_exit("move error ... quitting\n");
 
-   wait(2000);
+   if (waitUntilReached() == false) display_error_and_exit("timeout waiting for the robot ... quitting\n");
 
       
    /* move to the destination pose */
@@ -436,21 +481,21 @@ int main(int argc, char ** argv) {
    if (continuous_path) {
 
       /* incrementally decrease approach distance */
+      /* compute all the waypoints and then execute them as a single trajectory */
 
+      path.clear();
       approach_distance = initial_approach_distance - delta;
    
       while (approach_distance >= 0) {
 	
          object_approach   = trans(0,0,-approach_distance);
 	
-         T6 = inv(Z) * destination * object_grasp * object_approach * inv(E);   
-                                                                                  
-         if (move(T6) == false) display_error_and_exit("move error ... quitting\n");
-	 
-	 wait(small_delay);
+         path.push_back(inv(Z) * destination * object_grasp * object_approach * inv(E));
 	 
          approach_distance = approach_distance - delta;
       }
+
+      if (moveTrajectory(path, small_delay) == false) display_error_and_exit("move error ... quitting\n");
    }
 
 
@@ -458,7 +503,7 @@ int main(int argc, char ** argv) {
 
    if (move(T6) == false) display_error_and_exit("move error ... quitting\n");;
  
-   wait(1000);
+   if (waitUntilReached() == false) display_error_and_exit("timeout waiting for the robot ... quitting\n");
 
    
    /* open the gripper */
@@ -467,7 +512,7 @@ int main(int argc, char ** argv) {
    if (debug) printf("Opening gripper\n");
 
    grasp(GRIPPER_OPEN);     
-   wait(1000); 
+   if (waitUntilReached() == false) display_error_and_exit("timeout waiting for the robot ... quitting\n");
 
    
    /* move to depart pose */
@@ -477,20 +522,21 @@ int main(int argc, char ** argv) {
 
    if (continuous_path) {
 
+      /* compute all the waypoints and then execute them as a single trajectory */
+
+      path.clear();
       depart_distance = delta;
       
       while (depart_distance <= final_depart_distance) {
 
 	 object_depart   = trans(0,0,-depart_distance);
 
-         T6 = inv(Z) * destination * object_grasp * object_depart * inv(E);          
-                                                                              
-         if (move(T6) == false) display_error_and_exit("move error ... quitting\n"); 
-
-	 wait(small_delay);
+         path.push_back(inv(Z) * destination * object_grasp * object_depart * inv(E));
 		 
          depart_distance = depart_distance + delta;
       }
+
+      if (moveTrajectory(path, small_delay) == false) display_error_and_exit("move error ... quitting\n"); 
    }
    
    object_depart   = trans(0,0,-final_depart_distance);
@@ -499,7 +545,7 @@ int main(int argc, char ** argv) {
 
    if (move(T6) == false) display_error_and_exit("move error ... quitting\n");
 
-   wait(1000);
+   if (waitUntilReached() == false) display_error_and_exit("timeout waiting for the robot ... quitting\n");
 
     
    //goHome(); // this returns the robot to the home position so that when it's switched off 
@@ -515,7 +561,7 @@ int main(int argc, char ** argv) {
 
    if (move(T6) == false) display_error_and_exit("move error ... quitting\n");
 
-   wait(2000);  
+   if (waitUntilReached() == false) display_error_and_exit("timeout waiting for the robot ... quitting\n");
 
    
    if (robotConfigurationData.simulator)  {
@@ -0,0 +1,162 @@
+/*******************************************************************************************************************
+*   Soak benchmark for joint command publishing
+*   -------------------------------------------
+*
+*   This application publishes a long run of joint commands through setJointAngles() and grasp(), alternating
+*   the two, and checks that publishing takes constant memory and constant time per command.  By default it
+*   publishes 1000000 commands; the number can be given as the first argument.
+*
+*   The node subscribes to its own /lynxmotion_al5d/joints_positions/command topic, so no simulator is needed,
+*   but a ROS master must be running.  The calibration data are read from robot_1_config.txt in the data directory.
+*
+*   The run is divided into SOAK_WINDOWS windows.  For each window the application reports the mean, 99th percentile,
+*   and maximum time per publishing call and the resident set size of the process at the end of the window.
+*   It also checks every message received: the layout must have exactly one dimension and the data six values.
+*
+*   The exit status is 0 if the resident set size grows by no more than SOAK_RSS_TOLERANCE kB between the end of the
+*   first window and the end of the run and every message received has the fixed layout, and 1 otherwise.
+*
+*   Audit Trail
+*   -----------
+*   17 October 2026: created
+*
+*******************************************************************************************************************/
+
+#include <module4/lynxmotionUtilities.h>
+#include <ros/package.h>
+
+#define SOAK_DEFAULT_COMMANDS 1000000
+#define SOAK_WINDOWS          10
+#define SOAK_RSS_TOLERANCE    1024     // kB
+#define SOAK_HISTOGRAM_BINS   10000    // latency histogram: 0.1 microsecond bins up to 1 ms, the last bin holds the rest
+
+
+static long messages_received = 0;
+static long messages_malformed = 0;
+
+static void commandReceived(const std_msgs::Float64MultiArray::ConstPtr& msg) {
+
+   messages_received++;
+
+   if (msg->layout.dim.size() != 1 || msg->data.size() != 6) messages_malformed++;
+}
+
+
+/* resident set size of this process in kB, from /proc/self/status; -1 if it can't be read */
+
+static long residentSetSize() {
+
+   FILE *fp;
+   char  line[256];
+   long  rss = -1;
+
+   if ((fp = fopen("/proc/self/status", "r")) == NULL) return -1;
+
+   while (fgets(line, sizeof(line), fp) != NULL) {
+      if (sscanf(line, "VmRSS: %ld", &rss) == 1) break;
+   }
+
+   fclose(fp);
+   return rss;
+}
+
+
+int main(int argc, char ** argv) {
+
+   ros::init(argc, argv, "publishSoakBenchmark"); // Initialize the ROS system
+
+   extern robotConfigurationDataType robotConfigurationData;
+
+   int    number_of_commands = (argc > 1) ? atoi(argv[1]) : SOAK_DEFAULT_COMMANDS;
+   int    window_size;
+   int    i, w, bin;
+   long   count;
+   long   rss;
+   long   first_rss = 0;
+   long   last_rss  = 0;
+   double latency_us;
+   double sum_us;
+   double max_us;
+   double p99_us;
+   double joint_angles[6] = {0, 0.5, -1.0, 0.5, 0, 0};
+   char   robot_configuration_filename[MAX_FILENAME_LENGTH] = {};
+
+   static long histogram[SOAK_HISTOGRAM_BINS];
+
+   std::chrono::steady_clock::time_point start;
+
+   if (number_of_commands < SOAK_WINDOWS) number_of_commands = SOAK_WINDOWS;
+   window_size = number_of_commands / SOAK_WINDOWS;
+
+   strcat(robot_configuration_filename, (ros::package::getPath(ROS_PACKAGE_NAME) + "/data/robot_1_config.txt").c_str());
+   readRobotConfigurationData(robot_configuration_filename);
+   robotConfigurationData.simulator = true;
+
+   /* subscribe to our own command topic so that the shared publisher has a subscriber */
+
+   ros::NodeHandle n;
+   ros::Subscriber command_subscriber = n.subscribe("/lynxmotion_al5d/joints_positions/command", 1000, &commandReceived);
+
+   startRobotConnection();
+   if (!waitForRobotConnection()) {
+      printf("publishSoakBenchmark: ROS was shut down before the command topic connected\n");
+      return 1;
+   }
+
+   printf("publishSoakBenchmark: %d commands in %d windows\n", number_of_commands, SOAK_WINDOWS);
+   printf("publishSoakBenchmark: window  mean us   p99 us   max us   RSS kB\n");
+
+   for (w=0; w<SOAK_WINDOWS; w++) {
+
+      memset(histogram, 0, sizeof(histogram));
+      sum_us = 0;
+      max_us = 0;
+
+      for (i=0; i<window_size; i++) {
+
+         joint_angles[0] = 0.001 * (i % 1000);   // vary the command so that every message is different
+
+         start = std::chrono::steady_clock::now();
+         if (i % 2 == 0) setJointAngles(joint_angles);
+         else            grasp(i % 30);
+         latency_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+         sum_us += latency_us;
+         if (latency_us > max_us) max_us = latency_us;
+         bin = (int) (latency_us * 10);
+         histogram[bin < SOAK_HISTOGRAM_BINS ? bin : SOAK_HISTOGRAM_BINS - 1]++;
+      }
+
+      /* 99th percentile from the histogram */
+
+      count  = 0;
+      p99_us = 0;
+      for (bin=0; bin<SOAK_HISTOGRAM_BINS; bin++) {
+         count += histogram[bin];
+         if (count >= 0.99 * window_size) {
+            p99_us = (bin + 1) / 10.0;
+            break;
+         }
+      }
+
+      rss = residentSetSize();
+      if (w == 0) first_rss = rss;
+      last_rss = rss;
+
+      printf("publishSoakBenchmark: %6d %8.2f %8.1f %8.1f %8ld\n", w, sum_us / window_size, p99_us, max_us, rss);
+   }
+
+
+   /* report */
+
+   printf("publishSoakBenchmark: %ld messages received, %ld without the fixed layout\n", messages_received, messages_malformed);
+   printf("publishSoakBenchmark: resident set size grew by %ld kB after the first window\n", last_rss - first_rss);
+
+   if (first_rss < 0 || last_rss - first_rss > SOAK_RSS_TOLERANCE || messages_malformed != 0) {
+      printf("publishSoakBenchmark: FAILED\n");
+      return 1;
+   }
+
+   printf("publishSoakBenchmark: passed\n");
+   return 0;
+}
@@ -0,0 +1,87 @@
+/*******************************************************************************************************************
+*   Reachability map builder for a LynxMotion AL5D robot arm
+*   --------------------------------------------------------
+*
+*   This application sweeps the working envelope of the robot through the inverse kinematics and the servo calibration
+*   and writes a bit-packed voxel map of the (x, y, z, pitch) cells that may contain reachable wrist poses, one map 
+*   per robot; a pose in a cell whose bit is clear is not reachable.
+*   See the reachability map section of lynxmotionUtilities.h for the resolution and the file format.
+*
+*   The application reads the input file reachabilityMapInput.txt.
+*   Each line contains the filename of a robot configuration file (see pickAndPlaceApplication.cpp for a description 
+*   of the configuration file).  For each one, the map is written to the data directory with the same name stem, 
+*   e.g. robot_1_config.txt -> robot_1_reachability.map
+*
+*   The map is memory-mapped at runtime by openReachabilityMap() and queried with pose_reachable() or frame_reachable().
+*   It must be rebuilt whenever the HOME or DEGREE calibration data of a robot change; openReachabilityMap() refuses 
+*   a map that was built with different calibration data.
+*
+*   Audit Trail
+*   -----------
+*   17 October 2026: created
+*   17 October 2026: the map marks the cells that may contain a reachable pose, so that a clear bit rejects a pose
+*
+*******************************************************************************************************************/
+
+#include <module4/reachabilityMap.h>
+
+
+int main(int argc, char ** argv) {
+
+   ros::init(argc, argv, "reachabilityMap"); // Initialize the ROS system
+
+   bool debug = true;              // set this to false for silent mode
+
+   FILE *fp_in;                    // reachabilityMap input file
+   char robot_configuration_filename[MAX_FILENAME_LENGTH];
+   char map_filename[MAX_FILENAME_LENGTH];
+   char filename[MAX_FILENAME_LENGTH]  = {};
+   char directory[MAX_FILENAME_LENGTH] = {};
+   int  number_of_maps = 0;
+
+
+   /* open the input file */
+   /* ------------------- */
+
+   strcat(directory, (ros::package::getPath(ROS_PACKAGE_NAME) + "/data/").c_str());
+   strcpy(filename, directory);
+   strcat(filename, "reachabilityMapInput.txt"); // Input filename matches the application name
+   if ((fp_in = fopen(filename, "r")) == 0) {
+      printf("Error can't open input reachabilityMapInput.txt\n");
+      prompt_and_exit(0);
+   }
+
+
+   /* build one map for each robot configuration file */
+   /* ----------------------------------------------- */
+
+   while (fscanf(fp_in, "%s", filename) != EOF) {
+
+      strcpy(robot_configuration_filename, directory);
+      strcat(robot_configuration_filename, filename);
+
+      reachabilityMapFilename(robot_configuration_filename, map_filename);
+
+      if (debug) printf("Robot configuration filename %s\n", robot_configuration_filename);
+
+      readRobotConfigurationData(robot_configuration_filename);
+
+      if (buildReachabilityMap(map_filename) == false) {
+         printf("Fatal error: unable to write the reachability map %s\n", map_filename);
+         prompt_and_exit(1);
+      }
+
+      if (debug) printf("Reachability map written to %s\n", map_filename);
+
+      number_of_maps++;
+   }
+
+   fclose(fp_in);
+
+   if (number_of_maps == 0) {
+      printf("Fatal error: no robot configuration filenames in reachabilityMapInput.txt\n");
+      prompt_and_exit(1);
+   }
+
+   return 0;
+}
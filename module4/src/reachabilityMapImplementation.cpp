@@ -0,0 +1,23 @@
+/*******************************************************************************************************************
+ *   Reachability map builder for a LynxMotion AL5D robot arm
+ *   --------------------------------------------------------
+ *
+ *   Implementation file
+ *
+ *   The map itself is built by buildReachabilityMap() in lynxmotionUtilities.cpp so that it is always computed 
+ *   with the same inverse kinematics and servo calibration that are used to move the robot.
+ *
+ *   Audit Trail
+ *   -----------
+ *   17 October 2026: created
+ *
+ *
+ *******************************************************************************************************************/
+
+#include <module4/reachabilityMap.h>
+
+/*=======================================================*/
+/* Other functions                                     */ 
+/*=======================================================*/
+
+/* the utility functions, e.g. wait() and prompt_and_exit(), are in lynxmotionUtilities.cpp */
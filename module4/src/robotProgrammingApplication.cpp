@@ -73,6 +73,8 @@
 *
 *   21 March 2021: Changed the initialization of the E frame to use the x, y, and z values read from the configuration file,
 *                  not just the z value
+*
+*   17 October 2026: Connect to the simulator at startup with startRobotConnection()
 *  
 *
 *******************************************************************************************************************/
@@ -172,6 +174,10 @@ int main(int argc, char ** argv) {
    if (end_of_file != EOF) {  // only proceed if there is a configuration file
 
       readRobotConfigurationData(filename);
+
+      if (robotConfigurationData.simulator) {
+         startRobotConnection();  // connect to the simulator in the background
+      }
 	  	 
       goHome();    // not strictly necessary ... just for demonstration
       wait(4000);  // wait for 4 seconds
@@ -0,0 +1,135 @@
+/*******************************************************************************************************************
+*   Serial port loopback test for the SSC-32 interface
+*   --------------------------------------------------
+*
+*   This application tests the persistent serial connection used by sendToSerialPort(), executeCommand(), and goHome()
+*   without a robot: it opens a pseudo-terminal, points robotConfigurationData.com at the slave side, and reads
+*   back on the master side everything that the driver writes.
+*
+*   It sends a number of five-servo commands, given by the first argument (default 100000), checks that every byte
+*   arrives in order with the carriage return that terminates each command, and reports the number of commands
+*   per second that the driver sustains.  The pseudo-terminal has a small buffer, so the test also exercises the
+*   write queue that holds commands while the port is busy.
+*
+*   The exit status is 0 if every command arrived intact and 1 otherwise, so the test can be run by ctest.
+*
+*   Audit Trail
+*   -----------
+*   17 October 2026: created
+*
+*******************************************************************************************************************/
+
+#include <module4/lynxmotionUtilities.h>
+#include <chrono>
+
+#define LOOPBACK_DEFAULT_COMMANDS 100000
+#define LOOPBACK_BUFFER_SIZE      65536
+
+
+/* read everything that is waiting on the master side and check it against the expected byte stream */
+/* the expected stream is the command repeated, each copy followed by a carriage return              */
+
+static bool readLoopback(int master_fd, const char *command, long *bytes_received, long *mismatches) {
+
+   static char buffer[LOOPBACK_BUFFER_SIZE];
+   long    period = (long) strlen(command) + 1;
+   ssize_t n;
+   char    expected;
+   ssize_t i;
+
+   while ((n = read(master_fd, buffer, sizeof(buffer))) > 0) {
+      for (i = 0; i < n; i++) {
+         expected = ((*bytes_received + i) % period == period - 1) ? '\r' : command[(*bytes_received + i) % period];
+         if (buffer[i] != expected) (*mismatches)++;
+      }
+      *bytes_received += n;
+   }
+
+   if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      printf("serialLoopbackTest: read from the pseudo-terminal failed: %s\n", strerror(errno));
+      return false;
+   }
+   return true;
+}
+
+
+int main(int argc, char ** argv) {
+
+   extern robotConfigurationDataType robotConfigurationData;
+
+   char command[] = " #0P1500S500  #1P1500S500  #2P1500S500  #3P1500S500  #4P1500S500 ";   // as built by executeCommand()
+
+   int    number_of_commands = (argc > 1) ? atoi(argv[1]) : LOOPBACK_DEFAULT_COMMANDS;
+   int    master_fd;
+   char  *slave_name;
+   long   bytes_expected;
+   long   bytes_received = 0;
+   long   mismatches     = 0;
+   int    failed_sends   = 0;
+   int    i;
+   double elapsed_s;
+
+   std::chrono::steady_clock::time_point start;
+   std::chrono::steady_clock::time_point deadline;
+
+
+   /* create the pseudo-terminal and use its slave side as the SSC-32 port */
+
+   if ((master_fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0 || grantpt(master_fd) < 0 || unlockpt(master_fd) < 0) {
+      printf("serialLoopbackTest: can't create a pseudo-terminal: %s\n", strerror(errno));
+      return 1;
+   }
+
+   if ((slave_name = ptsname(master_fd)) == NULL || strlen(slave_name) >= sizeof(robotConfigurationData.com)) {
+      printf("serialLoopbackTest: the pseudo-terminal name does not fit in robotConfigurationData.com\n");
+      return 1;
+   }
+
+   strcpy(robotConfigurationData.com, slave_name);
+   robotConfigurationData.baud = 115200;
+
+   if (!openSerialPort(robotConfigurationData.com, robotConfigurationData.baud)) {
+      return 1;
+   }
+
+   printf("serialLoopbackTest: %d commands through %s\n", number_of_commands, slave_name);
+
+
+   /* send the commands, reading the loopback as we go so that the pseudo-terminal buffer does not stay full */
+
+   start = std::chrono::steady_clock::now();
+
+   for (i = 0; i < number_of_commands; i++) {
+      if (!sendToSerialPort(command)) failed_sends++;
+      if (!readLoopback(master_fd, command, &bytes_received, &mismatches)) return 1;
+   }
+
+   bytes_expected = (long) number_of_commands * (long) (strlen(command) + 1);
+
+   deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SERIAL_FLUSH_TIMEOUT);
+
+   while (bytes_received < bytes_expected && std::chrono::steady_clock::now() < deadline) {
+      flushSerialPort(0);
+      if (!readLoopback(master_fd, command, &bytes_received, &mismatches)) return 1;
+   }
+
+   elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+   closeSerialPort();
+   close(master_fd);
+
+
+   /* report */
+
+   printf("serialLoopbackTest: %ld of %ld bytes received, %ld mismatched, %d commands not sent\n",
+          bytes_received, bytes_expected, mismatches, failed_sends);
+   printf("serialLoopbackTest: %.3f s, %.0f commands per second\n", elapsed_s, elapsed_s > 0 ? number_of_commands / elapsed_s : 0.0);
+
+   if (bytes_received != bytes_expected || mismatches != 0 || failed_sends != 0) {
+      printf("serialLoopbackTest: FAILED\n");
+      return 1;
+   }
+
+   printf("serialLoopbackTest: passed\n");
+   return 0;
+}
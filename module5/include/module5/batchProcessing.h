@@ -0,0 +1,81 @@
+/*
+  Headless batch processing
+  -------------------------
+
+  (This is the interface file: it contains the declarations of the functions that run the core of a module5 application
+  over a batch of images without a user interface.  The functions are defined in batchProcessing.cpp, which is built as
+  the batchProcessing library and linked by the applications that support batch mode.)
+
+  An application that supports batch mode is run as
+
+     application --batch <images> <output directory> [number of threads]
+
+  where <images> is either a directory, in which case every image file in it is processed, or a text file with one
+  image filename per line, which may contain spaces; filenames without a path are in the directory of the text file.
+
+  The images are shared among a pool of worker threads.  Each worker reads an image and passes it to the batch function
+  of the application, which writes its results to files whose names begin with the output stem: the output directory
+  followed by the name of the image without its extension.  If several images have the same name, e.g. because they are
+  in different directories, the output stem of each of them ends in _<n>, where n is the number of the image in the list.
+  No windows are opened and no key presses are needed.
+  The time taken to read and to process each image is written to <application>Timings.txt in the output directory.
+  An image that can't be read, for which the batch function returns false, or for which it throws an exception is
+  reported and counted as failed; the other images are still processed.
+
+  Since the images are processed in parallel, OpenCV's own threads are turned off while the batch runs.
+
+  Audit Trail
+  --------------------
+  Created: isBatchMode(), getBatchOptions(), runBatch()
+  17 October 2026
+
+  Filenames with spaces in the list of images; distinct output stems for images with the same name
+  17 October 2026
+
+  An exception thrown while an image is read or processed fails that image rather than the batch
+  17 October 2026
+*/
+
+#ifndef BATCH_PROCESSING_H
+#define BATCH_PROCESSING_H
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#define BATCH_MAX_THREADS   64
+#define BATCH_MAX_FILENAME  1024
+#define BATCH_FLAG          "--batch"
+
+using namespace std;
+using namespace cv;
+
+
+/* the command line arguments of a batch */
+
+typedef struct {
+   char input[BATCH_MAX_FILENAME];              // directory of images or text file of image filenames
+   char output_directory[BATCH_MAX_FILENAME];
+   int  number_of_threads;
+} batchOptionsType;
+
+
+/* The core of an application applied to one image: true on success.                                              */
+/* worker is the number of the calling thread, 0 to number_of_threads - 1, so that an application can give each   */
+/* thread its own copy of anything that cannot be shared; context is passed through unchanged from runBatch().     */
+
+typedef bool (*batchFunctionType)(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
+
+
+/* function prototypes */
+
+bool isBatchMode(int argc, char **argv);
+bool getBatchOptions(int argc, char **argv, batchOptionsType *options);
+int  runBatch(const batchOptionsType &options, const char *application_name, int imread_flags,
+              batchFunctionType function, void *context);
+
+#endif
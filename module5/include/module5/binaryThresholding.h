@@ -11,6 +11,18 @@
   Ported to OpenCV 4
   David Vernon
   9 July 2024
+
+  Added prepareThresholding() and thresholdImage()
+  17 October 2026
+
+  Included runLengthEncoding.h
+  17 October 2026
+
+  runLengthEncoding.h is no longer included: the trackbar callback does not run-length encode the thresholded image
+  17 October 2026
+
+  Added binaryThresholdingBatch() for headless batch mode: included batchProcessing.h
+  17 October 2026
 */
 
 
@@ -44,6 +56,7 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/batchProcessing.h"
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -58,6 +71,7 @@
 #define FALSE 0
 #define MAX_STRING_LENGTH   80
 #define MAX_FILENAME_LENGTH 200
+#define NUMBER_OF_GREY_LEVELS 256
 
 using namespace std;
 using namespace cv;
@@ -65,6 +79,9 @@ using namespace cv;
 /* function prototypes go here */
 
 void binaryThresholding(int, void*);  
+bool binaryThresholdingBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
+void prepareThresholding(const Mat &inputImage, Mat &greyscaleImage, long foregroundCount[]);
+void thresholdImage(const Mat &greyscaleImage, Mat &thresholdedImage, int threshold);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
@@ -11,6 +11,15 @@
   Ported to OpenCV 4
   David Vernon
   9 July 2024
+
+  Added the Otsu engine: computeHistogram(), otsuThresholds(), applyThresholds(), and localOtsuThreshold()
+  17 October 2026
+
+  localOtsuThreshold() takes the histogram built by computeHistogram()
+  17 October 2026
+
+  Added binaryThresholdingOtsuBatch() for headless batch mode: included batchProcessing.h
+  17 October 2026
 */
 
 
@@ -45,6 +54,7 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/batchProcessing.h"
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -59,12 +69,24 @@
 #define MAX_STRING_LENGTH   80
 #define MAX_FILENAME_LENGTH 200
 
+#define NUMBER_OF_GREY_LEVELS      256
+#define OTSU_MAX_THRESHOLDS        4    // multi-level Otsu: at most 5 classes
+#define OTSU_NUMBER_OF_THRESHOLDS  2    // number of thresholds in the multi-level image that is displayed
+#define OTSU_TILE_SIZE             64   // local Otsu: tile width and height in pixels
+#define OTSU_MIN_TILE_CONTRAST     8.0  // local Otsu: tiles with a lower between-class standard deviation use the global threshold
+
 using namespace std;
 using namespace cv;
 
 /* function prototypes go here */
 
 void binaryThresholdingOtsu(char *filename);  
+bool binaryThresholdingOtsuBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
+void computeHistogram(const Mat &greyscaleImage, long histogram[]);
+double otsuThresholds(const long histogram[], int numberOfThresholds, int thresholds[]);
+double otsuClassScore(const double P[], const double S[], int a, int b);
+void applyThresholds(const Mat &greyscaleImage, Mat &thresholdedImage, const int thresholds[], int numberOfThresholds);
+void localOtsuThreshold(const Mat &greyscaleImage, const long histogram[], Mat &thresholdedImage, int tileSize);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
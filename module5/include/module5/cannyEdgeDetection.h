@@ -11,6 +11,12 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Added CannyPipeline: each stage is cached and rerun only when its input or its parameters change
+  17 October 2026
+
+  Added cannyEdgeDetectionBatch() for headless batch mode: included batchProcessing.h
+  17 October 2026
 */
  
 
@@ -29,9 +35,11 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "string.h"
+#include "math.h"
 #include <ctype.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #ifndef ROS
    #include <conio.h>
@@ -45,6 +53,7 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/batchProcessing.h"
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -59,12 +68,63 @@
 #define MAX_STRING_LENGTH   80
 #define MAX_FILENAME_LENGTH 200
 
+/* Canny pipeline stages: see CannyPipeline */
+
+#define CANNY_GREY          0
+#define CANNY_BLUR          1
+#define CANNY_GRADIENTS     2
+#define CANNY_NMS           3
+#define CANNY_HYSTERESIS    4
+#define CANNY_STAGES        5
+#define CANNY_RATIO         3      // high threshold = low threshold * CANNY_RATIO
+#define CANNY_TG22          13573  // tan(22.5 degrees) * 2^CANNY_SHIFT, as in OpenCV Canny()
+#define CANNY_SHIFT         15
+
 using namespace std;
 using namespace cv;
 
+
+/* Staged Canny edge detector 
+ 
+   grey -> blur(sigma) -> gradients -> non-maximum suppression -> hysteresis(low, high)
+
+   Each stage keeps its output and the key it was computed from; run() reruns a stage only when its key, or the output
+   of the stage before it, has changed.  A change of threshold therefore reruns the hysteresis only, and a change of 
+   sigma reruns the blur and everything after it.  Non-maximum suppression keeps the magnitude of every local maximum,
+   whatever the thresholds, so that it does not depend on them.
+
+   The result is the same as GaussianBlur() followed by Canny() with a 3x3 aperture and the L1 gradient.
+*/
+
+struct CannyPipeline {
+
+   Mat grey;                           // CV_8UC1
+   Mat blurred;                        // CV_8UC1
+   Mat dx, dy;                         // CV_16SC1 Sobel derivatives
+   Mat suppressed;                     // CV_16UC1 L1 gradient magnitude at local maxima, 0 elsewhere
+   Mat edges;                          // CV_8UC1 edge map: 255 edge, 0 background
+
+   const uchar *grey_source;           // stage keys
+   int blur_sigma;
+   int hysteresis_low;
+   int hysteresis_high;
+
+   double stage_ms[CANNY_STAGES];      // time taken by each stage the last time it ran
+   bool   stage_run[CANNY_STAGES];     // true if the stage ran in the last call to run()
+
+   CannyPipeline();
+   void invalidate();
+   const Mat &run(const Mat &src, int sigma, int low, int high);
+   void timing(char text[], int length);
+};
+
+
 /* function prototypes go here */
 
 void CannyThreshold(int, void*);
+bool cannyEdgeDetectionBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
+void cannyNonMaximumSuppression(const Mat &dx, const Mat &dy, Mat &suppressed);
+void cannyHysteresis(const Mat &suppressed, Mat &edges, int low, int high);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
@@ -10,6 +10,16 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Added buildSegmentationLUT() and segmentationMask()
+  17 October 2026
+
+  Replaced buildSegmentationLUT() with the multi-sample hue-saturation model: addColourSample(), clearColourModel(),
+  saveColourModel(), loadColourModel(), and buildBackProjectionLUT()
+  17 October 2026
+
+  Added colourSegmentationBatch() for headless batch mode with a saved colour model: included batchProcessing.h
+  17 October 2026
 */
  
 
@@ -46,6 +56,7 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/batchProcessing.h"
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -61,13 +72,29 @@
 #define MAX_STRING_LENGTH 80
 #define MAX_FILENAME_LENGTH 200
 
+/* hue/saturation segmentation lookup table: OpenCV 8-bit hue is 0..180, saturation 0..255 */
+
+#define SEGMENTATION_HUE_LEVELS        181
+#define SEGMENTATION_SATURATION_LEVELS 256
+#define SEGMENTATION_LUT_SIZE          (SEGMENTATION_HUE_LEVELS * SEGMENTATION_SATURATION_LEVELS)
+
+#define DRAG_TOLERANCE         2                               // pixels: a smaller mouse movement is a click, not a drag
+#define COLOUR_MODEL_FILENAME  "colourSegmentationModel.yml"   // in the data directory
+
 using namespace std;
 using namespace cv;
 
 /* function prototypes go here */
 
 void colourSegmentation(int, void*);
-void getSamplePoint( int event, int x, int y, int, void*);
+void getSamplePoint( int event, int x, int y, int flags, void*);
+void addColourSample(Rect region);
+void clearColourModel();
+bool saveColourModel(const char *filename);
+bool loadColourModel(const char *filename);
+bool colourSegmentationBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
+void buildBackProjectionLUT(const Mat &model, int hueRange, int saturationRange, int threshold, unsigned char lut[]);
+void segmentationMask(const Mat &inputHLSImage, Mat &mask, const unsigned char lut[]);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 // void pause(int milliseconds);
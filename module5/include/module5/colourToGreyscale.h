@@ -11,6 +11,15 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Added colourToGreyscaleImage() and the GREYSCALE_MEAN and GREYSCALE_LUMINANCE modes
+  17 October 2026
+
+  Added LUMINANCE_FLAG
+  17 October 2026
+
+  Added colourToGreyscaleBatch() for headless batch mode: included batchProcessing.h
+  17 October 2026
 */
  
 
@@ -45,6 +54,7 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/batchProcessing.h"
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -61,12 +71,27 @@
 #define MAX_STRING_LENGTH 80
 #define MAX_FILENAME_LENGTH 200
 
+/* greyscale conversion modes */
+
+#define GREYSCALE_MEAN      0   // equal-weight mean of the channels
+#define GREYSCALE_LUMINANCE 1   // ITU-R BT.601 luminance
+#define LUMINANCE_FLAG      "--luminance"   // command line option that selects GREYSCALE_LUMINANCE
+
+/* BT.601 luminance weights in fixed point: 0.114, 0.587, 0.299 scaled by 2^LUMINANCE_SHIFT; they sum to 2^14 */
+
+#define LUMINANCE_SHIFT 14
+#define LUMINANCE_B     1868
+#define LUMINANCE_G     9617
+#define LUMINANCE_R     4899
+
 using namespace std;
 using namespace cv;
 
 /* function prototypes go here */
 
-void colourToGreyscale(char *filename);
+void colourToGreyscale(char *filename, int mode = GREYSCALE_MEAN);
+bool colourToGreyscaleBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
+void colourToGreyscaleImage(const Mat &colourImage, Mat &greyscaleImage, int mode = GREYSCALE_MEAN);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
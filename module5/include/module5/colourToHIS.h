@@ -11,6 +11,12 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Added rgb2hsiImage() and chroma2hs()
+  17 October 2026
+
+  Added colourToHISBatch() for headless batch mode: included batchProcessing.h
+  17 October 2026
 */
 
 
@@ -32,6 +38,7 @@
 #include <ctype.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #ifndef ROS
    #include <conio.h>
@@ -45,6 +52,7 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/batchProcessing.h"
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -60,14 +68,23 @@
 #define MAX_STRING_LENGTH 80
 #define MAX_FILENAME_LENGTH 200
 
+/* factorised hue/saturation lookup table: see hsiLookupTable() */
+
+#define HSI_LUT_U_OFFSET 510                        // u = 2 red - green - blue in [-510, 510]
+#define HSI_LUT_V_OFFSET 255                        // v = blue - green        in [-255, 255]
+#define HSI_LUT_U_SIZE   (2 * HSI_LUT_U_OFFSET + 1)
+#define HSI_LUT_V_SIZE   (2 * HSI_LUT_V_OFFSET + 1)
+
 using namespace std;
 using namespace cv;
 
 /* function prototypes go here */
 
 void colourToHIS(char *filename);
+bool colourToHISBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
 void rgb2hsi(unsigned char red, unsigned char green, unsigned char blue, float *hue, float *saturation, float *intensity);
-void rgb2hsi_old(unsigned char red, unsigned char green, unsigned char blue, float *hue, float *saturation, float *intensity);
+void chroma2hs(double c1, double c2, float *hue, float *saturation);
+void rgb2hsiImage(const Mat &colourImage, Mat &hueImage, Mat &saturationImage, Mat &intensityImage, bool use_lut = true);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
@@ -11,6 +11,15 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Added labelComponents() and componentStatisticsType
+  17 October 2026
+
+  Moved componentStatisticsType and the labeller to the runLengthEncoding library: see labelRuns()
+  17 October 2026
+
+  Added connectedComponentsBatch() for headless batch mode: included batchProcessing.h
+  17 October 2026
 */
 
 
@@ -31,6 +40,7 @@
 #include <ctype.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #ifndef ROS
    #include <conio.h>
@@ -44,6 +54,8 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/runLengthEncoding.h"
+#include "module5/batchProcessing.h"
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -65,6 +77,7 @@ using namespace cv;
 /* function prototypes go here */
 
 void connectedComponents(int, void*);  
+bool connectedComponentsBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
@@ -11,6 +11,14 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Audit Trail
+  --------------------
+  Included runLengthEncoding.h for traceContours()
+  17 October 2026
+
+  Added contourExtractionBatch() for headless batch mode: included batchProcessing.h
+  17 October 2026
 */
  
 
@@ -45,6 +53,8 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/runLengthEncoding.h"
+#include "module5/batchProcessing.h"
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -65,6 +75,7 @@ using namespace cv;
 /* function prototypes go here */
 
 void ContourExtraction(int, void*);
+bool contourExtractionBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
@@ -11,6 +11,11 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Audit Trail
+  --------------------
+  Added faceDetectionBatch() for headless batch mode: included batchProcessing.h
+  17 October 2026
 */
  
 #define GCC_COMPILER (defined(__GNUC__) && !defined(__clang__))
@@ -43,6 +48,7 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/batchProcessing.h"
  
 
 #define TRUE  1
@@ -57,6 +63,7 @@ using namespace cv;
 /* function prototypes go here */
 
 void faceDetection(char *filename, CascadeClassifier& cascade); 
+bool faceDetectionBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
@@ -11,6 +11,27 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Audit Trail
+  --------------------
+  Included runLengthEncoding.h for traceContours()
+  17 October 2026
+
+  Added featureTableType and extractFeatures(), drawFeatures(), writeFeatures()
+  17 October 2026
+
+  Removed elapsed_ms from featureTableType
+  17 October 2026
+
+  writeFeatures() writes a block of the binary feature file: included featureFile.h
+  17 October 2026
+
+  Added APPEND_FLAG
+  17 October 2026
+
+  Added featureBatchType, extractImageFeatures(), tabulateFeatures(), and featureExtractionBatch() for headless batch mode:
+  included batchProcessing.h
+  17 October 2026
 */
  
 
@@ -45,6 +66,9 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/runLengthEncoding.h"
+#include "module5/featureFile.h"
+#include "module5/batchProcessing.h"
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -59,13 +83,54 @@
 #define FALSE 0
 #define MAX_STRING_LENGTH 80
 #define MAX_FILENAME_LENGTH 200
+#define MIN_CONTOUR_LENGTH  10    // contours with this number of points or fewer are not analysed
+#define APPEND_FLAG         "--append"   // command line option: add the blocks to an existing feature file
+#define NUMBER_OF_HU_MOMENTS FEATURE_HU_MOMENTS
 
 using namespace std;
 using namespace cv;
 
+
+/* The features of all the contours of an image, held as a structure of arrays: element i of each array belongs to contour i.  */
+/* Each feature is computed once by extractFeatures(); drawFeatures() and writeFeatures() only read the table.                  */
+/* The areas are adjusted by half the perimeter because contourArea() underestimates the area of a pixel boundary.             */
+
+typedef struct {
+   int                      number_of_contours;
+   vector<unsigned char>    analysed;                 // perimeter > MIN_CONTOUR_LENGTH: the remaining features are valid
+   vector<int>              perimeter;                // number of contour points
+   vector<double>           contour_area;             // contourArea(), unadjusted
+   vector<double>           hole_area;                // adjusted area when the contour is a hole
+   vector<double>           object_area;              // adjusted area when the contour is an object, less the area of its holes
+   vector<RotatedRect>      bounding_rectangle;       // minimum area bounding rectangle
+   vector<float>            bounding_rectangle_area;  // adjusted
+   vector<vector<int> >     hull_indices;             // convex hull as indices of contour points
+   vector<vector<Point> >   hull;                     // the same convex hull as points
+   vector<double>           hull_area;                // adjusted
+   vector<vector<Vec4i> >   convexity_defects;
+   vector<int>              largest_convexity_depth;  // fixed point, 8 fractional bits, as in convexityDefects()
+   vector<Moments>          contour_moments;
+   vector<double>           hu_moments[NUMBER_OF_HU_MOMENTS];
+} featureTableType;
+
+
+/* the feature file of a batch, shared by the worker threads */
+
+typedef struct {
+   FILE  *fp_out;
+   Mutex  mutex;
+} featureBatchType;
+
+
 /* function prototypes go here */
 
 void featureExtraction(char *filename, FILE *fp_out);
+void extractFeatures(const vector<vector<Point> > &contours, const vector<Vec4i> &hierarchy, featureTableType &features);
+void drawFeatures(const vector<vector<Point> > &contours, const vector<Vec4i> &hierarchy, const featureTableType &features, Mat &contours_image);
+void writeFeatures(FILE *fp_out, char *filename, const vector<Vec4i> &hierarchy, const featureTableType &features);
+void extractImageFeatures(const Mat &inputImage, vector<vector<Point> > &contours, vector<Vec4i> &hierarchy, featureTableType &features);
+void tabulateFeatures(const char *filename, const vector<Vec4i> &hierarchy, const featureTableType &features, featureBlockType &block);
+bool featureExtractionBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
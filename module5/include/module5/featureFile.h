@@ -0,0 +1,89 @@
+/*
+  Binary feature files
+  --------------------
+
+  (This is the interface file: it contains the declarations of the functions that write and read binary feature files.
+  The functions are defined in featureFile.cpp, which is built as the featureFile library and linked by the
+  featureExtraction and featureFileToText applications.)
+
+  A feature file is a file header followed by any number of blocks, one block per image.  Each block holds one record
+  per object or hole, stored by column: all the ids, then all the parents, and so on, so that a reader can load a column
+  without parsing text.  A block is complete in itself: its header gives the number of records and the length of the
+  filename, so a reader can check that the block fits in the file before reading it.
+
+     file header:  magic "FEAT", version, number of columns                                 3 x uint32
+     block:        magic "FBLK", number of records n, filename length m                     3 x uint32
+                   filename                                                                 m x char
+                   id, parent, perimeter                                                    3 x n x int32
+                   area, bounding rectangle area, convex hull area, Hu moments 1 to 7      10 x n x double
+
+  The parent of an object is -1 and the parent of a hole is the id of the object that contains it.  Only the id,
+  parent, perimeter, and area of a hole are computed; its other columns are zero.
+  Values are written in the byte order of the machine that writes the file; the magic number is used to check it.
+
+  Audit Trail
+  --------------------
+  Created: writeFeatureFileHeader(), writeFeatureBlock(), readFeatureFileHeader(), readFeatureBlock(),
+  writeFeatureBlockText()
+  17 October 2026
+
+  A file is always written from the start: writeFeatureFileHeader() no longer appends to an existing file
+  17 October 2026
+
+  Added openFeatureFile(), which appends to an existing file after checking it
+  17 October 2026
+*/
+
+#ifndef FEATURE_FILE_H
+#define FEATURE_FILE_H
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define FEATURE_FILE_MAGIC         0x54414546   // "FEAT" in little-endian byte order
+#define FEATURE_BLOCK_MAGIC        0x4B4C4246   // "FBLK"
+#define FEATURE_FILE_VERSION       1
+#define FEATURE_INTEGER_COLUMNS    3            // id, parent, perimeter
+#define FEATURE_HU_MOMENTS         7
+#define FEATURE_REAL_COLUMNS       (3 + FEATURE_HU_MOMENTS)
+#define FEATURE_COLUMNS            (FEATURE_INTEGER_COLUMNS + FEATURE_REAL_COLUMNS)
+#define FEATURE_MAX_FILENAME       4096
+
+using namespace std;
+
+
+/* the records of one image, by column: element i of each column belongs to record i */
+
+typedef struct {
+   string          image_filename;
+   vector<int32_t> id;
+   vector<int32_t> parent;                        // -1 for an object
+   vector<int32_t> perimeter;
+   vector<double>  area;
+   vector<double>  bounding_rectangle_area;
+   vector<double>  hull_area;
+   vector<double>  hu_moments[FEATURE_HU_MOMENTS];
+} featureBlockType;
+
+
+/* function prototypes */
+
+void clearFeatureBlock(featureBlockType &block, const char *image_filename);
+void addFeatureRecord(featureBlockType &block, int id, int parent, int perimeter, double area,
+                      double bounding_rectangle_area, double hull_area, const double *hu_moments);
+int  numberOfFeatureRecords(const featureBlockType &block);
+
+FILE *openFeatureFile(const char *filename, bool append);    // "wb" and the file header, or "ab" to a checked file
+bool writeFeatureFileHeader(FILE *fp);
+bool writeFeatureBlock(FILE *fp, const featureBlockType &block);
+
+bool readFeatureFileHeader(FILE *fp, int *version);
+int  readFeatureBlock(FILE *fp, featureBlockType &block);      // 1: a block was read, 0: end of file, -1: error
+
+void writeFeatureBlockText(FILE *fp_out, const featureBlockType &block);
+
+#endif
@@ -0,0 +1,53 @@
+/* 
+  Convert a binary feature file to text
+  -------------------------------------
+ 
+  (This is the interface file: it contains the declarations of dedicated functions to implement the application.
+  These function are called by client code in the application file. The functions are defined in the implementation file.)
+
+  Audit Trail
+  --------------------
+  Created
+  17 October 2026
+*/
+ 
+
+
+#define GCC_COMPILER (defined(__GNUC__) && !defined(__clang__))
+
+#if GCC_COMPILER
+   #ifndef ROS
+       #define ROS
+   #endif
+   #ifndef ROS_PACKAGE_NAME
+      #define ROS_PACKAGE_NAME "module5"
+   #endif
+#endif
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <ctype.h>
+#include <iostream>
+#include <string>
+
+#include "module5/featureFile.h"
+
+#ifdef ROS
+   #include <ros/ros.h>
+   #include <ros/package.h>
+#endif 
+    
+ 
+
+#define TRUE  1
+#define FALSE 0
+#define MAX_STRING_LENGTH 80
+#define MAX_FILENAME_LENGTH 200
+
+using namespace std;
+
+/* function prototypes go here */
+
+int  featureFileToText(const char *feature_filename, const char *text_filename);
+void prompt_and_exit(int status);
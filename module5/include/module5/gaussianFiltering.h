@@ -11,6 +11,21 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Added gaussianFilter() with native FIR, IIR, and box-cascade implementations
+  17 October 2026
+
+  Added addGaussianNoise8U()
+  17 October 2026
+
+  Added the image_number argument of addGaussianNoise() and addGaussianNoise8U()
+  17 October 2026
+
+  Added addNoise(); addGaussianNoise() has its original arguments again
+  17 October 2026
+
+  Added gaussianFilteringBatch() for headless batch mode: included batchProcessing.h
+  17 October 2026
 */
 
 
@@ -28,9 +43,11 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "string.h"
+#include "math.h"
 #include <ctype.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #ifndef ROS
    #include <conio.h>
@@ -44,6 +61,7 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/batchProcessing.h"
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -59,13 +77,37 @@
 #define MAX_STRING_LENGTH   80
 #define MAX_FILENAME_LENGTH 200
 
+/* Gaussian filter implementations: see gaussianFilter() */
+
+#define GAUSSIAN_OPENCV            0
+#define GAUSSIAN_FIR               1
+#define GAUSSIAN_IIR               2
+#define GAUSSIAN_BOX               3
+#define GAUSSIAN_FIXED_POINT_BITS  14  // FIR kernel weights
+#define GAUSSIAN_BOX_PASSES        3   // box filters in the cascade
+
+/* noise generation: Philox-4x32-10 constants and the seed, the first word of the key; see addGaussianNoise8U() */
+
+#define PHILOX_M0   0xD2511F53u
+#define PHILOX_M1   0xCD9E8D57u
+#define PHILOX_W0   0x9E3779B9u
+#define PHILOX_W1   0xBB67AE85u
+#define NOISE_SEED  20171124u
+
 using namespace std;
 using namespace cv;
 
 /* function prototypes go here */
 
 void processNoiseAndAveraging(int, void*); 
+bool gaussianFilteringBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
+void addNoise(Mat &image, double average, double standard_deviation, unsigned int image_number);
 void addGaussianNoise(Mat &image, double average, double standard_deviation);
+void addGaussianNoise8U(Mat &image, double average, double standard_deviation, unsigned int seed, unsigned int image_number);
+void gaussianFilter(const Mat &src, Mat &dst, double sigma, int mode);
+void gaussianFIR(const Mat &src, Mat &dst, double sigma);
+void gaussianIIR(const Mat &src, Mat &dst, double sigma);
+void gaussianBoxCascade(const Mat &src, Mat &dst, double sigma);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
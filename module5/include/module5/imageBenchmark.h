@@ -0,0 +1,101 @@
+/*
+  Benchmark harness
+  -----------------
+
+  (This is the interface file of the harness shared by the node benchmarks, e.g. colourToHISBenchmark: the images
+  to time, the sizes to resize them to, and the timer.  It has no implementation file: everything is defined inline.
+  Include it after the header of the node, which defines ROS and ROS_PACKAGE_NAME when compiling for ROS.)
+
+  A benchmark is run as
+
+     <node>Benchmark [images]
+
+  where the images are relative to the data/Media directory; by default FruitStall.JPG, Smarties1.jpg,
+  and TrinityBikes1.JPG are used.  A benchmark resizes each image to the sizes in benchmark_sizes[], or to a size
+  of its own, times the node against a reference with shortestTime(), and returns 0 if the outputs agree and 1
+  otherwise, so that it can be run as a test.
+
+  Audit Trail
+  --------------------
+  Created: shortestTime(), numberOfBenchmarkImages(), benchmarkImageName(), readBenchmarkImage(),
+  extracted from colourToHISBenchmark, colourToGreyscaleBenchmark, binaryThresholdingBenchmark, and gaussianFilteringBenchmark
+  17 October 2026
+*/
+
+#ifndef IMAGE_BENCHMARK_H
+#define IMAGE_BENCHMARK_H
+
+#include "stdio.h"
+#include "string.h"
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+#ifdef ROS
+   #include <ros/package.h>
+#endif
+
+#define BENCHMARK_REPETITIONS      5
+#define BENCHMARK_MAX_FILENAME     1024
+#define NUMBER_OF_BENCHMARK_SIZES  ((int) (sizeof(benchmark_sizes) / sizeof(benchmark_sizes[0])))
+
+static const char     *benchmark_default_images[] = {"FruitStall.JPG", "Smarties1.jpg", "TrinityBikes1.JPG"};
+static const cv::Size  benchmark_sizes[]          = {cv::Size(640, 480), cv::Size(1920, 1080), cv::Size(3840, 2160)};
+
+
+/* shortest time of repetitions calls to function(), in ms */
+
+template <class F> double shortestTime(F function, int repetitions = BENCHMARK_REPETITIONS) {
+
+   double best_ms = 0;
+   double elapsed_ms;
+   int64  start_ticks;
+   int    i;
+
+   for (i = 0; i < repetitions; i++) {
+      start_ticks = cv::getTickCount();
+      function();
+      elapsed_ms = 1000.0 * (cv::getTickCount() - start_ticks) / cv::getTickFrequency();
+      if (i == 0 || elapsed_ms < best_ms) best_ms = elapsed_ms;
+   }
+   return best_ms;
+}
+
+
+/* the images given on the command line, or the default images if there are none */
+
+inline int numberOfBenchmarkImages(int argc, char **argv) {
+
+   return (argc > 1) ? argc - 1 : (int) (sizeof(benchmark_default_images) / sizeof(benchmark_default_images[0]));
+}
+
+inline const char *benchmarkImageName(int argc, char **argv, int i) {
+
+   return (argc > 1) ? argv[i + 1] : benchmark_default_images[i];
+}
+
+
+/* read image i from the data/Media directory in colour; false, with a message, if it can't be read */
+
+inline bool readBenchmarkImage(int argc, char **argv, int i, cv::Mat &image) {
+
+   char data_dir[BENCHMARK_MAX_FILENAME];
+
+   #ifdef ROS
+      strcpy(data_dir, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+   #else
+      strcpy(data_dir, "..");
+   #endif
+   strcat(data_dir, "/data/Media/");
+
+   std::string filename = std::string(data_dir) + benchmarkImageName(argc, argv, i);
+
+   image = cv::imread(filename, cv::IMREAD_COLOR);
+   if (image.empty()) {
+      printf("Error: failed to read image %s\n", filename.c_str());
+      return false;
+   }
+   return true;
+}
+
+#endif
@@ -8,6 +8,10 @@
 * David Vernon
 * 11 July 2024
 *
+* The Frame and Vector classes, the inverse kinematics, the servo-controller interface, and the robot configuration
+* are now taken from the al5d_core library in module4 instead of a copy in this package
+* 17 October 2026
+*
 ********************************************************************************************************************
 
 
@@ -91,181 +95,16 @@ namespace std {
 
 /***************************************************************************************************************************
 
-   Definitions for reading robot configuration data 
-
-****************************************************************************************************************************/
-
-#define MAX_FILENAME_LENGTH 200
-#define STRING_LENGTH 200
-#define KEY_LENGTH 20
-#define NUMBER_OF_KEYS 9
-typedef char keyword[KEY_LENGTH];
-    
-
-/***************************************************************************************************************************
-
-   Definitions for servo control 
-
-****************************************************************************************************************************/
-
-#define DEFAULT_SLEEP_TIME 5   
-#define COMMAND_SIZE 200
-#define MAX_SERVOS 32
-#define MIN_PW 750  //lowest pulse width
-#define MAX_PW 2250 //highest pulsewidth
-
-// working envelope in mm
-
-#define MIN_X -130
-#define MAX_X  130
-#define MIN_Y   80
-#define MAX_Y  330
-#define MIN_Z    0
-#define MAX_Z  380
-
-//#define MAX(x, y) (((x) > (y)) ? (x) : (y)) // commented out to avoid warning of conflict with previous definition DV 25/3/2021
-//#define MIN(x, y) (((x) < (y)) ? (x) : (y)) // ibid.
-
-/***************************************************************************************************************************
-
-   Frame and vector classes to support task-level robot programming 
-   ----------------------------------------------------------------
+   Frame and vector classes, inverse kinematics, servo control, and robot configuration
+   ------------------------------------------------------------------------------------
 
-   Interface to the Frame and Vector classes and auxilliary friend functions required to implement a robot control program
-   by specifying the position and orientation of objects and the robot manipulator using homogeneous transformations
-   
-   Author: David Vernon, Carnegie Mellon University Africa, Rwanda
-   Date:   22/02/2017
+   These are provided by the al5d_core library in module4, which is shared by all the robot nodes
+   See module4/include/module4/lynxmotionUtilities.h
 
 ****************************************************************************************************************************/
 
-#define MAX_MESSAGE_LENGTH 81
-
-class Vector {
-public:
-   Vector(double x=0, double y=0, double z=0, double w=1);
-   void setValues(double x, double y, double z, double w);
-   void getValues(double &x, double &y, double &z, double &w);
-   void printVector()const;
-   friend Vector operator+(Vector &a, Vector &b);
-   friend double dotProduct(Vector &a, Vector &b);
-private:
-   double coefficient[4];
-};
-
-
-class Frame {
-public:
-   Frame();
-   void printFrame()const;
-   Frame        &operator*(Frame const& h);
-   Frame        &operator=(Frame const& h);
-   friend Frame trans(float x, float y, float z);
-   friend Frame rotx(float theta);
-   friend Frame roty(float theta);
-   friend Frame rotz(float theta);
-   friend Frame inv(Frame h);
-   friend bool  move(Frame h);
-private:
-   double coefficient[4][4];
-};
-
-/* function prototypes */
-
-Vector operator+(Vector &a, Vector &b);
-double dotProduct(Vector &a, Vector &b);
-Frame trans(float x, float y, float z);
-Frame rotx(float theta);
-Frame roty(float theta);
-Frame rotz(float theta);
-Frame inv(Frame h);
-
-bool move(Frame T5);
-void grasp(int d);
-
-void wait(int ms);
-void prompt_and_exit(int status);
-void print_message_to_file(FILE *fp, char message[]);
-
-
-
-/****************************************************************************************************************************
-   Serial port interface 
-   ---------------------
-
-   Author: Victor Akinwande, Carnegie Mellon University Africa
-   Modified by: David Vernon, Carnegie Mellon University Africa
-
-****************************************************************************************************************************/
-
-/** 
- * set the positions of the servos connected to 
- * the controller to their default positions
- */ 
-
-void goHome();
-void sendToSerialPort(char *command);
-void executeCommand(int channel, int pos, int speed);                           // single servo motor
-void executeCommand(int * channel, int * pos, int speed, int number_of_servos); // multiple servo motors
-
-// Helper function prototypes
-void fail(char *message);
-
-
-/***************************************************************************************************************************
-
-   Inverse kinematics for LynxMotion AL5D robot manipulator
-
-*****************************************************************************************************************************/
-
-/* Kinematics: arm dimensions (mm) for AL5D arm */
-
-#define D1 70              // Base height to X/Y plane
-#define A3 146.0           // Shoulder-to-elbow "bone"
-#define A4 187.0           // Elbow-to-wrist "bone"
-#define EZ 100             // Gripper length
-#define GRIPPER_OPEN    30 // mm
-#define GRIPPER_CLOSED  0  // mm
-
-
-bool computeJointAngles(double x, double y, double z, double pitch, double roll, double joint_angles[]);
-bool setJointAngles(double joint_angles[]);
-bool computeServoPositions(double joint_angles[], int servo_positions[]);
-
-//int  gotoPose(float x, float y, float z, float pitch, float roll);
-
-void sig(int s);
-int  pose_within_working_env(float x, float y, float z);
-void display_error_and_exit(const char error_message[]);
-double degrees(double radians);
-double radians(double degrees);
-
-#ifdef ROS
-void jointStates(const sensor_msgs::JointState::ConstPtr& msg);
-#endif
-
-
-/***************************************************************************************************************************
-
-   Robot Configuration 
-
-****************************************************************************************************************************/
-  
-struct robotConfigurationDataType {
-   char  com[13];                     // USB com port ID on windows ... need to check this in the control panel > device manager or use the SSC-32 servo sequencer utility
-   int   baud;                        // Baud Rate
-   int   speed;                       // Servo speed
-   int   channel[6];                  // pin / channel numbers for each servo
-   int   home[6];                     // setpoint for home position of each servo
-   float degree[6];                   // pulse width per degree (in microseconds)
-   int   effector_x;                  // x offset of end-effector w.r.t.  T5
-   int   effector_y;                  // y offset of end-effector w.r.t.  T5
-   int   effector_z;                  // z offset of end-effector w.r.t.  T5
-   bool  lightweightWrist;            // one robot has a heavy duty wrist and it reverses the direction of the roll angle
-   float current_joint_value[6];      // Integrate the five joint angles wth the gripper distance to facilitate the constuction of the ROS topic message
-};
+#include <module4/lynxmotionUtilities.h>
 
-void readRobotConfigurationData(char filename[]);
 
 struct BrickPose
 {
@@ -292,5 +131,6 @@ void prompt_and_exit(int status);
 void prompt_and_continue();
 
 #ifdef ROS
+void pickAndPlace(float object_x,float object_y,float object_z, float object_phi, float destination_x, float destination_y, float destination_z, float destination_phi);
 void leave_field_of_view();
 #endif
@@ -0,0 +1,81 @@
+/*
+  Run-length encoded binary images
+  --------------------------------
+
+  (This is the interface file: it contains the declarations of the functions that create and process run-length encoded
+  binary images.  The functions are defined in runLengthEncoding.cpp, which is built as the runLengthEncoding library
+  and linked by the binaryThresholding, connectedComponents, contourExtraction, and featureExtraction applications.)
+
+  A binary image is represented by the horizontal runs of its foreground pixels, stored in raster order, and by the index
+  of the first run of each row.  A scene of a few objects on a plain background has a few runs per row, so an image of
+  this kind is typically 20 to 50 times smaller than the 8-bit Mat it replaces, and the functions that label, trace,
+  and measure the objects visit the runs instead of the pixels.
+
+  Audit Trail
+  --------------------
+  Created: thresholdToRuns(), binaryToRuns(), runsToBinary(), labelRuns(), runLabelsToImage(), traceContours(),
+  runMoments(); componentStatisticsType and labelRuns() were moved here from connectedComponents
+  17 October 2026
+*/
+
+#ifndef RUN_LENGTH_ENCODING_H
+#define RUN_LENGTH_ENCODING_H
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#define RLE_MIN_STRIPE_ROWS 16   // fewest image rows processed by one thread
+
+using namespace std;
+using namespace cv;
+
+
+/* a horizontal run of foreground pixels: columns start to end inclusive */
+
+typedef struct {
+   int start;
+   int end;
+} runType;
+
+
+/* a binary image: the runs of row r are runs[row_start[r]] ... runs[row_start[r+1] - 1], in order of column */
+
+typedef struct {
+   int rows;
+   int cols;
+   vector<runType> runs;
+   vector<int>     row_start;   // rows + 1 entries
+} runLengthImageType;
+
+
+/* statistics of one connected component, accumulated from its runs while labelling */
+
+typedef struct {
+   double area;                      // m00
+   int    left, top, right, bottom;  // bounding box, inclusive
+   double m10, m01;                  // first-order moments
+   double m20, m11, m02;             // second-order moments about the origin
+   double centroid_x, centroid_y;
+   double mu20, mu11, mu02;          // second-order central moments, as in cv::Moments
+} componentStatisticsType;
+
+
+/* function prototypes */
+
+void   thresholdToRuns(const Mat &greyscaleImage, int threshold, int type, runLengthImageType &rle);
+void   binaryToRuns(const Mat &binaryImage, runLengthImageType &rle);
+void   runsToBinary(const runLengthImageType &rle, Mat &binaryImage);
+void   complementRuns(const runLengthImageType &rle, runLengthImageType &complement);
+bool   runPixel(const runLengthImageType &rle, int row, int col);
+double runCompression(const runLengthImageType &rle);
+int    labelRuns(const runLengthImageType &rle, int connectivity, vector<int> &run_label,
+                 vector<componentStatisticsType> *statistics = NULL);
+void   runLabelsToImage(const runLengthImageType &rle, const vector<int> &run_label, Mat &labels);
+void   traceContours(const runLengthImageType &rle, vector<vector<Point> > &contours, vector<Vec4i> &hierarchy);
+void   runMoments(const runLengthImageType &rle, const vector<int> &run_label, int number_of_labels, vector<Moments> &moments);
+
+#endif
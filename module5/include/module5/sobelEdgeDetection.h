@@ -11,6 +11,12 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Added sobelFused()
+  17 October 2026
+
+  Added sobelEdgeDetectionBatch() for headless batch mode: included batchProcessing.h
+  17 October 2026
 */
 
 
@@ -28,9 +34,11 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "string.h"
+#include "math.h"
 #include <ctype.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #ifndef ROS
    #include <conio.h>
@@ -44,6 +52,7 @@
 //opencv
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include "module5/batchProcessing.h"
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -61,12 +70,20 @@
 #define MAX_FILENAME_LENGTH 200
 #define PI 3.14159
 
+/* gradient magnitude: see sobelFused() */
+
+#define SOBEL_L1                  0    // |gx| + |gy|
+#define SOBEL_L2                  1    // sqrt(gx^2 + gy^2)
+#define SOBEL_ORIENTATION_LEVELS  255  // grey level of an orientation of 2 pi
+
 using namespace std;
 using namespace cv;
 
 /* function prototypes go here */
 
 void sobelEdgeDetection(int, void*); 
+bool sobelEdgeDetectionBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context);
+int  sobelFused(const Mat &grey, Mat &magnitude, Mat &orientation, Mat &edges, int threshold, int norm);
 Mat convert_32bit_image_for_display(Mat& passed_image, double zero_maps_to=0.0, double passed_scale_factor=-1.0 );
 void prompt_and_exit(int status);
 void prompt_and_continue();
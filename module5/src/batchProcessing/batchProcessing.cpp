@@ -0,0 +1,335 @@
+/*
+  Headless batch processing
+  -------------------------
+
+  (This is the implementation file: it contains the code for the functions that run the core of a module5 application
+  over a batch of images.  The functions are declared in the interface file batchProcessing.h.)
+
+  Audit Trail
+  --------------------
+  Created: isBatchMode(), getBatchOptions(), runBatch()
+  17 October 2026
+
+  The list of images is read a line at a time, so filenames may contain spaces; images with the same name have the 
+  number of the image added to their output stems so that their results do not overwrite each other
+  17 October 2026
+
+  The worker catches the exceptions thrown while an image is read or processed, reports the image, and counts it
+  as failed: an exception escaping a worker thread would terminate the whole batch
+  17 October 2026
+*/
+
+#include "module5/batchProcessing.h"
+
+#include <ctype.h>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <set>
+#include <thread>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+   #include <direct.h>
+   #define makeDirectory(path) _mkdir(path)
+#else
+   #define makeDirectory(path) mkdir(path, 0755)
+#endif
+
+
+static bool isDirectory(const char *path) {
+
+   struct stat status;
+
+   return stat(path, &status) == 0 && (status.st_mode & S_IFMT) == S_IFDIR;
+}
+
+
+/* true if the filename has the extension of an image format that imread() reads */
+
+static bool isImageFilename(const string &filename) {
+
+   const char *extensions[] = {".png", ".jpg", ".jpeg", ".bmp", ".tif", ".tiff", ".pgm", ".ppm", ".pbm", ".webp"};
+   size_t dot = filename.find_last_of('.');
+   string extension;
+   size_t i;
+
+   if (dot == string::npos) return false;
+
+   for (i = dot; i < filename.size(); i++) {
+      extension += (char) tolower(filename[i]);
+   }
+
+   for (i = 0; i < sizeof(extensions) / sizeof(extensions[0]); i++) {
+      if (extension == extensions[i]) return true;
+   }
+   return false;
+}
+
+
+/* the list of images: the image files in a directory, or the filenames in a text file */
+
+static bool listImages(const char *input, vector<string> &image_filenames) {
+
+   ifstream list_in;
+   string filename;
+   string list_directory;
+   vector<string> directory_files;
+   size_t i;
+
+   image_filenames.clear();
+
+   if (isDirectory(input)) {
+      glob(string(input) + "/*", directory_files, false);   // sorted
+      for (i = 0; i < directory_files.size(); i++) {
+         if (isImageFilename(directory_files[i])) image_filenames.push_back(directory_files[i]);
+      }
+      return true;
+   }
+
+   list_in.open(input);
+   if (!list_in.is_open()) {
+      printf("Error can't open the list of images %s\n", input);
+      return false;
+   }
+
+   list_directory = input;
+   i = list_directory.find_last_of("/\\");
+   list_directory = (i == string::npos) ? "" : list_directory.substr(0, i + 1);
+
+   /* one filename per line, which may contain spaces; leading and trailing white space and blank lines are ignored */
+
+   while (getline(list_in, filename)) {
+      size_t first = filename.find_first_not_of(" \t\r");
+      if (first == string::npos) continue;
+      filename = filename.substr(first, filename.find_last_not_of(" \t\r") - first + 1);
+
+      if (filename.find_first_of("/\\") != string::npos) image_filenames.push_back(filename);
+      else                                                  image_filenames.push_back(list_directory + filename);
+   }
+
+   return true;
+}
+
+
+/* the name of the image without its path or extension */
+
+static string imageName(const string &image_filename) {
+
+   size_t slash = image_filename.find_last_of("/\\");
+   string name  = (slash == string::npos) ? image_filename : image_filename.substr(slash + 1);
+   size_t dot   = name.find_last_of('.');
+
+   if (dot != string::npos && dot > 0) name = name.substr(0, dot);
+
+   return name;
+}
+
+
+/* the output stem of each image: the output directory followed by the name of the image
+
+   Images in different directories, or with different extensions, can have the same name; each of them has _<n> 
+   added to its name, where n is the number of the image in the list counting from 1 (with further _<n> if that 
+   name is also taken), so that no two images share an output stem
+*/
+
+static void outputStems(const char *output_directory, const vector<string> &image_filenames, vector<string> &stems) {
+
+   map<string, int> name_count;
+   set<string>      used;
+   vector<string>   names(image_filenames.size());
+   string           name;
+   size_t i;
+
+   for (i = 0; i < image_filenames.size(); i++) {
+      names[i] = imageName(image_filenames[i]);
+      name_count[names[i]]++;
+      used.insert(names[i]);
+   }
+
+   stems.resize(image_filenames.size());
+
+   for (i = 0; i < image_filenames.size(); i++) {
+      name = names[i];
+      if (name_count[names[i]] > 1) {
+         do {
+            name += "_" + to_string(i + 1);
+         } while (used.count(name) > 0);
+         used.insert(name);
+      }
+      stems[i] = string(output_directory) + "/" + name;
+   }
+}
+
+
+/* isBatchMode()
+
+   true if the application was started with --batch
+*/
+
+bool isBatchMode(int argc, char **argv) {
+
+   return argc > 1 && strcmp(argv[1], BATCH_FLAG) == 0;
+}
+
+
+/* getBatchOptions()
+
+   Read the arguments that follow --batch and create the output directory if it does not exist;
+   false, after printing the usage, if the arguments are incomplete
+*/
+
+bool getBatchOptions(int argc, char **argv, batchOptionsType *options) {
+
+   unsigned int hardware_threads = thread::hardware_concurrency();
+
+   if (argc < 4 || strlen(argv[2]) >= BATCH_MAX_FILENAME || strlen(argv[3]) >= BATCH_MAX_FILENAME) {
+      printf("Usage: %s %s <image directory | file of image filenames> <output directory> [number of threads]\n",
+             argc > 0 ? argv[0] : "application", BATCH_FLAG);
+      return false;
+   }
+
+   strcpy(options->input, argv[2]);
+   strcpy(options->output_directory, argv[3]);
+
+   options->number_of_threads = (argc > 4) ? atoi(argv[4]) : (int) hardware_threads;
+   if (options->number_of_threads < 1)                 options->number_of_threads = 1;
+   if (options->number_of_threads > BATCH_MAX_THREADS) options->number_of_threads = BATCH_MAX_THREADS;
+
+   if (!isDirectory(options->output_directory) && makeDirectory(options->output_directory) != 0) {
+      printf("Error can't create the output directory %s\n", options->output_directory);
+      return false;
+   }
+
+   return true;
+}
+
+
+/* runBatch()
+
+   Apply function to every image of the batch on a pool of options.number_of_threads threads,
+   write the timings, and print a summary; returns 0 if every image was processed and 1 otherwise,
+   so that it can be returned from main()
+*/
+
+int runBatch(const batchOptionsType &options, const char *application_name, int imread_flags,
+             batchFunctionType function, void *context) {
+
+   vector<string> image_filenames;
+   vector<string> output_stems;
+   vector<double> read_ms;
+   vector<double> process_ms;
+   vector<unsigned char> processed;
+   vector<thread> workers;
+   atomic<int>    next_image(0);
+   int    number_of_images;
+   int    number_of_threads;
+   int    number_processed = 0;
+   int    opencv_threads;
+   double total_process_ms = 0;
+   double elapsed_s;
+   int64  start_ticks;
+   char   timings_filename[BATCH_MAX_FILENAME * 2];
+   FILE  *fp_timings;
+   int    i, w;
+
+   if (!listImages(options.input, image_filenames)) return 1;
+
+   outputStems(options.output_directory, image_filenames, output_stems);
+
+   number_of_images  = (int) image_filenames.size();
+   number_of_threads = min(options.number_of_threads, max(number_of_images, 1));
+
+   read_ms.assign(number_of_images, 0);
+   process_ms.assign(number_of_images, 0);
+   processed.assign(number_of_images, 0);
+
+   printf("%s: processing %d images with %d threads\n", application_name, number_of_images, number_of_threads);
+
+   opencv_threads = getNumThreads();
+   if (number_of_threads > 1) setNumThreads(1);
+
+   start_ticks = getTickCount();
+
+   for (w = 0; w < number_of_threads; w++) {
+      workers.push_back(thread([&, w]() {
+
+         int    image_number;
+         int64  ticks;
+         Mat    image;
+
+         while ((image_number = next_image++) < number_of_images) {
+
+            const string &image_filename = image_filenames[image_number];
+
+            try {
+               ticks = getTickCount();
+               image = imread(image_filename, imread_flags);
+               read_ms[image_number] = 1000.0 * (getTickCount() - ticks) / getTickFrequency();
+
+               if (image.empty()) {
+                  printf("Error: failed to read image %s\n", image_filename.c_str());
+                  continue;
+               }
+
+               ticks = getTickCount();
+               processed[image_number] = function(image, image_filename.c_str(), output_stems[image_number].c_str(), w, context);
+               process_ms[image_number] = 1000.0 * (getTickCount() - ticks) / getTickFrequency();
+            }
+            catch (const cv::Exception &e) {
+               printf("Error: OpenCV error processing image %s: %s\n", image_filename.c_str(), e.what());
+               processed[image_number] = 0;
+            }
+            catch (const std::exception &e) {
+               printf("Error: exception processing image %s: %s\n", image_filename.c_str(), e.what());
+               processed[image_number] = 0;
+            }
+            catch (...) {
+               printf("Error: unknown exception processing image %s\n", image_filename.c_str());
+               processed[image_number] = 0;
+            }
+         }
+      }));
+   }
+
+   for (w = 0; w < number_of_threads; w++) {
+      workers[w].join();
+   }
+
+   elapsed_s = (getTickCount() - start_ticks) / getTickFrequency();
+
+   setNumThreads(opencv_threads);
+
+
+   /* timings, in the order of the list of images */
+
+   sprintf(timings_filename, "%s/%sTimings.txt", options.output_directory, application_name);
+
+   if ((fp_timings = fopen(timings_filename, "w")) == 0) {
+      printf("Error can't open output %s\n", timings_filename);
+   }
+   else {
+      fprintf(fp_timings, "%-40s %10s %10s %s\n", "image", "read_ms", "process_ms", "status");
+      for (i = 0; i < number_of_images; i++) {
+         fprintf(fp_timings, "%-40s %10.2f %10.2f %s\n", image_filenames[i].c_str(), read_ms[i], process_ms[i],
+                 processed[i] ? "ok" : "failed");
+      }
+      fclose(fp_timings);
+   }
+
+   for (i = 0; i < number_of_images; i++) {
+      if (processed[i]) {
+         number_processed++;
+         total_process_ms += process_ms[i];
+      }
+   }
+
+   printf("%s: %d of %d images processed in %.2f s (%.1f images/s, %.2f ms per image per thread); timings in %s\n",
+          application_name, number_processed, number_of_images, elapsed_s,
+          elapsed_s > 0 ? number_processed / elapsed_s : 0.0,
+          number_processed > 0 ? total_process_ms / number_processed : 0.0,
+          timings_filename);
+
+   return number_processed == number_of_images ? 0 : 1;
+}
@@ -23,6 +23,12 @@
   Ported to Ubuntu 16.04 and OpenCV 3.3
   Abrham Gebreselasie
   10 March 2021
+
+  Greyscale image and foreground counts computed once per input image with prepareThresholding()
+  17 October 2026
+
+  Headless batch mode: binaryThresholding --batch <images> <output directory> [number of threads]
+  17 October 2026
   
 
 */
@@ -33,13 +39,24 @@
 // Global variables to allow access by the display window callback functions
 
 Mat inputImage;
+Mat greyscaleImage;                                   // computed once per input image by prepareThresholding()
+long foregroundCount[NUMBER_OF_GREY_LEVELS + 1];      // number of pixels >= each threshold
 int thresholdValue            = 128; // default threshold
 
 const char* input_window_name       = "Input Image";
 const char* thresholded_window_name = "Thresholded Image";
 
 
-int main() {
+int main(int argc, char **argv) {
+
+   /* headless batch mode: see batchProcessing.h */
+
+   batchOptionsType batch_options;
+
+   if (isBatchMode(argc, argv)) {
+      if (!getBatchOptions(argc, argv, &batch_options)) return 1;
+      return runBatch(batch_options, "binaryThresholding", IMREAD_UNCHANGED, binaryThresholdingBatch, NULL);
+   }
    
    #ifdef ROS
       // Turn off canonical terminal mode and character echoing
@@ -98,6 +115,8 @@ int main() {
             prompt_and_exit(-1);
          }
           
+         prepareThresholding(inputImage, greyscaleImage, foregroundCount);
+
          printf("Press any key to continue ...\n");
 
          // Create a window for input and display it
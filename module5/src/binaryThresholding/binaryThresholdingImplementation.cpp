@@ -12,27 +12,49 @@
   --------------------
   Added _kbhit
   18 February 2021
+
+  The greyscale image and its histogram are now computed once per input image by prepareThresholding() rather 
+  than on every trackbar event; the trackbar callback applies a branch-free threshold with row pointers and 
+  reports the foreground count from the cumulative histogram
+  17 October 2026
+
+  The foreground count is shown in the title of the thresholded image window rather than printed on every trackbar event
+  17 October 2026
+
+  The row loop of thresholdImage() is now thresholdRow(), with __restrict rows, so that it is vectorised
+  17 October 2026
+
+  The thresholded image is also run-length encoded; the number of runs and the compression are shown in the title
+  17 October 2026
+
+  The trackbar callback no longer run-length encodes the thresholded image: it was a second pass over the image on 
+  every event only to report the number of runs; the run-length encoding belongs to the nodes that use the runs
+  17 October 2026
+
+  Added binaryThresholdingBatch(): the core of the application for headless batch mode
+  17 October 2026
+
+  binaryThresholdingBatch() rejects an image that is not 8-bit greyscale or colour instead of failing the assertion
+  in prepareThresholding()
+  17 October 2026
     
 */
  
 #include "module5/binaryThresholding.h"
 
 /*
- * function binaryThresholding
- * Trackbar callback - threshold user input
+ * function prepareThresholding
+ * Convert the input image to greyscale and build the cumulative histogram used to report the foreground count.
+ * Called once for each input image, before the trackbar is created.
+ *
+ * foregroundCount[t] is the number of pixels with grey-level >= t, i.e. the number of foreground pixels for threshold t
 */
 
-void binaryThresholding(int, void*) {  
+void prepareThresholding(const Mat &inputImage, Mat &greyscaleImage, long foregroundCount[]) {
 
-   extern Mat inputImage; 
-   extern int thresholdValue; 
-   extern char* thresholded_window_name;
-   Mat greyscaleImage;
-   Mat thresholdedImage; 
+   long histogram[NUMBER_OF_GREY_LEVELS] = {0};
    int row, col;
-
-   if (thresholdValue < 1)  // the trackbar has a lower value of 0 which is invalid
-      thresholdValue = 1;
+   int t;
 
    if (inputImage.type() == CV_8UC3) { // colour image
       cvtColor(inputImage, greyscaleImage, COLOR_BGR2GRAY);
@@ -41,27 +63,116 @@ void binaryThresholding(int, void*) {
       greyscaleImage = inputImage.clone();
    }
 
-   thresholdedImage.create(greyscaleImage.size(), CV_8UC1);
-   
+   CV_Assert(greyscaleImage.type() == CV_8UC1);
+
    for (row=0; row < greyscaleImage.rows; row++) {
+      const unsigned char *p_grey = greyscaleImage.ptr<unsigned char>(row);
       for (col=0; col < greyscaleImage.cols; col++) {
-         if(greyscaleImage.at<uchar>(row,col) < thresholdValue) {
-            thresholdedImage.at<uchar>(row,col) = (uchar) 0;
-         }
-         else {
-            thresholdedImage.at<uchar>(row,col) = (uchar) 255;
-         }
+         histogram[p_grey[col]]++;
       }
    }
-   
+
+   foregroundCount[NUMBER_OF_GREY_LEVELS] = 0;
+   for (t=NUMBER_OF_GREY_LEVELS-1; t >= 0; t--) {
+      foregroundCount[t] = foregroundCount[t+1] + histogram[t];
+   }
+}
+
+
+/*
+ * function thresholdRow
+ * Binary threshold of one row: 255 where grey-level >= threshold, 0 otherwise
+ * The comparison result is turned into a mask rather than a branch, and the rows are declared __restrict so that the 
+ * compiler does not have to allow for the output overlapping the input, which would stop it vectorising the loop
+*/
+
+static void thresholdRow(const unsigned char * __restrict p_grey, unsigned char * __restrict p_thresholded, int cols, int threshold) {
+
+   int col;
+
+   for (col=0; col < cols; col++) {
+      p_thresholded[col] = (unsigned char) -(p_grey[col] >= threshold);
+   }
+}
+
+
+/*
+ * function thresholdImage
+ * Binary threshold: 255 where grey-level >= threshold, 0 otherwise; the rows are split across threads
+*/
+
+void thresholdImage(const Mat &greyscaleImage, Mat &thresholdedImage, int threshold) {
+
+   thresholdedImage.create(greyscaleImage.size(), CV_8UC1);
+
+   parallel_for_(Range(0, greyscaleImage.rows), [&](const Range &range) {
+      int row;
+      for (row=range.start; row < range.end; row++) {
+         thresholdRow(greyscaleImage.ptr<unsigned char>(row), thresholdedImage.ptr<unsigned char>(row), greyscaleImage.cols, threshold);
+      }
+   });
+}
+
+
+/*
+ * function binaryThresholding
+ * Trackbar callback - threshold user input
+*/
+
+void binaryThresholding(int, void*) {  
+
+   extern Mat greyscaleImage; 
+   extern long foregroundCount[]; 
+   extern int thresholdValue; 
+   extern const char* thresholded_window_name;
+   static Mat thresholdedImage;   // kept between calls so that the buffer is only allocated when the image size changes
+   long numberOfPixels;
+   char title[MAX_STRING_LENGTH * 3];
+
+   if (thresholdValue < 1)  // the trackbar has a lower value of 0 which is invalid
+      thresholdValue = 1;
+
+   thresholdImage(greyscaleImage, thresholdedImage, thresholdValue);
+
    /* alternatively, use OpenCV */
 
-   // threshold(greyscaleImage,thresholdedImage,thresholdValue, 255,THRESH_BINARY);
+   // threshold(greyscaleImage,thresholdedImage,thresholdValue-1, 255,THRESH_BINARY);
    // threshold(greyscaleImage,thresholdedImage,thresholdValue, 255,THRESH_BINARY  | THRESH_OTSU); // automatic threshold selection
  
+   numberOfPixels = foregroundCount[0];
+   snprintf(title, sizeof(title), "%s: threshold %d, %ld foreground pixels (%.1f%%)", thresholded_window_name,
+            thresholdValue, foregroundCount[thresholdValue], numberOfPixels > 0 ? 100.0 * foregroundCount[thresholdValue] / numberOfPixels : 0.0);
+   setWindowTitle(thresholded_window_name, title);
+
    imshow(thresholded_window_name, thresholdedImage);
 }
 
+
+/*
+ * binaryThresholdingBatch
+ * Batch mode: threshold the image at the default threshold and write <output_stem>_thresholded.png
+ */
+
+bool binaryThresholdingBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   extern int thresholdValue; 
+
+   Mat greyscale_image;
+   Mat thresholded_image;
+   long foreground_count[NUMBER_OF_GREY_LEVELS + 1];
+
+   if (image.type() != CV_8UC3 && image.type() != CV_8UC1) { // prepareThresholding() asserts an 8-bit image
+      printf("Error: %s is not an 8-bit greyscale or colour image\n", image_filename);
+      return false;
+   }
+
+   prepareThresholding(image, greyscale_image, foreground_count);
+   thresholdImage(greyscale_image, thresholded_image, max(thresholdValue, 1));
+
+   return imwrite(string(output_stem) + "_thresholded.png", thresholded_image);
+}
+
+
 void prompt_and_exit(int status) {
    printf("Press any key to continue and close terminal ... \n");
    getchar();
@@ -0,0 +1,129 @@
+/*
+  Benchmark of binary thresholding with incremental trackbar updates
+  ------------------------------------------------------------------
+
+  Simulates a trackbar drag from threshold 1 to 255 on images from the data/Media directory resized to 640 x 480,
+  1920 x 1080, and 3840 x 2160, and times one trackbar event, without the display, in two ways:
+
+  - reference: the original callback, reproduced below: cvtColor on the whole input, then a per-pixel if through at<uchar>()
+  - current:   the work that binaryThresholding() now does per event: thresholdImage() on the greyscale image cached by
+               prepareThresholding() and the foreground count read from the cumulative histogram
+
+  For every threshold the two thresholded images must be identical and the foreground count must equal the number
+  of non-zero pixels.  The mean time per event is reported with the corresponding event rate; an event rate of at
+  least TARGET_EVENTS_PER_SECOND is needed for a smooth drag.
+
+  The images are given on the command line, relative to data/Media (see module5/imageBenchmark.h).
+
+  The exit status is 0 if the outputs agree for every image, size, and threshold and 1 otherwise.
+
+  Audit Trail
+  --------------------
+  17 October 2026: created
+*/
+
+#include "module5/binaryThresholding.h"
+#include "module5/imageBenchmark.h"
+
+#define TARGET_EVENTS_PER_SECOND 60
+
+/* globals used by the trackbar callback in binaryThresholdingImplementation.cpp; the benchmark does not call it */
+
+Mat greyscaleImage;
+long foregroundCount[NUMBER_OF_GREY_LEVELS + 1];
+int thresholdValue = 128;
+const char* thresholded_window_name = "Thresholded Image";
+
+
+/* the original trackbar callback without the display */
+
+static void referenceThresholding(const Mat &inputImage, Mat &thresholdedImage, int thresholdValue) {
+
+   Mat greyscaleImage;
+   int row, col;
+
+   if (inputImage.type() == CV_8UC3) { // colour image
+      cvtColor(inputImage, greyscaleImage, COLOR_BGR2GRAY);
+   }
+   else {
+      greyscaleImage = inputImage.clone();
+   }
+
+   thresholdedImage.create(greyscaleImage.size(), CV_8UC1);
+
+   for (row=0; row < greyscaleImage.rows; row++) {
+      for (col=0; col < greyscaleImage.cols; col++) {
+         if(greyscaleImage.at<uchar>(row,col) < thresholdValue) {
+            thresholdedImage.at<uchar>(row,col) = (uchar) 0;
+         }
+         else {
+            thresholdedImage.at<uchar>(row,col) = (uchar) 255;
+         }
+      }
+   }
+}
+
+
+int main(int argc, char **argv) {
+
+   int  number_of_images = numberOfBenchmarkImages(argc, argv);
+   int  i, k, t;
+   int  number_of_events = NUMBER_OF_GREY_LEVELS - 1;
+   int  mismatches;
+   bool passed = true;
+
+   Mat original, inputImage;
+   Mat referenceImage, thresholdedImage;
+   long count;
+   int64 start_ticks;
+   double reference_ms, current_ms, prepare_ms;
+
+   printf("%-20s %11s %12s %14s %14s %12s %s\n", "image", "size", "prepare ms", "reference ms", "current ms", "events/s", "mismatches");
+
+   for (i = 0; i < number_of_images; i++) {
+
+      if (!readBenchmarkImage(argc, argv, i, original)) {
+         return 1;
+      }
+
+      for (k = 0; k < NUMBER_OF_BENCHMARK_SIZES; k++) {
+
+         resize(original, inputImage, benchmark_sizes[k], 0, 0, INTER_LINEAR);
+
+         start_ticks = getTickCount();
+         prepareThresholding(inputImage, greyscaleImage, foregroundCount);
+         prepare_ms = 1000.0 * (getTickCount() - start_ticks) / getTickFrequency();
+
+         reference_ms = 0;
+         current_ms   = 0;
+         mismatches   = 0;
+
+         for (t = 1; t < NUMBER_OF_GREY_LEVELS; t++) {
+
+            start_ticks = getTickCount();
+            referenceThresholding(inputImage, referenceImage, t);
+            reference_ms += 1000.0 * (getTickCount() - start_ticks) / getTickFrequency();
+
+            start_ticks = getTickCount();
+            thresholdImage(greyscaleImage, thresholdedImage, t);
+            count = foregroundCount[t];
+            current_ms += 1000.0 * (getTickCount() - start_ticks) / getTickFrequency();
+
+            if (norm(referenceImage, thresholdedImage, NORM_INF) != 0 || count != countNonZero(thresholdedImage)) {
+               mismatches++;
+            }
+         }
+
+         reference_ms /= number_of_events;
+         current_ms   /= number_of_events;
+         passed = passed && mismatches == 0;
+
+         printf("%-20s %5d x %4d %12.2f %14.2f %14.2f %12.0f %d%s\n", benchmarkImageName(argc, argv, i),
+                inputImage.cols, inputImage.rows, prepare_ms, reference_ms, current_ms, 1000.0 / current_ms, mismatches,
+                1000.0 / current_ms < TARGET_EVENTS_PER_SECOND ? " (below the target event rate)" : "");
+      }
+   }
+
+   printf(passed ? "binaryThresholdingBenchmark: passed\n" : "binaryThresholdingBenchmark: FAILED\n");
+   return passed ? 0 : 1;
+}
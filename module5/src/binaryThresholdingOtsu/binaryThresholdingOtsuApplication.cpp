@@ -23,13 +23,25 @@
   Ported to Ubuntu 16.04 and OpenCV 3.3
   Abrham Gebreselasie
   10 March 2021
+
+  Headless batch mode: binaryThresholdingOtsu --batch <images> <output directory> [number of threads]
+  17 October 2026
   
 
 */
 
 #include "module5/binaryThresholdingOtsu.h"
 
-int main() {
+int main(int argc, char **argv) {
+
+   /* headless batch mode: see batchProcessing.h */
+
+   batchOptionsType batch_options;
+
+   if (isBatchMode(argc, argv)) {
+      if (!getBatchOptions(argc, argv, &batch_options)) return 1;
+      return runBatch(batch_options, "binaryThresholdingOtsu", IMREAD_UNCHANGED, binaryThresholdingOtsuBatch, NULL);
+   }
    
    #ifdef ROS
       // Turn off canonical terminal mode and character echoing
@@ -12,6 +12,19 @@
   --------------------
   Added _kbhit
   18 February 2021
+
+  Replaced the call to OpenCV threshold() with a native Otsu engine: parallel partial histograms, 
+  multi-level Otsu (up to OTSU_MAX_THRESHOLDS thresholds) from cumulative moment tables, and a tiled (local) 
+  Otsu threshold for unevenly lit scenes
+  17 October 2026
+
+  localOtsuThreshold() takes the image histogram rather than computing it again, and interpolates the tile
+  thresholds between the centres of the pixels each tile covers, so that partial tiles at the right and bottom
+  edges are handled correctly; the thresholds are shown in the window titles rather than printed
+  17 October 2026
+
+  Added binaryThresholdingOtsuBatch(): the core of the application for headless batch mode
+  17 October 2026
     
 */
  
@@ -22,11 +35,19 @@ void binaryThresholdingOtsu(char *filename) {
    Mat inputImage;
    Mat greyscaleImage;
    Mat thresholdedImage; 
+   Mat multilevelImage; 
+   Mat localImage; 
 
-   int thresholdValue            = 128; // default threshold
+   long histogram[NUMBER_OF_GREY_LEVELS];
+   int thresholds[OTSU_MAX_THRESHOLDS];
+   int i;
+   int length;
+   char title[MAX_STRING_LENGTH * 2];
 
    const char* input_window_name       = "Input Image";
    const char* thresholded_window_name = "Thresholded Image";
+   const char* multilevel_window_name  = "Multi-level Otsu Image";
+   const char* local_window_name       = "Local Otsu Image";
  
    inputImage = imread(filename, IMREAD_UNCHANGED);
    if (inputImage.empty()) {
@@ -40,8 +61,10 @@ void binaryThresholdingOtsu(char *filename) {
    namedWindow(input_window_name, WINDOW_AUTOSIZE );
    imshow(input_window_name, inputImage);
   
-   // Create a window for thresholded image
+   // Create windows for the thresholded images
    namedWindow(thresholded_window_name, WINDOW_AUTOSIZE );
+   namedWindow(multilevel_window_name,  WINDOW_AUTOSIZE );
+   namedWindow(local_window_name,       WINDOW_AUTOSIZE );
  
    if (inputImage.type() == CV_8UC3) { // colour image
       cvtColor(inputImage, greyscaleImage, COLOR_BGR2GRAY);
@@ -50,11 +73,39 @@ void binaryThresholdingOtsu(char *filename) {
       greyscaleImage = inputImage.clone();
    }
 
-   //thresholdedImage.create(greyscaleImage.size(), CV_8UC1);
+   CV_Assert(greyscaleImage.type() == CV_8UC1);
+
+   // the histogram is built once and used for both the global and the multi-level thresholds
+
+   computeHistogram(greyscaleImage, histogram);
+
+
+   // global threshold: same result as threshold(greyscaleImage, thresholdedImage, 0, 255, THRESH_BINARY | THRESH_OTSU)
+
+   otsuThresholds(histogram, 1, thresholds);
+   applyThresholds(greyscaleImage, thresholdedImage, thresholds, 1);
+   snprintf(title, sizeof(title), "%s: Otsu threshold %d", thresholded_window_name, thresholds[0]);
+   setWindowTitle(thresholded_window_name, title);
+
+
+   // multi-level: OTSU_NUMBER_OF_THRESHOLDS + 1 classes displayed as evenly spaced grey-levels
 
-   threshold(greyscaleImage,thresholdedImage,thresholdValue, 255,THRESH_BINARY  | THRESH_OTSU); // automatic threshold selection
+   otsuThresholds(histogram, OTSU_NUMBER_OF_THRESHOLDS, thresholds);
+   applyThresholds(greyscaleImage, multilevelImage, thresholds, OTSU_NUMBER_OF_THRESHOLDS);
+   length = snprintf(title, sizeof(title), "%s: thresholds", multilevel_window_name);
+   for (i=0; i<OTSU_NUMBER_OF_THRESHOLDS; i++) {
+      length += snprintf(title + length, sizeof(title) - length, " %d", thresholds[i]);
+   }
+   setWindowTitle(multilevel_window_name, title);
+
+
+   // local: one threshold per tile, interpolated between tile centres; the global histogram gives the threshold for flat tiles
+
+   localOtsuThreshold(greyscaleImage, histogram, localImage, OTSU_TILE_SIZE);
  
    imshow(thresholded_window_name, thresholdedImage);
+   imshow(multilevel_window_name,  multilevelImage);
+   imshow(local_window_name,       localImage);
          
    do {
       waitKey(30);                                  // Must call this to allow openCV to display the images
@@ -65,8 +116,393 @@ void binaryThresholdingOtsu(char *filename) {
 
    destroyWindow(input_window_name);  
    destroyWindow(thresholded_window_name); 
+   destroyWindow(multilevel_window_name); 
+   destroyWindow(local_window_name); 
+}
+
+
+/*=======================================================*/
+/* Otsu engine                                           */ 
+/*=======================================================*/
+
+/* histogramRows()
+
+   Accumulate the histogram of rows [start, end) of a CV_8UC1 image
+   Four sub-histograms are used in turn so that runs of equal grey-levels do not serialise on one counter;
+   they are summed at the end
+*/
+
+static void histogramRows(const Mat &greyscaleImage, int start, int end, long histogram[]) {
+
+   unsigned int sub_histogram[4][NUMBER_OF_GREY_LEVELS] = {{0}};
+   int row, col;
+   int i;
+
+   for (row = start; row < end; row++) {
+
+      const unsigned char *p_grey = greyscaleImage.ptr<unsigned char>(row);
+
+      for (col = 0; col + 4 <= greyscaleImage.cols; col += 4) {
+         sub_histogram[0][p_grey[col]]++;
+         sub_histogram[1][p_grey[col+1]]++;
+         sub_histogram[2][p_grey[col+2]]++;
+         sub_histogram[3][p_grey[col+3]]++;
+      }
+      for ( ; col < greyscaleImage.cols; col++) {
+         sub_histogram[0][p_grey[col]]++;
+      }
+   }
+
+   for (i = 0; i < NUMBER_OF_GREY_LEVELS; i++) {
+      histogram[i] += (long) sub_histogram[0][i] + sub_histogram[1][i] + sub_histogram[2][i] + sub_histogram[3][i];
+   }
+}
+
+
+/* computeHistogram()
+
+   Grey-level histogram of a CV_8UC1 image: each thread builds a partial histogram of a band of rows 
+   and the partial histograms are merged under a mutex
+*/
+
+void computeHistogram(const Mat &greyscaleImage, long histogram[]) {
+
+   Mutex histogram_mutex;
+
+   CV_Assert(greyscaleImage.type() == CV_8UC1);
+
+   memset(histogram, 0, NUMBER_OF_GREY_LEVELS * sizeof(long));
+
+   parallel_for_(Range(0, greyscaleImage.rows), [&](const Range &range) {
+
+      long partial_histogram[NUMBER_OF_GREY_LEVELS] = {0};
+      int i;
+
+      histogramRows(greyscaleImage, range.start, range.end, partial_histogram);
+
+      AutoLock lock(histogram_mutex);
+      for (i = 0; i < NUMBER_OF_GREY_LEVELS; i++) {
+         histogram[i] += partial_histogram[i];
+      }
+   });
+}
+
+
+/* otsuThresholds()
+
+   Otsu thresholds for a histogram: numberOfThresholds (1 to OTSU_MAX_THRESHOLDS) thresholds t[0] < t[1] < ... 
+   that divide the grey-levels into numberOfThresholds+1 classes [0, t[0]], [t[0]+1, t[1]], ... , [t[n-1]+1, 255]
+   so as to maximise the between-class variance.  Returns the between-class variance.
+
+   With the cumulative tables P[g] = sum of h[i] and S[g] = sum of i h[i] for i < g, a class [a, b) contributes
+   (S[b] - S[a])^2 / (P[b] - P[a]) to the between-class variance, independently of the other classes.
+   A single threshold is found by a linear scan; several thresholds by dynamic programming over the class 
+   boundaries, which is exact and costs O(n L^2) for L grey-levels rather than O(L^n) for an exhaustive search.
+*/
+
+double otsuThresholds(const long histogram[], int numberOfThresholds, int thresholds[]) {
+
+   double P[NUMBER_OF_GREY_LEVELS + 1];
+   double S[NUMBER_OF_GREY_LEVELS + 1];
+   double best[OTSU_MAX_THRESHOLDS + 2][NUMBER_OF_GREY_LEVELS + 1];      // indexed by number of classes, 1 to OTSU_MAX_THRESHOLDS + 1
+   int    boundary[OTSU_MAX_THRESHOLDS + 2][NUMBER_OF_GREY_LEVELS + 1];
+   double value, best_value;
+   double mean;
+   int numberOfClasses;
+   int g, i, j, m;
+
+   CV_Assert(numberOfThresholds >= 1 && numberOfThresholds <= OTSU_MAX_THRESHOLDS);
+
+   P[0] = 0;
+   S[0] = 0;
+   for (g = 0; g < NUMBER_OF_GREY_LEVELS; g++) {
+      P[g+1] = P[g] + histogram[g];
+      S[g+1] = S[g] + (double) g * histogram[g];
+   }
+
+   if (P[NUMBER_OF_GREY_LEVELS] == 0) {
+      for (m = 0; m < numberOfThresholds; m++) thresholds[m] = m;
+      return 0;
+   }
+
+   mean = S[NUMBER_OF_GREY_LEVELS] / P[NUMBER_OF_GREY_LEVELS];
+   numberOfClasses = numberOfThresholds + 1;
+
+   if (numberOfThresholds == 1) {
+
+      best_value = -1;
+      for (j = 1; j < NUMBER_OF_GREY_LEVELS; j++) {
+         value = otsuClassScore(P, S, 0, j) + otsuClassScore(P, S, j, NUMBER_OF_GREY_LEVELS);
+         if (value > best_value) {
+            best_value  = value;
+            thresholds[0] = j - 1;
+         }
+      }
+   }
+   else {
+
+      /* best[m][j]: best score for splitting [0, j) into m classes; boundary[m][j]: start of the last of those classes */
+
+      for (j = 1; j <= NUMBER_OF_GREY_LEVELS; j++) {
+         best[1][j] = otsuClassScore(P, S, 0, j);
+      }
+
+      for (m = 2; m <= numberOfClasses; m++) {
+         for (j = m; j <= NUMBER_OF_GREY_LEVELS; j++) {
+            best[m][j] = -1;
+            for (i = m-1; i < j; i++) {
+               value = best[m-1][i] + otsuClassScore(P, S, i, j);
+               if (value > best[m][j]) {
+                  best[m][j]     = value;
+                  boundary[m][j] = i;
+               }
+            }
+         }
+      }
+
+      best_value = best[numberOfClasses][NUMBER_OF_GREY_LEVELS];
+
+      j = NUMBER_OF_GREY_LEVELS;
+      for (m = numberOfClasses; m >= 2; m--) {
+         j = boundary[m][j];
+         thresholds[m-2] = j - 1;
+      }
+   }
+
+   return best_value / P[NUMBER_OF_GREY_LEVELS] - mean * mean;
+}
+
+
+/* otsuClassScore()
+
+   Contribution (S[b] - S[a])^2 / (P[b] - P[a]) of the class [a, b) to the between-class variance; 0 if the class is empty
+*/
+
+double otsuClassScore(const double P[], const double S[], int a, int b) {
+
+   double weight = P[b] - P[a];
+   double moment = S[b] - S[a];
+
+   if (weight <= 0) return 0;
+
+   return moment * moment / weight;
+}
+
+
+/* applyThresholds()
+
+   Map each pixel to the index k of its class, k = number of thresholds below its grey-level,
+   scaled to k * 255 / numberOfThresholds; with one threshold this is the usual 0 / 255 binary image
+*/
+
+void applyThresholds(const Mat &greyscaleImage, Mat &thresholdedImage, const int thresholds[], int numberOfThresholds) {
+
+   Mat lut(1, NUMBER_OF_GREY_LEVELS, CV_8UC1);
+   int g, k;
+
+   for (g = 0; g < NUMBER_OF_GREY_LEVELS; g++) {
+      k = 0;
+      while (k < numberOfThresholds && g > thresholds[k]) k++;
+      lut.at<uchar>(0, g) = (uchar) (k * 255 / numberOfThresholds);
+   }
+
+   LUT(greyscaleImage, lut, thresholdedImage);
+}
+
+
+/* tileInterpolation()
+
+   Bilinear interpolation weights along one axis of length pixels divided into tiles of tileSize pixels
+
+   The centre of tile k is the middle of the pixels it actually covers, k tileSize + (extent - 1) / 2, where the 
+   extent is tileSize except for a partial tile at the end of the axis, which is clipped to the image.
+   Pixel p lies between the centres of tiles first[p] and first[p] + 1 and takes the fraction weight[p] of the
+   second; pixels before the first centre or after the last take that tile's threshold (weight 0, same tile).
+*/
+
+static void tileInterpolation(int length, int tileSize, vector<int> &first, vector<float> &weight) {
+
+   int tiles = (length + tileSize - 1) / tileSize;
+   vector<double> centre(tiles);
+   int k, p;
+
+   for (k = 0; k < tiles; k++) {
+      centre[k] = k * tileSize + (min(tileSize, length - k * tileSize) - 1) / 2.0;
+   }
+
+   first.resize(length);
+   weight.resize(length);
+
+   k = 0;
+   for (p = 0; p < length; p++) {
+      while (k + 1 < tiles && centre[k+1] <= p) k++;
+      first[p] = k;
+      if (p <= centre[k] || k + 1 == tiles) {      // on or before the first centre, or after the last
+         weight[p] = 0;
+      }
+      else {
+         weight[p] = (float) ((p - centre[k]) / (centre[k+1] - centre[k]));
+      }
+   }
+}
+
+
+/* localOtsuThreshold()
+
+   Tiled (local) Otsu thresholding for unevenly lit scenes
+
+   The image is divided into tiles of tileSize x tileSize pixels and an Otsu threshold is computed for each tile.
+   A tile whose between-class standard deviation is less than OTSU_MIN_TILE_CONTRAST contains only background 
+   or only object and has no meaningful threshold of its own, so it takes the global threshold instead; this is
+   computed from histogram, the histogram of the whole image built by computeHistogram().
+   The tile thresholds are then interpolated bilinearly between the tile centres to give a threshold for every 
+   pixel, which avoids visible seams at the tile boundaries; see tileInterpolation() for the partial tiles at the
+   right and bottom edges.
+*/
+
+void localOtsuThreshold(const Mat &greyscaleImage, const long histogram[], Mat &thresholdedImage, int tileSize) {
+
+   int global_threshold;
+   int tiles_x, tiles_y;
+   Mat tileThresholds;
+   vector<int>   first_x, first_y;
+   vector<float> weight_x, weight_y;
+
+   CV_Assert(greyscaleImage.type() == CV_8UC1 && tileSize > 0);
+
+   otsuThresholds(histogram, 1, &global_threshold);
+
+   tiles_x = (greyscaleImage.cols + tileSize - 1) / tileSize;
+   tiles_y = (greyscaleImage.rows + tileSize - 1) / tileSize;
+
+   tileThresholds.create(tiles_y, tiles_x, CV_32FC1);
+
+   parallel_for_(Range(0, tiles_x * tiles_y), [&](const Range &range) {
+
+      long tile_histogram[NUMBER_OF_GREY_LEVELS];
+      int threshold;
+      int tx, ty;
+      int t;
+      double variance;
+
+      for (t = range.start; t < range.end; t++) {
+
+         tx = t % tiles_x;
+         ty = t / tiles_x;
+
+         Mat tile = greyscaleImage(Rect(tx * tileSize, ty * tileSize, 
+                                        min(tileSize, greyscaleImage.cols - tx * tileSize), 
+                                        min(tileSize, greyscaleImage.rows - ty * tileSize)));
+
+         memset(tile_histogram, 0, sizeof(tile_histogram));
+         histogramRows(tile, 0, tile.rows, tile_histogram);
+
+         variance = otsuThresholds(tile_histogram, 1, &threshold);
+
+         if (variance < OTSU_MIN_TILE_CONTRAST * OTSU_MIN_TILE_CONTRAST) {
+            threshold = global_threshold;
+         }
+
+         tileThresholds.at<float>(ty, tx) = (float) threshold;
+      }
+   });
+
+   tileInterpolation(greyscaleImage.cols, tileSize, first_x, weight_x);
+   tileInterpolation(greyscaleImage.rows, tileSize, first_y, weight_y);
+
+   thresholdedImage.create(greyscaleImage.size(), CV_8UC1);
+
+   parallel_for_(Range(0, greyscaleImage.rows), [&](const Range &range) {
+
+      vector<float> row_thresholds(tiles_x);     // the tile thresholds interpolated to this row
+      int row, col;
+      int tx, x0, y0, y1;
+      float threshold;
+
+      for (row = range.start; row < range.end; row++) {
+
+         y0 = first_y[row];
+         y1 = min(y0 + 1, tiles_y - 1);
+
+         const float *p_tile0 = tileThresholds.ptr<float>(y0);
+         const float *p_tile1 = tileThresholds.ptr<float>(y1);
+         for (tx = 0; tx < tiles_x; tx++) {
+            row_thresholds[tx] = p_tile0[tx] + weight_y[row] * (p_tile1[tx] - p_tile0[tx]);
+         }
+
+         const unsigned char *p_grey  = greyscaleImage.ptr<unsigned char>(row);
+         unsigned char *p_thresholded = thresholdedImage.ptr<unsigned char>(row);
+
+         for (col = 0; col < greyscaleImage.cols; col++) {
+            x0 = first_x[col];
+            threshold = row_thresholds[x0];
+            if (weight_x[col] > 0) threshold += weight_x[col] * (row_thresholds[x0 + 1] - threshold);
+            p_thresholded[col] = (unsigned char) -(p_grey[col] > threshold);
+         }
+      }
+   });
+}
+
+
+/*
+ * binaryThresholdingOtsuBatch
+ * Batch mode: write the global, multi-level, and local Otsu images to <output_stem>_otsu.png, <output_stem>_multilevel.png, 
+ * and <output_stem>_local.png, and the global and multi-level thresholds to <output_stem>_thresholds.txt
+ */
+
+bool binaryThresholdingOtsuBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   Mat greyscaleImage;
+   Mat thresholdedImage; 
+   Mat multilevelImage; 
+   Mat localImage; 
+
+   long histogram[NUMBER_OF_GREY_LEVELS];
+   int global_threshold;
+   int thresholds[OTSU_MAX_THRESHOLDS];
+   FILE *fp_out;
+   bool ok;
+   int i;
+
+   if (image.type() == CV_8UC3) { // colour image
+      cvtColor(image, greyscaleImage, COLOR_BGR2GRAY);
+   } 
+   else {
+      greyscaleImage = image;
+   }
+
+   if (greyscaleImage.type() != CV_8UC1) {
+      printf("Error: %s is not an 8-bit greyscale or colour image\n", image_filename);
+      return false;
+   }
+
+   computeHistogram(greyscaleImage, histogram);
+
+   otsuThresholds(histogram, 1, thresholds);
+   applyThresholds(greyscaleImage, thresholdedImage, thresholds, 1);
+   global_threshold = thresholds[0];
+
+   otsuThresholds(histogram, OTSU_NUMBER_OF_THRESHOLDS, thresholds);
+   applyThresholds(greyscaleImage, multilevelImage, thresholds, OTSU_NUMBER_OF_THRESHOLDS);
+
+   localOtsuThreshold(greyscaleImage, histogram, localImage, OTSU_TILE_SIZE);
+
+   ok =       imwrite(string(output_stem) + "_otsu.png",       thresholdedImage);
+   ok = ok && imwrite(string(output_stem) + "_multilevel.png", multilevelImage);
+   ok = ok && imwrite(string(output_stem) + "_local.png",      localImage);
+
+   if ((fp_out = fopen((string(output_stem) + "_thresholds.txt").c_str(), "w")) == 0) return false;
+
+   fprintf(fp_out, "Otsu threshold: %d\n", global_threshold);
+   fprintf(fp_out, "Multi-level Otsu thresholds:");
+   for (i=0; i<OTSU_NUMBER_OF_THRESHOLDS; i++) fprintf(fp_out, " %d", thresholds[i]);
+   fprintf(fp_out, "\n");
+   fclose(fp_out);
+
+   return ok;
 }
 
+
 void prompt_and_exit(int status) {
    printf("Press any key to continue and close terminal ... \n");
    getchar();
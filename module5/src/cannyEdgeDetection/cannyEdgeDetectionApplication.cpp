@@ -23,7 +23,12 @@
   Ported to Ubuntu 16.04 and OpenCV 3.3
   Abrham Gebreselasie
   10 March 2021
-  
+
+  Replaced src_gray, src_blur, and detected_edges with canny_pipeline, which caches each stage of the edge detector
+  17 October 2026
+
+  Headless batch mode: cannyEdgeDetection --batch <images> <output directory> [number of threads]
+  17 October 2026
 
 */
  
@@ -32,9 +37,7 @@
 // Global variables to allow access by the display window callback functions
 
 Mat src;
-Mat src_blur;
-Mat src_gray;
-Mat detected_edges;
+CannyPipeline canny_pipeline;
 int cannyThreshold             = 20;         // low threshold for Canny edge detector
 int gaussian_std_dev           = 3;          // default standard deviation for Gaussian filter: filter size = value * 4 + 1
 const char* canny_window_name        = "Canny Edge Map";
@@ -42,7 +45,18 @@ const char* input_window_name        = "Input Image";
 
 int view;
 
-int main() {
+int main(int argc, char **argv) {
+
+   /* headless batch mode: see batchProcessing.h */
+
+   batchOptionsType batch_options;
+   vector<CannyPipeline> batch_pipelines;      // one for each worker thread
+
+   if (isBatchMode(argc, argv)) {
+      if (!getBatchOptions(argc, argv, &batch_options)) return 1;
+      batch_pipelines.resize(batch_options.number_of_threads);
+      return runBatch(batch_options, "cannyEdgeDetection", IMREAD_COLOR, cannyEdgeDetectionBatch, &batch_pipelines);
+   }
    
    #ifdef ROS
       // Turn off canonical terminal mode and character echoing
@@ -102,6 +116,8 @@ int main() {
             cout << "can not open " << filename << endl;
             return -1;
          }
+
+         canny_pipeline.invalidate();
           
          printf("Press any key to continue ...\n");
 
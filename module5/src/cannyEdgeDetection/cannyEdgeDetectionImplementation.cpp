@@ -12,6 +12,14 @@
   --------------------
   Added _kbhit
   18 February 2021
+
+  The greyscale conversion, Gaussian blur, gradients, non-maximum suppression, and hysteresis are now cached stages
+  of a CannyPipeline, so that moving the threshold trackbar reruns only the hysteresis; the time taken by each
+  stage is shown in the window title
+  17 October 2026
+
+  Added cannyEdgeDetectionBatch(): the core of the application for headless batch mode
+  17 October 2026
     
 */
  
@@ -25,30 +33,305 @@
 void CannyThreshold(int, void*)
 {  
    extern Mat src;
-   extern Mat src_gray;
-   extern Mat src_blur;
-   extern Mat detected_edges;
+   extern CannyPipeline canny_pipeline;
    extern int cannyThreshold; 
    extern char* canny_window_name;
    extern int gaussian_std_dev; 
 
-   int ratio = 3;
-   int kernel_size = 3;
-   int filter_size;
-
-   filter_size = gaussian_std_dev * 4 + 1;  // multiplier must be even to ensure an odd filter size as required by OpenCV
-                                            // this places an upper limit on gaussian_std_dev of 7 to ensure the filter size < 31
-                                            // which is the maximum size for the Laplacian operator
+   char title[MAX_STRING_LENGTH * 3];
 
-   cvtColor(src, src_gray, COLOR_BGR2GRAY);
+   /* gaussian_std_dev is limited to 7 so that the filter size, gaussian_std_dev * 4 + 1, is less than 31 */
 
-   GaussianBlur(src_gray, src_blur, Size(filter_size,filter_size), gaussian_std_dev);
+   const Mat &detected_edges = canny_pipeline.run(src, gaussian_std_dev, cannyThreshold, cannyThreshold * CANNY_RATIO);
 
-   Canny( src_blur, detected_edges, cannyThreshold, cannyThreshold*ratio, kernel_size );
+   canny_pipeline.timing(title, sizeof(title));
+   setWindowTitle(canny_window_name, title);
 
    imshow( canny_window_name, detected_edges );
  }
 
+
+/*
+ * CannyPipeline
+ */
+
+CannyPipeline::CannyPipeline() {
+   invalidate();
+}
+
+
+/* discard the cached stages: the next call to run() recomputes everything */
+
+void CannyPipeline::invalidate() {
+
+   grey_source     = NULL;
+   blur_sigma      = -1;
+   hysteresis_low  = -1;
+   hysteresis_high = -1;
+
+   for (int k = 0; k < CANNY_STAGES; k++) {
+      stage_ms[k]  = 0;
+      stage_run[k] = false;
+   }
+}
+
+
+/* run()
+
+   Detect the edges in src, an 8-bit colour or greyscale image, after smoothing with a Gaussian of standard deviation
+   sigma (filter size sigma * 4 + 1); low and high are the hysteresis thresholds.
+   Only the stages whose parameters or input have changed since the last call are rerun.
+   Returns the edge map, which remains valid until the next call.
+*/
+
+const Mat &CannyPipeline::run(const Mat &src, int sigma, int low, int high) {
+
+   int first_stage = CANNY_STAGES;  // first stage that must be rerun; the ones after it are rerun too
+   int filter_size;
+   int k;
+   int64 start_ticks;
+
+   if (src.data != grey_source)                                     first_stage = CANNY_GREY;
+   else if (sigma != blur_sigma)                                    first_stage = CANNY_BLUR;
+   else if (low != hysteresis_low || high != hysteresis_high)       first_stage = CANNY_HYSTERESIS;
+
+   for (k = 0; k < CANNY_STAGES; k++) {
+
+      stage_run[k] = k >= first_stage;
+      if (!stage_run[k]) continue;
+
+      start_ticks = getTickCount();
+
+      switch (k) {
+
+      case CANNY_GREY:
+         if (src.type() == CV_8UC3) {
+            cvtColor(src, grey, COLOR_BGR2GRAY);
+         }
+         else {
+            src.copyTo(grey);
+         }
+         grey_source = src.data;
+         break;
+
+      case CANNY_BLUR:
+         filter_size = sigma * 4 + 1;
+         GaussianBlur(grey, blurred, Size(filter_size, filter_size), sigma);
+         blur_sigma = sigma;
+         break;
+
+      case CANNY_GRADIENTS:
+         Sobel(blurred, dx, CV_16S, 1, 0, 3, 1, 0, BORDER_REPLICATE);   // as Canny() does
+         Sobel(blurred, dy, CV_16S, 0, 1, 3, 1, 0, BORDER_REPLICATE);
+         break;
+
+      case CANNY_NMS:
+         cannyNonMaximumSuppression(dx, dy, suppressed);
+         break;
+
+      case CANNY_HYSTERESIS:
+         cannyHysteresis(suppressed, edges, low, high);
+         hysteresis_low  = low;
+         hysteresis_high = high;
+         break;
+      }
+
+      stage_ms[k] = 1000.0 * (getTickCount() - start_ticks) / getTickFrequency();
+   }
+
+   return edges;
+}
+
+
+/* write the time taken by each stage in the last call to run() to text; stages that were not rerun are shown as cached */
+
+void CannyPipeline::timing(char text[], int length) {
+
+   const char *stage_names[CANNY_STAGES] = {"grey", "blur", "gradients", "nms", "hysteresis"};
+   int n;
+   int k;
+
+   n = snprintf(text, length, "Canny");
+
+   for (k = 0; k < CANNY_STAGES && n < length; k++) {
+      if (stage_run[k]) {
+         n += snprintf(text + n, length - n, "  %s %.2f ms", stage_names[k], stage_ms[k]);
+      }
+      else {
+         n += snprintf(text + n, length - n, "  %s cached", stage_names[k]);
+      }
+   }
+}
+
+
+/* cannyNonMaximumSuppression()
+
+   suppressed: CV_16UC1, the L1 gradient magnitude |dx| + |dy| where it is a maximum across the gradient direction,
+   and 0 elsewhere.  The direction is quantised to horizontal, vertical, or one of the two diagonals, and the
+   comparisons with the two neighbours are the same as in Canny(), so that the same pixels are kept.
+   Magnitudes outside the image are taken as 0.
+
+   The rows are processed in parallel bands; each band keeps the magnitude of three rows.
+*/
+
+void cannyNonMaximumSuppression(const Mat &dx, const Mat &dy, Mat &suppressed) {
+
+   int rows = dx.rows;
+   int cols = dx.cols;
+
+   CV_Assert(dx.type() == CV_16SC1 && dy.type() == CV_16SC1);
+
+   suppressed.create(dx.size(), CV_16UC1);
+
+   parallel_for_(Range(0, rows), [&](const Range &range) {
+
+      std::vector<int> buffer(3 * (cols + 2), 0);  // one zero column either side of each row
+      int *magnitude[3], *t;
+      int row, col, k;
+      int m, x, y, s;
+      int tg22x, tg67x;
+      bool maximum;
+
+      for (k = 0; k < 3; k++) {
+         magnitude[k] = &buffer[k * (cols + 2) + 1];
+      }
+
+      /* L1 magnitude of image row r into m_r, or 0 if r is outside the image */
+
+      auto magnitudeRow = [&](int r, int *m_r) {
+         if (r < 0 || r >= rows) {
+            memset(m_r, 0, cols * sizeof(int));
+            return;
+         }
+         const short *p_dx = dx.ptr<short>(r);
+         const short *p_dy = dy.ptr<short>(r);
+         for (int j = 0; j < cols; j++) {
+            m_r[j] = abs(p_dx[j]) + abs(p_dy[j]);
+         }
+      };
+
+      magnitudeRow(range.start - 1, magnitude[0]);
+      magnitudeRow(range.start,     magnitude[1]);
+
+      for (row = range.start; row < range.end; row++) {
+
+         magnitudeRow(row + 1, magnitude[2]);
+
+         const short *p_dx = dx.ptr<short>(row);
+         const short *p_dy = dy.ptr<short>(row);
+         ushort *p_suppressed = suppressed.ptr<ushort>(row);
+         const int *previous = magnitude[0];
+         const int *current  = magnitude[1];
+         const int *next     = magnitude[2];
+
+         for (col = 0; col < cols; col++) {
+
+            m = current[col];
+            maximum = false;
+
+            if (m > 0) {
+               x = abs(p_dx[col]);
+               y = abs(p_dy[col]) << CANNY_SHIFT;
+               tg22x = x * CANNY_TG22;
+
+               if (y < tg22x) {                                  // horizontal gradient
+                  maximum = m > current[col - 1] && m >= current[col + 1];
+               }
+               else {
+                  tg67x = tg22x + (x << (CANNY_SHIFT + 1));
+                  if (y > tg67x) {                               // vertical gradient
+                     maximum = m > previous[col] && m >= next[col];
+                  }
+                  else {                                         // diagonal gradient
+                     s = (p_dx[col] ^ p_dy[col]) < 0 ? -1 : 1;
+                     maximum = m > previous[col - s] && m > next[col + s];
+                  }
+               }
+            }
+
+            p_suppressed[col] = maximum ? (ushort) m : 0;
+         }
+
+         t = magnitude[0]; magnitude[0] = magnitude[1]; magnitude[1] = magnitude[2]; magnitude[2] = t;
+      }
+   });
+}
+
+
+/* cannyHysteresis()
+
+   edges: CV_8UC1, 255 for every local maximum greater than high and for every local maximum greater than low that is
+   8-connected to one of these through other local maxima greater than low; 0 elsewhere
+*/
+
+void cannyHysteresis(const Mat &suppressed, Mat &edges, int low, int high) {
+
+   int rows = suppressed.rows;
+   int cols = suppressed.cols;
+   int row, col, r, c;
+   int i, j;
+   std::vector<int> stack;     // pixel index row * cols + col of edges whose neighbours are still to be visited
+
+   CV_Assert(suppressed.type() == CV_16UC1);
+
+   edges.create(suppressed.size(), CV_8UC1);
+   edges.setTo(Scalar(0));
+
+   if (low > high) std::swap(low, high);
+
+   for (row = 0; row < rows; row++) {
+
+      const ushort *p_suppressed = suppressed.ptr<ushort>(row);
+      uchar *p_edges = edges.ptr<uchar>(row);
+
+      for (col = 0; col < cols; col++) {
+
+         if (p_suppressed[col] <= high || p_edges[col] != 0) continue;
+
+         p_edges[col] = 255;
+         stack.push_back(row * cols + col);
+
+         while (!stack.empty()) {
+
+            r = stack.back() / cols;
+            c = stack.back() % cols;
+            stack.pop_back();
+
+            for (i = max(r - 1, 0); i <= min(r + 1, rows - 1); i++) {
+               for (j = max(c - 1, 0); j <= min(c + 1, cols - 1); j++) {
+                  if (suppressed.at<ushort>(i, j) > low && edges.at<uchar>(i, j) == 0) {
+                     edges.at<uchar>(i, j) = 255;
+                     stack.push_back(i * cols + j);
+                  }
+               }
+            }
+         }
+      }
+   }
+}
+
+
+/*
+ * cannyEdgeDetectionBatch
+ * Batch mode: detect edges with the default standard deviation and threshold and write <output_stem>_edges.png
+ * context is a vector<CannyPipeline> with one pipeline for each worker thread
+ */
+
+bool cannyEdgeDetectionBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   extern int cannyThreshold; 
+   extern int gaussian_std_dev; 
+
+   CannyPipeline &pipeline = (*(vector<CannyPipeline> *) context)[worker];
+
+   pipeline.invalidate();   // the stages are cached by image address, which the next image may reuse
+
+   const Mat &detected_edges = pipeline.run(image, gaussian_std_dev, cannyThreshold, cannyThreshold * CANNY_RATIO);
+
+   return imwrite(string(output_stem) + "_edges.png", detected_edges);
+}
+
+
 void prompt_and_exit(int status) {
    printf("Press any key to continue and close terminal ... \n");
    getchar();
@@ -11,6 +11,15 @@
   For each image, The user must interactively select the colour sample that will form the basis of the segmentation by clicking on a selected pixel.
   The user can also adjust the hue and saturation tolerances on that sample.
 
+  Several samples can be combined: each click on a pixel, or drag over a region, adds its colours to a hue-saturation 
+  histogram model and the image is segmented by back-projection of the model; the Threshold trackbar sets the 
+  fraction (in percent) of the peak of the model that a colour must reach.  A right click clears the model.
+  With the segmented image window selected, press s to save the model to colourSegmentationModel.yml in the data 
+  directory, l to load it, and c to clear it.  The model is kept from one image to the next.
+
+  In batch mode, colourSegmentation --batch <images> <output directory> [number of threads], every image is segmented
+  without windows with the model, ranges, and threshold saved in colourSegmentationModel.yml.
+
   (This is the application file: it contains the client code that calls dedicated functions to implement the application.
   The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
 
@@ -30,6 +39,12 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Multi-sample hue-saturation model with back-projection, saved to and loaded from a file
+  17 October 2026
+
+  Headless batch mode with the saved colour model: colourSegmentation --batch <images> <output directory> [number of threads]
+  17 October 2026
 */
 
  
@@ -41,13 +56,44 @@ Mat inputBGRImage;
 Mat inputHLSImage;
 int hueRange            = 10; // default range
 int saturationRange     = 10; // default range
-Point2f sample_point; 
-int number_of_sample_points;
+int modelThreshold      = 10; // default back-projection threshold, percent of the peak of the model
+Mat hueSaturationModel;       // histogram of the hue and saturation of all the samples
+int model_version       = 0;  // incremented whenever the model changes
+int number_of_sample_points = 0;
 
 const char* input_window_name       = "Input Image";
 const char* segmented_window_name   = "Segmented Image";
 
-int main() {
+int main(int argc, char **argv) {
+
+   /* headless batch mode: see batchProcessing.h                                                                */
+   /* the back-projection table of the saved model is built once, before the batch, and shared by the workers */
+
+   batchOptionsType batch_options;
+   char batch_model_filename[MAX_FILENAME_LENGTH];
+   static unsigned char batch_lut[SEGMENTATION_LUT_SIZE];
+
+   if (isBatchMode(argc, argv)) {
+      if (!getBatchOptions(argc, argv, &batch_options)) return 1;
+
+      #ifdef ROS
+         strcpy(batch_model_filename, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+      #else
+         strcpy(batch_model_filename, "..");
+      #endif
+      strcat(batch_model_filename, "/data/");
+      strcat(batch_model_filename, COLOUR_MODEL_FILENAME);
+
+      if (!loadColourModel(batch_model_filename)) {
+         printf("Error: batch mode needs a colour model; save one with s in the interactive application\n");
+         return 1;
+      }
+
+      if (modelThreshold < 1) modelThreshold = 1;  // as in colourSegmentation()
+      buildBackProjectionLUT(hueSaturationModel, hueRange, saturationRange, modelThreshold, batch_lut);
+
+      return runBatch(batch_options, "colourSegmentation", IMREAD_COLOR, colourSegmentationBatch, batch_lut);
+   }
    
    #ifdef ROS
       // Turn off canonical terminal mode and character echoing
@@ -70,6 +116,9 @@ int main() {
    char filename[MAX_FILENAME_LENGTH];
    int max_hue_range = 180;
    int max_saturation_range = 128;
+   int max_threshold = 100;
+   int key;
+   char model_path_and_filename[MAX_FILENAME_LENGTH];
    Mat outputImage;
 
    FILE *fp_in;
@@ -85,6 +134,9 @@ int main() {
    strcpy(input_path_and_filename, data_dir);
    strcat(input_path_and_filename, input_filename);
    
+   strcpy(model_path_and_filename, data_dir);
+   strcat(model_path_and_filename, COLOUR_MODEL_FILENAME);
+
 
    if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
 	  printf("Error can't open input colourSegmentationInput.txt\n");
@@ -109,7 +161,8 @@ int main() {
 
          CV_Assert(inputBGRImage.type() == CV_8UC3 ); // make sure we are dealing with a colour image
 
-         printf("Click on a sample point in the input image.\n");
+         printf("Click on sample points or drag over sample regions in the input image; right click to clear the samples.\n");
+         printf("In the segmented image window, press s to save the colour model, l to load it, c to clear it.\n");
          printf("When finished with this image, press any key to continue ...\n");
 
          /* Create a window for input and display it */
@@ -124,15 +177,34 @@ int main() {
          namedWindow(segmented_window_name, WINDOW_AUTOSIZE );
          createTrackbar( "Hue Range", segmented_window_name, &hueRange,        max_hue_range,        colourSegmentation);
          createTrackbar( "Sat Range", segmented_window_name, &saturationRange, max_saturation_range, colourSegmentation);
+         createTrackbar( "Threshold", segmented_window_name, &modelThreshold,  max_threshold,        colourSegmentation);
 
-         /* display a zero output */
+         /* display a zero output, or the segmentation with the model from the previous image */
          outputImage = Mat::zeros(inputBGRImage.rows, inputBGRImage.cols, inputBGRImage.type()); 
          imshow(segmented_window_name, outputImage); 
+         colourSegmentation(0, 0);
 
-         /* now wait for user interaction - mouse click to change the colour sample or trackbar adjustment to change the thresholds */
-         number_of_sample_points = 0;
+         /* now wait for user interaction - mouse clicks to add colour samples, trackbar adjustment to change the thresholds, */
+         /* or keys in the segmented image window to save, load, or clear the model                                         */
          do {
-            waitKey(30);                             
+            key = waitKey(30);                             
+            if (key == 's') {
+               if (saveColourModel(model_path_and_filename)) printf("Saved colour model to %s\n", model_path_and_filename);
+            }
+            else if (key == 'l') {
+               if (loadColourModel(model_path_and_filename)) {
+                  printf("Loaded colour model from %s\n", model_path_and_filename);
+                  setTrackbarPos("Hue Range", segmented_window_name, hueRange);
+                  setTrackbarPos("Sat Range", segmented_window_name, saturationRange);
+                  setTrackbarPos("Threshold", segmented_window_name, modelThreshold);
+                  colourSegmentation(0, 0);
+               }
+            }
+            else if (key == 'c') {
+               clearColourModel();
+               imshow(input_window_name, inputBGRImage);
+               imshow(segmented_window_name, outputImage);
+            }
          } while (!_kbhit());      
          
          getchar(); // flush the buffer from the keyboard hit
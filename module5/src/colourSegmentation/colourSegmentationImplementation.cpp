@@ -16,6 +16,17 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  The hue and saturation tests are now evaluated once for every (hue, saturation) pair in a lookup table that is
+  rebuilt only when the sample point or the ranges change; the segmented image is produced with the resulting mask
+  17 October 2026
+
+  Multi-sample colour model: clicked points and dragged regions are accumulated in a hue-saturation histogram and 
+  the segmentation is by back-projection of that histogram with a threshold; the model can be saved and loaded
+  17 October 2026
+
+  Added colourSegmentationBatch(): the core of the application for headless batch mode
+  17 October 2026
 */
  
 #include "module5/colourSegmentation.h"
@@ -24,96 +35,364 @@ void colourSegmentation(int, void*) {
   
    extern Mat inputBGRImage;
    extern Mat inputHLSImage;
+   extern Mat hueSaturationModel;
    extern int hueRange;
    extern int saturationRange;
-   extern Point2f sample_point; 
-   extern char* segmented_window_name;
+   extern int modelThreshold;
+   extern int model_version;
+   extern const char* segmented_window_name;
    extern int number_of_sample_points;
 
-   Mat segmentedImage; 
-   int row, col;
- 
-   int hue;
-   int saturation;
-   int h;
-   int s;
+   static Mat segmentedImage;                                          // kept between calls to avoid reallocation
+   static Mat mask;
+   static unsigned char lut[SEGMENTATION_LUT_SIZE];
+   static int lut_version = -1, lut_hue_range = -1, lut_saturation_range = -1, lut_threshold = -1;
 
    bool debug = false;
 
    if (debug) { 
-      printf("colourSegmentation: %d %d\n", hueRange, saturationRange); 
+      printf("colourSegmentation: %d %d %d\n", hueRange, saturationRange, modelThreshold); 
    }
 
-   /* now get the sample point */
-   if (number_of_sample_points == 1) {
+   if (modelThreshold < 1)  // the trackbar has a lower value of 0 which would accept every colour
+      modelThreshold = 1;
+
+   if (number_of_sample_points > 0) {
   
-      segmentedImage = inputBGRImage.clone();
-    
-      hue        = inputHLSImage.at<Vec3b>((int)sample_point.y,(int)sample_point.x)[0]; // note order of indices
-      saturation = inputHLSImage.at<Vec3b>((int)sample_point.y,(int)sample_point.x)[2]; // note order of indices
+      /* rebuild the lookup table only if the model, the ranges, or the threshold have changed */
+      if (model_version != lut_version || hueRange != lut_hue_range || saturationRange != lut_saturation_range || modelThreshold != lut_threshold) {
+         buildBackProjectionLUT(hueSaturationModel, hueRange, saturationRange, modelThreshold, lut);
+         lut_version          = model_version;
+         lut_hue_range        = hueRange;
+         lut_saturation_range = saturationRange;
+         lut_threshold        = modelThreshold;
+
+         if (debug) printf("Rebuilt the back-projection table for %d samples\n", number_of_sample_points);
+      }
+
+      /* now perform segmentation: one table lookup per pixel */
+      segmentationMask(inputHLSImage, mask, lut);
+
+      segmentedImage.create(inputBGRImage.size(), inputBGRImage.type());
+      segmentedImage.setTo(Scalar::all(0));
+      inputBGRImage.copyTo(segmentedImage, mask);
+
+      imshow(segmented_window_name, segmentedImage);
+   }
+
+   if (debug) printf("Leaving colourSegmentation() \n");
+
+}
+
+
+/*=======================================================*/
+/* Hue-saturation colour model                           */ 
+/*=======================================================*/
+
+/* addColourSample()
+
+   Add the hue and saturation of every pixel in region of the HLS image to the hue-saturation histogram model
+*/
+
+void addColourSample(Rect region) {
+
+   extern Mat inputHLSImage;
+   extern Mat hueSaturationModel;
+   extern int number_of_sample_points;
+   extern int model_version;
+
+   int row, col;
+
+   region &= Rect(0, 0, inputHLSImage.cols, inputHLSImage.rows);
+   if (region.area() == 0) return;
+
+   if (hueSaturationModel.empty()) {
+      hueSaturationModel = Mat::zeros(SEGMENTATION_HUE_LEVELS, SEGMENTATION_SATURATION_LEVELS, CV_32FC1);
+   }
 
-      if (debug) { 
-         printf("Sample point (%f, %f) Hue: %d  Saturation: %d\n", sample_point.y, sample_point.x, hue, saturation); // note order of indices
-         printf("Hue range: %d  Saturation range: %d\n", hueRange, saturationRange);                                 // note order of indices
+   for (row = region.y; row < region.y + region.height; row++) {
+      const unsigned char *p_hls = inputHLSImage.ptr<unsigned char>(row);
+      for (col = region.x; col < region.x + region.width; col++) {
+         hueSaturationModel.at<float>(p_hls[3*col], p_hls[3*col+2]) += 1;
       }
+   }
 
-      /* now perform segmentation */
- 	   for (row=0; row < inputBGRImage.rows; row++) {
-		   for (col=0; col < inputBGRImage.cols; col++) {
-
-            h = inputHLSImage.at<Vec3b>(row,col)[0];
-            s = inputHLSImage.at<Vec3b>(row,col)[2];
-
-            /* Note: 0 <= h <= 180 ... NOT as you'd expect: 0 <= h <= 360  */
-            if ((((h >= hue     - hueRange) && (h <= hue     + hueRange)) ||
-                 ((h >= hue+180 - hueRange) && (h <= hue+180 + hueRange)) ||
-                 ((h >= hue-180 - hueRange) && (h <= hue-180 + hueRange))) 
-                 &&
-                 ((s >= (saturation - saturationRange)) && (s <= (saturation + saturationRange)))) {
-               segmentedImage.at<Vec3b>(row,col)[0] = inputBGRImage.at<Vec3b>(row,col)[0];
-               segmentedImage.at<Vec3b>(row,col)[1] = inputBGRImage.at<Vec3b>(row,col)[1];
-               segmentedImage.at<Vec3b>(row,col)[2] = inputBGRImage.at<Vec3b>(row,col)[2];
-            }
-            else {
-               segmentedImage.at<Vec3b>(row,col)[0] = 0;
-               segmentedImage.at<Vec3b>(row,col)[1] = 0;
-               segmentedImage.at<Vec3b>(row,col)[2] = 0;
+   number_of_sample_points++;
+   model_version++;
+}
+
+
+void clearColourModel() {
+
+   extern Mat hueSaturationModel;
+   extern int number_of_sample_points;
+   extern int model_version;
+
+   hueSaturationModel.release();
+   number_of_sample_points = 0;
+   model_version++;
+}
+
+
+/* saveColourModel() and loadColourModel()
+
+   The model is saved with cv::FileStorage (YAML or XML, depending on the filename extension) together with the 
+   hue range, saturation range, and threshold so that a segmentation can be reproduced, e.g. on simulator camera frames
+*/
+
+bool saveColourModel(const char *filename) {
+
+   extern Mat hueSaturationModel;
+   extern int hueRange;
+   extern int saturationRange;
+   extern int modelThreshold;
+   extern int number_of_sample_points;
+
+   FileStorage fs(filename, FileStorage::WRITE);
+
+   if (!fs.isOpened()) {
+      printf("saveColourModel: can't open %s\n", filename);
+      return false;
+   }
+
+   fs << "numberOfSamples"    << number_of_sample_points;
+   fs << "hueRange"           << hueRange;
+   fs << "saturationRange"    << saturationRange;
+   fs << "threshold"          << modelThreshold;
+   fs << "hueSaturationModel" << hueSaturationModel;
+
+   return true;
+}
+
+
+bool loadColourModel(const char *filename) {
+
+   extern Mat hueSaturationModel;
+   extern int hueRange;
+   extern int saturationRange;
+   extern int modelThreshold;
+   extern int number_of_sample_points;
+   extern int model_version;
+
+   Mat model;
+
+   FileStorage fs(filename, FileStorage::READ);
+
+   if (!fs.isOpened()) {
+      printf("loadColourModel: can't open %s\n", filename);
+      return false;
+   }
+
+   fs["hueSaturationModel"] >> model;
+
+   if (model.rows != SEGMENTATION_HUE_LEVELS || model.cols != SEGMENTATION_SATURATION_LEVELS || model.type() != CV_32FC1) {
+      printf("loadColourModel: %s does not contain a valid hue-saturation model\n", filename);
+      return false;
+   }
+
+   hueSaturationModel = model;
+   fs["numberOfSamples"] >> number_of_sample_points;
+   fs["hueRange"]        >> hueRange;
+   fs["saturationRange"] >> saturationRange;
+   fs["threshold"]       >> modelThreshold;
+   model_version++;
+
+   return true;
+}
+
+
+/* buildBackProjectionLUT()
+
+   Back-project the hue-saturation histogram model into the segmentation table: lut[h * SEGMENTATION_SATURATION_LEVELS + s]
+   is 255 if the model, smoothed by a box of half-width hueRange in hue (with wrap-around) and saturationRange in 
+   saturation, is at least threshold percent of its maximum at (h, s), and 0 otherwise.
+
+   With a single one-pixel sample this accepts exactly the colours within hueRange and saturationRange of the sample,
+   i.e. the original single-sample segmentation.
+*/
+
+void buildBackProjectionLUT(const Mat &model, int hueRange, int saturationRange, int threshold, unsigned char lut[]) {
+
+   Mat saturationSmoothed(SEGMENTATION_HUE_LEVELS, SEGMENTATION_SATURATION_LEVELS, CV_64FC1);
+   Mat smoothed = Mat::zeros(SEGMENTATION_HUE_LEVELS, SEGMENTATION_SATURATION_LEVELS, CV_64FC1);
+   double prefix[SEGMENTATION_SATURATION_LEVELS + 1];
+   double maximum;
+   double cut_off;
+   int h, hs, s;
+   int d;
+
+   memset(lut, 0, SEGMENTATION_LUT_SIZE);
+
+   if (model.empty()) return;
+
+   /* smooth in saturation with running sums */
+
+   for (h = 0; h < SEGMENTATION_HUE_LEVELS; h++) {
+
+      const float *p_model = model.ptr<float>(h);
+      double *p_smoothed   = saturationSmoothed.ptr<double>(h);
+
+      prefix[0] = 0;
+      for (s = 0; s < SEGMENTATION_SATURATION_LEVELS; s++) {
+         prefix[s+1] = prefix[s] + p_model[s];
+      }
+      for (s = 0; s < SEGMENTATION_SATURATION_LEVELS; s++) {
+         p_smoothed[s] = prefix[min(s + saturationRange, SEGMENTATION_SATURATION_LEVELS - 1) + 1] - prefix[max(s - saturationRange, 0)];
+      }
+   }
+
+   /* smooth in hue: hue hs contributes to h if they are within hueRange of each other, allowing for wrap-around at 180 */
+
+   for (h = 0; h < SEGMENTATION_HUE_LEVELS; h++) {
+      double *p_smoothed = smoothed.ptr<double>(h);
+      for (hs = 0; hs < SEGMENTATION_HUE_LEVELS; hs++) {
+         d = abs(h - hs);
+         if (d <= hueRange || abs(d - 180) <= hueRange) {
+            const double *p_row = saturationSmoothed.ptr<double>(hs);
+            for (s = 0; s < SEGMENTATION_SATURATION_LEVELS; s++) {
+               p_smoothed[s] += p_row[s];
             }
          }
       }
-      imshow(segmented_window_name, segmentedImage);
    }
 
-   if (debug) printf("Leaving colourSegmentation() \n");
+   minMaxLoc(smoothed, NULL, &maximum);
+
+   if (maximum <= 0) return;
+
+   cut_off = maximum * threshold / 100.0;
+
+   for (h = 0; h < SEGMENTATION_HUE_LEVELS; h++) {
+      const double *p_smoothed = smoothed.ptr<double>(h);
+      for (s = 0; s < SEGMENTATION_SATURATION_LEVELS; s++) {
+         lut[h * SEGMENTATION_SATURATION_LEVELS + s] = (p_smoothed[s] > 0 && p_smoothed[s] >= cut_off) ? 255 : 0;
+      }
+   }
+}
+
+
+/* segmentationMask()
+
+   Look up each pixel of an HLS image in the segmentation table to give a CV_8UC1 mask; the rows are split across threads
+*/
+
+void segmentationMask(const Mat &inputHLSImage, Mat &mask, const unsigned char lut[]) {
+
+   CV_Assert(inputHLSImage.type() == CV_8UC3);
 
+   mask.create(inputHLSImage.size(), CV_8UC1);
+
+   parallel_for_(Range(0, inputHLSImage.rows), [&](const Range &range) {
+      int row, col;
+      for (row=range.start; row < range.end; row++) {
+         const unsigned char *p_hls = inputHLSImage.ptr<unsigned char>(row);
+         unsigned char *p_mask      = mask.ptr<unsigned char>(row);
+         for (col=0; col < inputHLSImage.cols; col++) {
+            p_mask[col] = lut[p_hls[3*col] * SEGMENTATION_SATURATION_LEVELS + p_hls[3*col+2]];
+         }
+      }
+   });
 }
  
 
-void getSamplePoint( int event, int x, int y, int, void* ) {
+/*
+ * colourSegmentationBatch
+ * Batch mode: segment the image with the back-projection table of the saved colour model and write the segmented
+ * image to <output_stem>_segmented.png and the mask to <output_stem>_mask.png
+ * context is the table, built once by the application from the model and shared by all the worker threads
+ */
+
+bool colourSegmentationBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   const unsigned char *lut = (const unsigned char *) context;
+   Mat hlsImage;
+   Mat mask;
+   Mat segmentedImage;
+   bool ok;
+
+   if (image.type() != CV_8UC3) {
+      printf("Error: %s is not a colour image\n", image_filename);
+      return false;
+   }
+
+   cvtColor(image, hlsImage, COLOR_BGR2HLS);
+   segmentationMask(hlsImage, mask, lut);
+
+   segmentedImage = Mat::zeros(image.size(), image.type());
+   image.copyTo(segmentedImage, mask);
+
+   ok =       imwrite(string(output_stem) + "_segmented.png", segmentedImage);
+   ok = ok && imwrite(string(output_stem) + "_mask.png",      mask);
+
+   return ok;
+}
+
+
+/* getSamplePoint()
+
+   Mouse callback for the input window
+   Left click:  add the colour of the pixel to the model
+   Left drag:   add the colours of all the pixels in the rectangle to the model
+   Right click: clear the model
+*/
+
+void getSamplePoint( int event, int x, int y, int flags, void* ) {
       
-   extern char*   input_window_name;
+   extern const char* input_window_name;
+   extern const char* segmented_window_name;
    extern Mat     inputBGRImage; 
-   extern Point2f sample_point; 
    extern int     number_of_sample_points;
+   static Mat     annotatedImage;     // the input image with all the samples drawn on it
+   static uchar  *annotated_data = NULL;
+   static Point   drag_start;
    Mat            inputImageCopy;
+   Rect           region;
    int crossHairSize = 10;
 
-   if (event != EVENT_LBUTTONDOWN) {
-      return;
+   if (annotated_data != inputBGRImage.data || number_of_sample_points == 0) {  // a new input image or the model has been cleared
+      annotatedImage = inputBGRImage.clone();
+      annotated_data = inputBGRImage.data;
    }
-   else {
-      number_of_sample_points = 1;
-      sample_point.x = (float) x;
-      sample_point.y = (float) y;
 
-      inputImageCopy = inputBGRImage.clone();
+   switch (event) {
+
+   case EVENT_LBUTTONDOWN:
+      drag_start = Point(x, y);
+      break;
+
+   case EVENT_MOUSEMOVE:
+      if (flags & EVENT_FLAG_LBUTTON) {  // show the region being dragged
+         inputImageCopy = annotatedImage.clone();
+         rectangle(inputImageCopy, drag_start, Point(x, y), Scalar(0, 255, 0), 1, LINE_AA);
+         imshow(input_window_name, inputImageCopy);
+      }
+      break;
+
+   case EVENT_LBUTTONUP:
+      if (abs(x - drag_start.x) <= DRAG_TOLERANCE && abs(y - drag_start.y) <= DRAG_TOLERANCE) {
+         region = Rect(x, y, 1, 1);
+         line(annotatedImage,Point(x-crossHairSize/2,y),Point(x+crossHairSize/2,y),Scalar(0, 255, 0),1, LINE_AA); // Green
+         line(annotatedImage,Point(x,y-crossHairSize/2),Point(x,y+crossHairSize/2),Scalar(0, 255, 0),1, LINE_AA);
+      }
+      else {
+         region = Rect(Point(min(x, drag_start.x),     min(y, drag_start.y)), 
+                       Point(max(x, drag_start.x) + 1, max(y, drag_start.y) + 1));
+         rectangle(annotatedImage, region, Scalar(0, 255, 0), 1, LINE_AA);
+      }
 
-      line(inputImageCopy,Point(x-crossHairSize/2,y),Point(x+crossHairSize/2,y),Scalar(0, 255, 0),1, LINE_AA); // Green
-      line(inputImageCopy,Point(x,y-crossHairSize/2),Point(x,y+crossHairSize/2),Scalar(0, 255, 0),1, LINE_AA);
+      addColourSample(region);
 
-      imshow(input_window_name, inputImageCopy); // show the image with the cross-hairs
+      imshow(input_window_name, annotatedImage); // show the image with all the samples
       
       colourSegmentation(0, 0); // Show the segmented image for new colour sample and current thresholds
+      break;
+
+   case EVENT_RBUTTONDOWN:
+      clearColourModel();
+      annotatedImage = inputBGRImage.clone();
+      imshow(input_window_name, annotatedImage);
+      imshow(segmented_window_name, Mat::zeros(inputBGRImage.size(), inputBGRImage.type()));
+      break;
    }
 }
 
@@ -8,6 +8,9 @@
   It is assumed that the input file is located in a data directory given by the path ../data/ 
   defined relative to the location of executable for this application.
 
+  By default each pixel is the mean of the colour channels.  With the option --luminance, anywhere on the command line 
+  and also in batch mode, the ITU-R BT.601 luminance 0.299 R + 0.587 G + 0.114 B is used instead.
+
   (This is the application file: it contains the client code that calls dedicated functions to implement the application.
   The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
 
@@ -23,13 +26,43 @@
   Ported to Ubuntu 16.04 and OpenCV 3.3
   Abrham Gebreselasie
   10 March 2021
+
+  The --luminance option selects the GREYSCALE_LUMINANCE mode
+  17 October 2026
+
+  Headless batch mode: colourToGreyscale --batch <images> <output directory> [number of threads]
+  17 October 2026
   
 
 */
  
 #include "module5/colourToGreyscale.h"
 
-int main() {
+int main(int argc, char **argv) {
+
+   int mode = GREYSCALE_MEAN;
+   int i, j;
+
+   /* --luminance selects the luminance mode; it is removed so that the batch options keep their positions */
+
+   for (i = 1, j = 1; i < argc; i++) {
+      if (strcmp(argv[i], LUMINANCE_FLAG) == 0) {
+         mode = GREYSCALE_LUMINANCE;
+      }
+      else {
+         argv[j++] = argv[i];
+      }
+   }
+   argc = j;
+
+   /* headless batch mode: see batchProcessing.h */
+
+   batchOptionsType batch_options;
+
+   if (isBatchMode(argc, argv)) {
+      if (!getBatchOptions(argc, argv, &batch_options)) return 1;
+      return runBatch(batch_options, "colourToGreyscale", IMREAD_COLOR, colourToGreyscaleBatch, &mode);
+   }
 
    /* removing this stops a core dump on exit. DV 28/10/2021
    #ifdef ROS
@@ -84,7 +117,7 @@ int main() {
          strcpy(filename, file_path_and_filename);
 
          printf("\nConverting to greyscale a colour image in %s \n",filename);
-         colourToGreyscale(filename);
+         colourToGreyscale(filename, mode);
       }
    } while (end_of_file != EOF);
 
@@ -16,11 +16,21 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Replaced the per-pixel at<Vec3b>() conversion with colourToGreyscaleImage(): row pointers, a kernel specialised 
+  on the number of channels, rows split across threads with parallel_for_, and an optional luminance mode
+  17 October 2026
+
+  Removed the per-image timing message; see colourToGreyscaleBenchmark for the conversion time
+  17 October 2026
+
+  Added colourToGreyscaleBatch(): the core of the application for headless batch mode
+  17 October 2026
 */
  
 #include "module5/colourToGreyscale.h"
  
-void colourToGreyscale(char *filename) {
+void colourToGreyscale(char *filename, int mode) {
   
    char inputWindowName[MAX_STRING_LENGTH]   = "Input Image";
    char outputWindowName[MAX_STRING_LENGTH]  = "Greyscale Image";
@@ -28,11 +38,6 @@ void colourToGreyscale(char *filename) {
    Mat colourImage;
    Mat greyscaleImage;
 
-   int row;
-   int col;
-   int channel;
-   int temp;
-
    namedWindow(inputWindowName,   WINDOW_AUTOSIZE);  
    namedWindow(outputWindowName,  WINDOW_AUTOSIZE);
 
@@ -67,28 +72,9 @@ void colourToGreyscale(char *filename) {
   
    //CV_Assert(colourImage.type() == CV_8UC3);
 
-   // convert to greyscale by explicit access to colour image pixels
-   // we do this simply as an example of one way to access individual pixels
-   // see changeQuantisation() for a more efficient method that accesses pixels using pointers
+   // convert to greyscale using row pointers; see greyscaleRows()
   
-   greyscaleImage.create(colourImage.size(), CV_8UC1);
-  
-   for (row=0; row < colourImage.rows; row++) {
-      for (col=0; col < colourImage.cols; col++) {
-         temp = 0;
-         for (channel=0; channel < colourImage.channels(); channel++) {
-            if (colourImage.channels()== 1) { 
-			      // failsafe just in case the colour image is not a colour image or a multichannel image 
-			      //temp += colourImage.at<Vec3b>(row,col)[channel]; // don't use this
-			      temp += colourImage.at<uchar>(row,col);            // use this
-			   }
-			   else { 
-			      temp += colourImage.at<Vec3b>(row,col)[channel];
-			   }
-		   }
-         greyscaleImage.at<uchar>(row,col) = (uchar) (temp / colourImage.channels());
-      }
-   }
+   colourToGreyscaleImage(colourImage, greyscaleImage, mode);
 
    // alternative ... use OpenCV!!!
    // cvtColor(colourImage, greyscaleImage, COLOR_BGR2GRAY);
@@ -107,6 +93,93 @@ void colourToGreyscale(char *filename) {
 }
  
 
+/*=======================================================*/
+/* Greyscale conversion kernels                          */ 
+/*=======================================================*/
+
+/* greyscaleRows()
+
+   Convert rows [start, end) of an 8-bit image with N channels to greyscale
+
+   N is a template parameter so that the channel loop is unrolled and the division by N in the mean becomes a 
+   multiply and shift; with no branches in the column loop the compiler can vectorise it.
+
+   GREYSCALE_MEAN:      the equal-weight mean of the N channels, truncated, as in the original per-pixel code
+   GREYSCALE_LUMINANCE: the ITU-R BT.601 luminance 0.299 R + 0.587 G + 0.114 B of the first three (BGR) channels,
+                        in 14-bit fixed point with rounding; for N = 1 the image is copied
+*/
+
+template <int N>
+static void greyscaleRows(const Mat &colourImage, Mat &greyscaleImage, int mode, int start, int end) {
+
+   int row;
+   int col;
+   int channel;
+   int temp;
+
+   for (row = start; row < end; row++) {
+
+      const unsigned char *p_colour = colourImage.ptr<unsigned char>(row);
+      unsigned char *p_grey         = greyscaleImage.ptr<unsigned char>(row);
+
+      if (mode == GREYSCALE_LUMINANCE && N >= 3) {
+         for (col = 0; col < colourImage.cols; col++) {
+            p_grey[col] = (unsigned char) ((LUMINANCE_B * p_colour[N*col] + LUMINANCE_G * p_colour[N*col+1] + LUMINANCE_R * p_colour[N*col+2] 
+                                            + (1 << (LUMINANCE_SHIFT-1))) >> LUMINANCE_SHIFT);
+         }
+      }
+      else {
+         for (col = 0; col < colourImage.cols; col++) {
+            temp = 0;
+            for (channel = 0; channel < N; channel++) {
+               temp += p_colour[N*col+channel];
+            }
+            p_grey[col] = (unsigned char) (temp / N);
+         }
+      }
+   }
+}
+
+
+/* colourToGreyscaleImage()
+
+   Convert an 8-bit image with 1 to 4 channels to a CV_8UC1 greyscale image, splitting the rows across threads
+   mode is GREYSCALE_MEAN or GREYSCALE_LUMINANCE; see greyscaleRows()
+*/
+
+void colourToGreyscaleImage(const Mat &colourImage, Mat &greyscaleImage, int mode) {
+
+   CV_Assert(colourImage.depth() == CV_8U && colourImage.channels() >= 1 && colourImage.channels() <= 4);
+
+   greyscaleImage.create(colourImage.size(), CV_8UC1);
+
+   parallel_for_(Range(0, colourImage.rows), [&](const Range &range) {
+      switch (colourImage.channels()) {
+      case 1:  greyscaleRows<1>(colourImage, greyscaleImage, mode, range.start, range.end); break;
+      case 2:  greyscaleRows<2>(colourImage, greyscaleImage, mode, range.start, range.end); break;
+      case 3:  greyscaleRows<3>(colourImage, greyscaleImage, mode, range.start, range.end); break;
+      default: greyscaleRows<4>(colourImage, greyscaleImage, mode, range.start, range.end); break;
+      }
+   });
+}
+
+
+/*
+ * colourToGreyscaleBatch
+ * Batch mode: convert the image and write <output_stem>_greyscale.png
+ * context points to the mode, GREYSCALE_MEAN or GREYSCALE_LUMINANCE; if it is NULL, GREYSCALE_MEAN is used
+ */
+
+bool colourToGreyscaleBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   Mat greyscaleImage;
+
+   colourToGreyscaleImage(image, greyscaleImage, context != NULL ? *(const int *) context : GREYSCALE_MEAN);
+
+   return imwrite(string(output_stem) + "_greyscale.png", greyscaleImage);
+}
+
+
 /*=======================================================*/
 /* Utility functions to prompt user to continue          */ 
 /*=======================================================*/
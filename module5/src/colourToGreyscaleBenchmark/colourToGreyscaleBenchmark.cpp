@@ -0,0 +1,97 @@
+/*
+  Benchmark of the colour to greyscale conversion
+  -----------------------------------------------
+
+  Times colourToGreyscaleImage() against the original per-pixel conversion with at<Vec3b>(), reproduced below as
+  the reference, on images from the data/Media directory resized to 640 x 480, 1920 x 1080, and 3840 x 2160.
+
+  GREYSCALE_MEAN must give exactly the same image as the reference.  GREYSCALE_LUMINANCE is timed against
+  cvtColor(COLOR_BGR2GRAY), which uses the same BT.601 weights; its output may differ from cvtColor by at most
+  LUMINANCE_TOLERANCE grey levels because OpenCV rounds differently in its vectorised path.
+
+  The images are given on the command line, relative to data/Media (see module5/imageBenchmark.h).
+  Each time is the shortest of BENCHMARK_REPETITIONS runs.
+
+  The exit status is 0 if both checks pass for every image and 1 otherwise.
+
+  Audit Trail
+  --------------------
+  17 October 2026: created
+  17 October 2026: the image list, sizes, and timer are shared with the other benchmarks in module5/imageBenchmark.h
+*/
+
+#include "module5/colourToGreyscale.h"
+#include "module5/imageBenchmark.h"
+
+#define LUMINANCE_TOLERANCE   1
+
+
+/* the original conversion: explicit access to each pixel with at<>() */
+
+static void referenceGreyscale(const Mat &colourImage, Mat &greyscaleImage) {
+
+   int row;
+   int col;
+   int channel;
+   int temp;
+
+   greyscaleImage.create(colourImage.size(), CV_8UC1);
+
+   for (row=0; row < colourImage.rows; row++) {
+      for (col=0; col < colourImage.cols; col++) {
+         temp = 0;
+         for (channel=0; channel < colourImage.channels(); channel++) {
+            if (colourImage.channels()== 1) {
+               temp += colourImage.at<uchar>(row,col);
+            }
+            else {
+               temp += colourImage.at<Vec3b>(row,col)[channel];
+            }
+         }
+         greyscaleImage.at<uchar>(row,col) = (uchar) (temp / colourImage.channels());
+      }
+   }
+}
+
+
+int main(int argc, char **argv) {
+
+   int  number_of_images = numberOfBenchmarkImages(argc, argv);
+   int  i, k;
+   bool passed = true;
+
+   Mat original, colourImage;
+   Mat greyReference, greyMean, greyOpenCV, greyLuminance;
+   double reference_ms, mean_ms, opencv_ms, luminance_ms;
+   double mean_difference, luminance_difference;
+
+   printf("%-20s %11s %14s %10s %12s %14s %s\n", "image", "size", "reference ms", "mean ms", "cvtColor ms", "luminance ms", "max difference");
+
+   for (i = 0; i < number_of_images; i++) {
+
+      if (!readBenchmarkImage(argc, argv, i, original)) {
+         return 1;
+      }
+
+      for (k = 0; k < NUMBER_OF_BENCHMARK_SIZES; k++) {
+
+         resize(original, colourImage, benchmark_sizes[k], 0, 0, INTER_LINEAR);
+
+         reference_ms = shortestTime([&] { referenceGreyscale(colourImage, greyReference); });
+         mean_ms      = shortestTime([&] { colourToGreyscaleImage(colourImage, greyMean, GREYSCALE_MEAN); });
+         opencv_ms    = shortestTime([&] { cvtColor(colourImage, greyOpenCV, COLOR_BGR2GRAY); });
+         luminance_ms = shortestTime([&] { colourToGreyscaleImage(colourImage, greyLuminance, GREYSCALE_LUMINANCE); });
+
+         mean_difference      = norm(greyReference, greyMean, NORM_INF);
+         luminance_difference = norm(greyOpenCV, greyLuminance, NORM_INF);
+
+         passed = passed && mean_difference == 0 && luminance_difference <= LUMINANCE_TOLERANCE;
+
+         printf("%-20s %5d x %4d %14.2f %10.2f %12.2f %14.2f %7.0f / %.0f\n", benchmarkImageName(argc, argv, i),
+                colourImage.cols, colourImage.rows, reference_ms, mean_ms, opencv_ms, luminance_ms, mean_difference, luminance_difference);
+      }
+   }
+
+   printf(passed ? "colourToGreyscaleBenchmark: passed\n" : "colourToGreyscaleBenchmark: FAILED\n");
+   return passed ? 0 : 1;
+}
@@ -16,6 +16,16 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Replaced the per-pixel at<Vec3b>() conversion with rgb2hsiImage(): row pointers, a factorised hue/saturation
+  lookup table, and rows split across threads with parallel_for_
+  17 October 2026
+
+  Removed the per-image timing message; see colourToHISBenchmark for the conversion time
+  17 October 2026
+
+  Added colourToHISBatch(): the core of the application for headless batch mode
+  17 October 2026
 */
  
 #include "module5/colourToHIS.h"
@@ -32,15 +42,6 @@ void colourToHIS(char *filename) {
    Mat intensityImage;  
    Mat saturationImage;
 
-   int row;
-   int col;
-   unsigned char red;
-   unsigned char green;
-   unsigned char blue;
-   float hue;
-   float saturation;
-   float intensity;
-
    namedWindow(inputWindowName,      WINDOW_AUTOSIZE);  
    namedWindow(hueWindowName,        WINDOW_AUTOSIZE);
    namedWindow(intensityWindowName,  WINDOW_AUTOSIZE);
@@ -59,28 +60,11 @@ void colourToHIS(char *filename) {
   
    CV_Assert(colourImage.type() == CV_8UC3 );
 
-   // convert to HIS by explicit access to colour image pixels
-   // we do this simply as an example of one way to access individual pixels
-   // see changeQuantisation() for a more efficient method that accesses pixel using pointers
-  
-   hueImage.create(colourImage.size(), CV_8UC1);
-   saturationImage.create(colourImage.size(), CV_8UC1);
-   intensityImage.create(colourImage.size(), CV_8UC1);
+   // convert to HIS using row pointers and the hue/saturation lookup table
+   // see rgb2hsi() for the transform applied to each pixel
 
-	for (row=0; row < colourImage.rows; row++) {
-		for (col=0; col < colourImage.cols; col++) {
-	      blue  = colourImage.at<Vec3b>(row,col)[0];
-         green = colourImage.at<Vec3b>(row,col)[1];
-         red   = colourImage.at<Vec3b>(row,col)[2];
+   rgb2hsiImage(colourImage, hueImage, saturationImage, intensityImage);
 
-         rgb2hsi(red, green, blue, &hue, &saturation, &intensity);
-         hueImage.at<uchar>(row,col)        = (char)  (255.0  * (hue/360.0));
-         saturationImage.at<uchar>(row,col) = (char)  (saturation * 255);
-         intensityImage.at<uchar>(row,col)  = (char)  (intensity * 255);
- 
-      }
-   }
- 
    imshow(hueWindowName,       hueImage); 
    imshow(intensityWindowName, intensityImage); 
    imshow(saturationWindowName,saturationImage); 
@@ -110,8 +94,7 @@ void colourToHIS(char *filename) {
 
 void rgb2hsi(unsigned char red, unsigned char green, unsigned char blue, float *hue, float *saturation, float *intensity){
 
-	double y, h, h_star, c, c1, c2,  s, r, g, b; 
-   int min =256;
+	double c1, c2, r, g, b; 
 
    //  0 <= hue <= 2 pi
    //  0 <= saturation <= 1
@@ -120,10 +103,30 @@ void rgb2hsi(unsigned char red, unsigned char green, unsigned char blue, float *
    g = (float) green / 256;
    b = (float) blue  / 256;
 
-   y  = 0.2125 * r + 0.7154 * g + 0.0721 * b;
    c1 =          r - 0.5    * g - 0.5    * b;
    c2 =            - 0.8660 * g + 0.8660 * b;
 
+   chroma2hs(c1, c2, hue, saturation);
+
+ 	*intensity  = (float)  (r+g+b)/3;
+
+  // printf("rgb2hsi: (%d, %d, %d) -> (%3.1f, %3.1f, %3.1f)\n", red, green, blue, *hue, *saturation, *intensity);
+
+}
+
+
+// -----------------------------------------------------------------------------------------------
+// chroma2hs
+//
+// hue and saturation from the two chromatic components c1 and c2 of [Hanbury02]
+//
+// Hue and saturation depend on r, g, and b only through c1 and c2, which is what allows the lookup table 
+// used by rgb2hsiImage() to be indexed by two small integers rather than by the full RGB triple
+// -----------------------------------------------------------------------------------------------
+
+void chroma2hs(double c1, double c2, float *hue, float *saturation) {
+
+	double h, h_star, c, s; 
 
    // chroma c: [0,1]
 
@@ -159,13 +162,142 @@ void rgb2hsi(unsigned char red, unsigned char green, unsigned char blue, float *
       *hue        = (float)  h;  
       *saturation = (float)  s;
    }
+}
 
- 	*intensity  = (float)  (r+g+b)/3;
 
-  // printf("rgb2hsi: (%d, %d, %d) -> (%3.1f, %3.1f, %3.1f)\n", red, green, blue, *hue, *saturation, *intensity);
+// -----------------------------------------------------------------------------------------------
+// hsiLookupTable
+//
+// Factorised lookup table for the 8-bit hue and saturation images
+//
+// With r = red/256 etc., c1 = (2 red - green - blue) / 512 and c2 = 0.8660 (blue - green) / 256,
+// so the table is indexed by u = 2 red - green - blue in [-510, 510] and v = blue - green in [-255, 255]:
+// 1021 x 511 entries of two bytes (hue, saturation), about 1 MB, instead of 16M entries for the full RGB cube.
+//
+// The table is built on first use; initialisation of a function-local static is thread-safe in C++11
+// -----------------------------------------------------------------------------------------------
+
+static const unsigned char *hsiLookupTable() {
+
+   static const std::vector<unsigned char> table = [] {
 
+      std::vector<unsigned char> t(2 * HSI_LUT_U_SIZE * HSI_LUT_V_SIZE);
+      float hue;
+      float saturation;
+      int u, v;
+      unsigned char *entry = &t[0];
+
+      for (u = -HSI_LUT_U_OFFSET; u <= HSI_LUT_U_OFFSET; u++) {
+         for (v = -HSI_LUT_V_OFFSET; v <= HSI_LUT_V_OFFSET; v++) {
+            chroma2hs(u / 512.0, 0.8660 * v / 256.0, &hue, &saturation);
+            *entry++ = (unsigned char) (255.0  * (hue/360.0));
+            *entry++ = (unsigned char) (saturation * 255);
+         }
+      }
+      return t;
+   }();
+
+   return &table[0];
+}
+
+
+// -----------------------------------------------------------------------------------------------
+// rgb2hsiImage
+//
+// convert a CV_8UC3 BGR image to 8-bit hue, saturation, and intensity images
+// hue [0,360) is scaled to [0,255), saturation and intensity [0,1] to [0,255]
+//
+// Each row is processed with raw pointers and the rows are split across threads with parallel_for_
+// With use_lut set, hue and saturation are read from hsiLookupTable(); otherwise each pixel is converted 
+// with rgb2hsi().  The intensity (red+green+blue)/768 * 255 is computed exactly in integer arithmetic as 
+// ((red+green+blue) * 85) >> 8 in both cases.
+// -----------------------------------------------------------------------------------------------
+
+void rgb2hsiImage(const Mat &colourImage, Mat &hueImage, Mat &saturationImage, Mat &intensityImage, bool use_lut) {
+
+   const unsigned char *lut = NULL;
+
+   CV_Assert(colourImage.type() == CV_8UC3);
+
+   hueImage.create(colourImage.size(), CV_8UC1);
+   saturationImage.create(colourImage.size(), CV_8UC1);
+   intensityImage.create(colourImage.size(), CV_8UC1);
+
+   if (use_lut) {
+      lut = hsiLookupTable();   // built here, before the worker threads start
+   }
+
+   parallel_for_(Range(0, colourImage.rows), [&](const Range &range) {
+
+      int row;
+      int col;
+      int blue, green, red;
+      int index;
+      float hue;
+      float saturation;
+      float intensity;
+
+      for (row = range.start; row < range.end; row++) {
+
+         const unsigned char *p_colour = colourImage.ptr<unsigned char>(row);
+         unsigned char *p_hue          = hueImage.ptr<unsigned char>(row);
+         unsigned char *p_saturation   = saturationImage.ptr<unsigned char>(row);
+         unsigned char *p_intensity    = intensityImage.ptr<unsigned char>(row);
+
+         /* intensity: a separate pass with no table access so that the compiler can vectorise it */
+
+         for (col = 0; col < colourImage.cols; col++) {
+            p_intensity[col] = (unsigned char) (((p_colour[3*col] + p_colour[3*col+1] + p_colour[3*col+2]) * 85) >> 8);
+         }
+
+         if (lut != NULL) {
+            for (col = 0; col < colourImage.cols; col++) {
+               blue  = p_colour[3*col];
+               green = p_colour[3*col+1];
+               red   = p_colour[3*col+2];
+
+               index = 2 * ((2*red - green - blue + HSI_LUT_U_OFFSET) * HSI_LUT_V_SIZE + (blue - green + HSI_LUT_V_OFFSET));
+
+               p_hue[col]        = lut[index];
+               p_saturation[col] = lut[index+1];
+            }
+         }
+         else {
+            for (col = 0; col < colourImage.cols; col++) {
+               rgb2hsi(p_colour[3*col+2], p_colour[3*col+1], p_colour[3*col], &hue, &saturation, &intensity);
+               p_hue[col]        = (unsigned char) (255.0  * (hue/360.0));
+               p_saturation[col] = (unsigned char) (saturation * 255);
+            }
+         }
+      }
+   });
+}
+
+
+// -----------------------------------------------------------------------------------------------
+// colourToHISBatch
+//
+// batch mode: write the hue, saturation, and intensity images to <output_stem>_hue.png,
+// <output_stem>_saturation.png, and <output_stem>_intensity.png
+// -----------------------------------------------------------------------------------------------
+
+bool colourToHISBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   Mat hueImage;   
+   Mat saturationImage;
+   Mat intensityImage;  
+   bool ok;
+
+   rgb2hsiImage(image, hueImage, saturationImage, intensityImage);
+
+   ok =       imwrite(string(output_stem) + "_hue.png",        hueImage);
+   ok = ok && imwrite(string(output_stem) + "_saturation.png", saturationImage);
+   ok = ok && imwrite(string(output_stem) + "_intensity.png",  intensityImage);
+
+   return ok;
 }
 
+
 /*=======================================================*/
 /* Utility functions to prompt user to continue          */ 
 /*=======================================================*/
@@ -0,0 +1,61 @@
+/*
+  Benchmark of the colour to HIS conversion
+  -----------------------------------------
+
+  Times rgb2hsiImage() with the hue/saturation lookup table against the reference per-pixel conversion with rgb2hsi()
+  (use_lut = false) on images from the data/Media directory resized to 640 x 480, 1920 x 1080, and 3840 x 2160,
+  and checks that the two give identical hue, saturation, and intensity images.
+
+  The images are given on the command line, relative to data/Media (see module5/imageBenchmark.h).
+  Each time is the shortest of BENCHMARK_REPETITIONS runs.
+
+  The exit status is 0 if the outputs are identical for every image and 1 otherwise.
+
+  Audit Trail
+  --------------------
+  17 October 2026: created
+  17 October 2026: the image list, sizes, and timer are shared with the other benchmarks in module5/imageBenchmark.h
+*/
+
+#include "module5/colourToHIS.h"
+#include "module5/imageBenchmark.h"
+
+
+int main(int argc, char **argv) {
+
+   int  number_of_images = numberOfBenchmarkImages(argc, argv);
+   int  i, k;
+   bool identical = true;
+
+   Mat original, colourImage;
+   Mat hueLut, saturationLut, intensityLut;
+   Mat hueRef, saturationRef, intensityRef;
+   double lut_ms, reference_ms;
+
+   printf("%-20s %11s %14s %10s %8s %s\n", "image", "size", "reference ms", "LUT ms", "speedup", "outputs");
+
+   for (i = 0; i < number_of_images; i++) {
+
+      if (!readBenchmarkImage(argc, argv, i, original)) {
+         return 1;
+      }
+
+      for (k = 0; k < NUMBER_OF_BENCHMARK_SIZES; k++) {
+
+         resize(original, colourImage, benchmark_sizes[k], 0, 0, INTER_LINEAR);
+
+         reference_ms = shortestTime([&] { rgb2hsiImage(colourImage, hueRef, saturationRef, intensityRef, false); });
+         lut_ms       = shortestTime([&] { rgb2hsiImage(colourImage, hueLut, saturationLut, intensityLut, true);  });
+
+         bool same = norm(hueRef, hueLut, NORM_INF) == 0 && norm(saturationRef, saturationLut, NORM_INF) == 0 &&
+                     norm(intensityRef, intensityLut, NORM_INF) == 0;
+         identical = identical && same;
+
+         printf("%-20s %5d x %4d %14.2f %10.2f %7.1fx %s\n", benchmarkImageName(argc, argv, i),
+                colourImage.cols, colourImage.rows, reference_ms, lut_ms, reference_ms / lut_ms, same ? "identical" : "DIFFERENT");
+      }
+   }
+
+   printf(identical ? "colourToHISBenchmark: passed\n" : "colourToHISBenchmark: FAILED\n");
+   return identical ? 0 : 1;
+}
@@ -29,6 +29,9 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Headless batch mode: connectedComponents --batch <images> <output directory> [number of threads]
+  17 October 2026
 */
 
 #include "module5/connectedComponents.h"
@@ -44,7 +47,16 @@ const char* thresholded_window_name = "Thresholded Image";
 const char* components_window_name  = "Connected Components";
 
 
-int main() {
+int main(int argc, char **argv) {
+
+   /* headless batch mode: see batchProcessing.h */
+
+   batchOptionsType batch_options;
+
+   if (isBatchMode(argc, argv)) {
+      if (!getBatchOptions(argc, argv, &batch_options)) return 1;
+      return runBatch(batch_options, "connectedComponents", IMREAD_UNCHANGED, connectedComponentsBatch, NULL);
+   }
    
    #ifdef ROS
       // Turn off canonical terminal mode and character echoing
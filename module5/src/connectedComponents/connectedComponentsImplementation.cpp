@@ -16,6 +16,21 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Replaced findContours() and drawContours() with labelComponents(), a run-length union-find labeller with 
+  8-connectivity that computes the area, bounding box, centroid, and second moments of each component as it labels
+  17 October 2026
+
+  Removed the time printed on every trackbar event; the number of components is shown in the title of the
+  components window
+  17 October 2026
+
+  The image is thresholded straight to a run-length encoded image and labelled with labelRuns() from the 
+  runLengthEncoding library, which replaces labelComponents(); the number of runs is also shown in the title
+  17 October 2026
+
+  Added connectedComponentsBatch(): the core of the application for headless batch mode
+  17 October 2026
 */
  
 #include "module5/connectedComponents.h"
@@ -32,11 +47,17 @@ void connectedComponents(int, void*) {
    extern char* thresholded_window_name;
    extern char* components_window_name;
    
+   bool debug = false;
+
    Mat greyscaleImage;
    Mat thresholdedImage; 
-   
-   vector <vector<Point> > contours;
-	vector<Vec4i> hierarchy;
+   static runLengthImageType thresholdedRuns;   // kept between calls so that the run buffers are reused
+   vector<int> run_label;
+   vector<componentStatisticsType> statistics;
+   vector<Vec3b> colours;
+   int number_of_components;
+   int i;
+   char title[MAX_STRING_LENGTH * 3];
 
    if (thresholdValue < 1)  // the trackbar has a lower value of 0 which is invalid
       thresholdValue = 1;
@@ -48,22 +69,109 @@ void connectedComponents(int, void*) {
       greyscaleImage = inputImage.clone();
    }
 
-   threshold(greyscaleImage,thresholdedImage,thresholdValue, 255,THRESH_BINARY);
+   /* threshold straight to runs; the components are labelled and measured on the runs */
+
+   thresholdToRuns(greyscaleImage, thresholdValue, THRESH_BINARY, thresholdedRuns);
+
+   number_of_components = labelRuns(thresholdedRuns, 8, run_label, &statistics);
+
+   if (debug) {
+      for (i = 1; i <= number_of_components; i++) {
+         printf("Component %d: area %.0f, bounding box (%d, %d) - (%d, %d), centroid (%.1f, %.1f), mu20 %.1f, mu11 %.1f, mu02 %.1f\n",
+                i, statistics[i].area, statistics[i].left, statistics[i].top, statistics[i].right, statistics[i].bottom,
+                statistics[i].centroid_x, statistics[i].centroid_y, statistics[i].mu20, statistics[i].mu11, statistics[i].mu02);
+      }
+   }
+
+   runsToBinary(thresholdedRuns, thresholdedImage);
 
    imshow(thresholded_window_name, thresholdedImage);
 
-	findContours(thresholdedImage,contours,hierarchy,RETR_TREE,CHAIN_APPROX_NONE);
-	Mat contours_image = Mat::zeros(inputImage.size(), CV_8UC3);
-	for (int contour_number=0; (contour_number<(int)contours.size()); contour_number++)
-	{
-        Scalar colour( rand()&0xFF, rand()&0xFF, rand()&0xFF );
-        drawContours( contours_image, contours, contour_number, colour, FILLED, 8, hierarchy );
-	}
+   /* one random colour per component, drawn run by run on a black background */
+
+   colours.resize(number_of_components + 1);
+   for (i = 1; i <= number_of_components; i++) {
+      colours[i] = Vec3b(rand()&0xFF, rand()&0xFF, rand()&0xFF);
+   }
+
+   Mat components_image = Mat::zeros(inputImage.size(), CV_8UC3);
+
+   parallel_for_(Range(0, thresholdedRuns.rows), [&](const Range &range) {
+      for (int row = range.start; row < range.end; row++) {
+         Vec3b *p_components = components_image.ptr<Vec3b>(row);
+         for (int r = thresholdedRuns.row_start[row]; r < thresholdedRuns.row_start[row + 1]; r++) {
+            for (int col = thresholdedRuns.runs[r].start; col <= thresholdedRuns.runs[r].end; col++) {
+               p_components[col] = colours[run_label[r]];
+            }
+         }
+      }
+   });
+
+   imshow(components_window_name, components_image);
+
+   snprintf(title, sizeof(title), "%s: threshold %d, %d components, %d runs (compression %.1f)", components_window_name,
+            thresholdValue, number_of_components, (int) thresholdedRuns.runs.size(), runCompression(thresholdedRuns));
+   setWindowTitle(components_window_name, title);
+
+}
+
 
-   imshow(components_window_name, contours_image);
+/*
+ * function connectedComponentsBatch
+ * Batch mode: label the components at the default threshold and write the labels to <output_stem>_labels.png,
+ * a 16-bit image, and the statistics of each component to <output_stem>_components.txt
+ */
+
+bool connectedComponentsBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   extern int thresholdValue; 
+
+   Mat greyscaleImage;
+   Mat labels;
+   Mat labels_16bit;
+   runLengthImageType thresholdedRuns;
+   vector<int> run_label;
+   vector<componentStatisticsType> statistics;
+   int number_of_components;
+   FILE *fp_out;
+   bool ok;
+   int i;
+
+   if (image.type() == CV_8UC3) { // colour image
+      cvtColor(image, greyscaleImage, COLOR_BGR2GRAY);
+   } 
+   else {
+      greyscaleImage = image;
+   }
 
+   if (greyscaleImage.type() != CV_8UC1) {
+      printf("Error: %s is not an 8-bit greyscale or colour image\n", image_filename);
+      return false;
+   }
+
+   thresholdToRuns(greyscaleImage, max(thresholdValue, 1), THRESH_BINARY, thresholdedRuns);
+
+   number_of_components = labelRuns(thresholdedRuns, 8, run_label, &statistics);
+
+   runLabelsToImage(thresholdedRuns, run_label, labels);
+   labels.convertTo(labels_16bit, CV_16U);   // labels above 65535 saturate
+
+   ok = imwrite(string(output_stem) + "_labels.png", labels_16bit);
+
+   if ((fp_out = fopen((string(output_stem) + "_components.txt").c_str(), "w")) == 0) return false;
+
+   fprintf(fp_out, "%d components\n", number_of_components);
+   for (i = 1; i <= number_of_components; i++) {
+      fprintf(fp_out, "Component %d: area %.0f, bounding box (%d, %d) - (%d, %d), centroid (%.1f, %.1f), mu20 %.1f, mu11 %.1f, mu02 %.1f\n",
+              i, statistics[i].area, statistics[i].left, statistics[i].top, statistics[i].right, statistics[i].bottom,
+              statistics[i].centroid_x, statistics[i].centroid_y, statistics[i].mu20, statistics[i].mu11, statistics[i].mu02);
+   }
+   fclose(fp_out);
+
+   return ok;
 }
 
+
 void prompt_and_exit(int status) {
    printf("Press any key to continue and close terminal ... \n");
    getchar();
@@ -29,6 +29,9 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Headless batch mode: contourExtraction --batch <images> <output directory> [number of threads]
+  17 October 2026
 */
  
 #include "module5/contourExtraction.h"
@@ -48,7 +51,16 @@ const char* input_window_name        = "Input Image";
 
 int view;
 
-int main() {
+int main(int argc, char **argv) {
+
+   /* headless batch mode: see batchProcessing.h */
+
+   batchOptionsType batch_options;
+
+   if (isBatchMode(argc, argv)) {
+      if (!getBatchOptions(argc, argv, &batch_options)) return 1;
+      return runBatch(batch_options, "contourExtraction", IMREAD_COLOR, contourExtractionBatch, NULL);
+   }
    
    #ifdef ROS
       // Turn off canonical terminal mode and character echoing
@@ -12,6 +12,13 @@
   --------------------
   Added _kbhit
   18 February 2021
+
+  Trace the contours on the run-length encoding of the edge image with traceContours() instead of findContours();
+  the contours and hierarchy are identical and the edge image no longer needs to be cloned
+  17 October 2026
+
+  Added contourExtractionBatch(): the core of the application for headless batch mode
+  17 October 2026
     
 */
  
@@ -38,6 +45,7 @@ void ContourExtraction(int, void*) {
    int filter_size;
    vector <vector<Point> > contours;
 	vector<Vec4i> hierarchy;
+   static runLengthImageType edge_runs;
    Mat thresholdedImage; 
 
    filter_size = gaussian_std_dev * 4 + 1;  // multiplier must be even to ensure an odd filter size as required by OpenCV
@@ -49,11 +57,11 @@ void ContourExtraction(int, void*) {
 
    Canny( src_blur, detected_edges, cannyThreshold, cannyThreshold*ratio, kernel_size );
 
-   Mat canny_edge_image_copy = detected_edges.clone();   // clone the edge image because findContours overwrites it
-
+   /* traceContours() returns the same contours and hierarchy as findContours() with RETR_TREE and CHAIN_APPROX_NONE */
    /* see http://docs.opencv.org/2.4/modules/imgproc/doc/structural_analysis_and_shape_descriptors.html#findcontours */
    /* and http://docs.opencv.org/2.4/doc/tutorials/imgproc/shapedescriptors/find_contours/find_contours.html         */
-	findContours(canny_edge_image_copy,contours,hierarchy,RETR_TREE,CHAIN_APPROX_NONE);
+   binaryToRuns(detected_edges, edge_runs);
+   traceContours(edge_runs, contours, hierarchy);
 
    Mat contours_image = Mat::zeros(src.size(), CV_8UC3);       // draw the contours on a black background
  
@@ -68,6 +76,50 @@ void ContourExtraction(int, void*) {
    imshow( contour_window_name, contours_image );
 }
 
+
+/*
+ * contourExtractionBatch
+ * Batch mode: extract the contours with the default standard deviation and threshold, and write the Canny edge image
+ * to <output_stem>_edges.png and the contours, in white on black, to <output_stem>_contours.png
+ */
+
+bool contourExtractionBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   extern int cannyThreshold; 
+   extern int gaussian_std_dev; 
+
+   int ratio = 3;
+   int kernel_size = 3;
+   int filter_size;
+   vector <vector<Point> > contours;
+	vector<Vec4i> hierarchy;
+   runLengthImageType edge_runs;
+   Mat src_gray;
+   Mat src_blur;
+   Mat detected_edges;
+   bool ok;
+
+   filter_size = gaussian_std_dev * 4 + 1;  // as in ContourExtraction()
+
+   cvtColor(image, src_gray, COLOR_BGR2GRAY);
+
+   GaussianBlur(src_gray, src_blur, Size(filter_size,filter_size), gaussian_std_dev);
+
+   Canny( src_blur, detected_edges, cannyThreshold, cannyThreshold*ratio, kernel_size );
+
+   binaryToRuns(detected_edges, edge_runs);
+   traceContours(edge_runs, contours, hierarchy);
+
+   Mat contours_image = Mat::zeros(image.size(), CV_8UC1);
+   drawContours(contours_image, contours, -1, Scalar(255));
+
+   ok =       imwrite(string(output_stem) + "_edges.png",    detected_edges);
+   ok = ok && imwrite(string(output_stem) + "_contours.png", contours_image);
+
+   return ok;
+}
+
+
 void prompt_and_exit(int status) {
    printf("Press any key to continue and close terminal ... \n");
    getchar();
@@ -25,11 +25,14 @@
   David Vernon
   1 november 2022
 
+  Headless batch mode: faceDetection --batch <images> <output directory> [number of threads]
+  17 October 2026
+
 */
  
 #include "module5/faceDetection.h"
 
-int main() {
+int main(int argc, char **argv) {
 
    const char input_filename[MAX_FILENAME_LENGTH] = "faceDetectionInput.txt";    
    char input_path_and_filename[MAX_FILENAME_LENGTH];    
@@ -49,6 +52,29 @@ int main() {
    #endif
    
    strcat(data_dir, "/data/");
+
+   /* headless batch mode: see batchProcessing.h                                                           */
+   /* each worker thread has its own classifier because detectMultiScale() is not safe to call concurrently */
+
+   batchOptionsType batch_options;
+   vector<CascadeClassifier> batch_cascades;
+
+   if (isBatchMode(argc, argv)) {
+      if (!getBatchOptions(argc, argv, &batch_options)) return 1;
+
+      string cascade_filename(data_dir);
+      cascade_filename.append("/Media/haarcascades/haarcascade_frontalface_alt.xml");
+
+      batch_cascades.resize(batch_options.number_of_threads);
+      for (int worker = 0; worker < batch_options.number_of_threads; worker++) {
+         if (!batch_cascades[worker].load(cascade_filename)) {
+            cout << "Cannot load cascade file: " << cascade_filename << endl;
+            return 1;
+         }
+      }
+      return runBatch(batch_options, "faceDetection", IMREAD_COLOR, faceDetectionBatch, &batch_cascades);
+   }
+
    strcpy(input_path_and_filename, data_dir);
    strcat(input_path_and_filename, input_filename);
 
@@ -15,6 +15,11 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Audit Trail
+  --------------------
+  Added faceDetectionBatch(): the core of the application for headless batch mode
+  17 October 2026
 */
 
 #include "module5/faceDetection.h"
@@ -125,7 +130,42 @@ void faceDetection(char *filename, CascadeClassifier& cascade) {
     
    destroyWindow(outputWindowName);  
 }
- 
+
+
+/*
+ * faceDetectionBatch
+ * Batch mode: write the image with the detected faces outlined to <output_stem>_faces.png and the face rectangles,
+ * one per line as x y width height, to <output_stem>_faces.txt
+ * context is a vector<CascadeClassifier> with one classifier for each worker thread
+ */
+
+bool faceDetectionBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   CascadeClassifier &cascade = (*(vector<CascadeClassifier> *) context)[worker];
+   Mat outputImage;
+   Mat gray;
+   vector<Rect> faces;
+   FILE *fp_out;
+   bool ok;
+
+   cvtColor(image, gray, COLOR_BGR2GRAY );
+   equalizeHist(gray, gray );
+   cascade.detectMultiScale( gray, faces, 1.1, 2, CASCADE_SCALE_IMAGE, Size(30, 30) );
+
+   outputImage = image.clone();
+   for (int count = 0; count < (int)faces.size(); count++ )
+      rectangle(outputImage, faces[count], cv::Scalar(255,0,0), 2);
+
+   ok = imwrite(string(output_stem) + "_faces.png", outputImage);
+
+   if ((fp_out = fopen((string(output_stem) + "_faces.txt").c_str(), "w")) == 0) return false;
+
+   for (int count = 0; count < (int)faces.size(); count++ )
+      fprintf(fp_out, "%d %d %d %d\n", faces[count].x, faces[count].y, faces[count].width, faces[count].height);
+   fclose(fp_out);
+
+   return ok;
+}
 
 
 /*=======================================================*/
@@ -16,7 +16,10 @@
      Convex cavities
      Hu moments
 
-  The features for each image are written to the output file.
+  The features for each image are written to the binary feature file featureExtractionOutput.fea, one block per image
+  with one record per object and hole (see featureFile.h).  featureFileToText converts it to text.
+  With the option --append, anywhere on the command line and also in batch mode, the blocks are added to the end of
+  an existing feature file instead of replacing it; the file is checked first and is not changed if it is damaged.
 
   (This is the application file: it contains the client code that calls dedicated functions to implement the application.
   The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
@@ -33,13 +36,61 @@
   Ported to Ubuntu 16.04 and OpenCV 3.3
   Abrham Gebreselasie
   10 March 2021
+
+  Write the features to the binary feature file featureExtractionOutput.fea instead of featureExtractionOutput.txt
+  17 October 2026
+
+  The --append option adds the features to an existing feature file: see openFeatureFile()
+  17 October 2026
+
+  Headless batch mode: featureExtraction --batch <images> <output directory> [number of threads]
+  17 October 2026
   
 
 */
  
 #include "module5/featureExtraction.h"
 
-int main() {
+int main(int argc, char **argv) {
+
+   bool append = false;
+   int  i, j;
+
+   /* --append selects append mode; it is removed so that the batch options keep their positions */
+
+   for (i = 1, j = 1; i < argc; i++) {
+      if (strcmp(argv[i], APPEND_FLAG) == 0) {
+         append = true;
+      }
+      else {
+         argv[j++] = argv[i];
+      }
+   }
+   argc = j;
+
+   /* headless batch mode: see batchProcessing.h                                           */
+   /* the features of all the images go into one feature file in the output directory      */
+
+   batchOptionsType batch_options;
+   featureBatchType batch_features;
+   char             batch_output[BATCH_MAX_FILENAME + 32];
+   int              batch_status;
+
+   if (isBatchMode(argc, argv)) {
+      if (!getBatchOptions(argc, argv, &batch_options)) return 1;
+
+      sprintf(batch_output, "%s/featureExtractionOutput.fea", batch_options.output_directory);
+
+      if ((batch_features.fp_out = openFeatureFile(batch_output, append)) == 0) {
+         printf("Error can't open output %s\n", batch_output);
+         return 1;
+      }
+
+      batch_status = runBatch(batch_options, "featureExtraction", IMREAD_COLOR, featureExtractionBatch, &batch_features);
+
+      fclose(batch_features.fp_out);
+      return batch_status;
+   }
    
    #ifdef ROS
       // Turn off canonical terminal mode and character echoing
@@ -84,10 +135,10 @@ int main() {
    
    
    strcpy(filename, data_dir);
-   strcat(filename, "featureExtractionOutput.txt");
+   strcat(filename, "featureExtractionOutput.fea");
    
-   if ((fp_out = fopen(filename, "w")) == 0) {
-	  printf("Error can't open output featureExtractionOutput.txt\n");
+   if ((fp_out = openFeatureFile(filename, append)) == 0) {
+	  printf("Error can't open output featureExtractionOutput.fea\n");
      prompt_and_exit(1);
    }
 
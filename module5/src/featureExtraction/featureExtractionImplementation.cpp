@@ -12,6 +12,25 @@
   --------------------
   Added _kbhit
   18 February 2021
+
+  Trace the contours on the run-length encoding of the binary image with traceContours() instead of findContours();
+  the contours are numbered as before so the output file is unchanged
+  17 October 2026
+
+  Compute the features of all contours once, in parallel, into a feature table with extractFeatures();
+  the convex hull is built once and reused for the defects and the drawing, and drawing and file output are
+  separate passes, drawFeatures() and writeFeatures(), over the table; the output file is unchanged
+  17 October 2026
+
+  Removed the number of contours and the time taken printed for every image, and the timing in extractFeatures()
+  17 October 2026
+
+  writeFeatures() writes one block of the binary feature file, one record per object and hole, instead of text;
+  featureFileToText converts the file to the text format
+  17 October 2026
+
+  Added extractImageFeatures(), tabulateFeatures(), and featureExtractionBatch() for headless batch mode
+  17 October 2026
     
 */
  
@@ -36,7 +55,40 @@ void featureExtraction(char *filename, FILE *fp_out) {
 
    printf("Press any key to continue ...\n");
 
-   fprintf(fp_out,"%s \n",filename);  // file write added by David Vernon 
+   /* threshold the image, extract the contours of the objects, and compute their features */
+   vector <vector<Point> > contours;
+	vector<Vec4i>         hierarchy;
+   featureTableType      features;
+
+   extractImageFeatures(inputImage, contours, hierarchy, features);
+
+   /* draw and write the features from the table */
+	Mat contours_image = Mat::zeros(inputImage.size(), CV_8UC3);
+	contours_image = Scalar(255,255,255);
+
+   drawFeatures(contours, hierarchy, features, contours_image);
+   writeFeatures(fp_out, filename, hierarchy, features);
+
+   imshow(inputWindowName,  inputImage );        
+   imshow(outputWindowName, contours_image);  
+
+   do{
+      waitKey(30);           
+   } while (!_kbhit());              
+                                    
+   getchar(); // flush the buffer from the keyboard hit
+
+   destroyWindow(inputWindowName);  
+   destroyWindow(outputWindowName); 
+}
+
+
+/*
+ * extractImageFeatures
+ * Threshold a colour image automatically, trace the contours of the objects, and compute their features
+ */
+
+void extractImageFeatures(const Mat &inputImage, vector<vector<Point> > &contours, vector<Vec4i> &hierarchy, featureTableType &features) {
 
 /*
  * The following is based on code provided as part of "A Practical Introduction to Computer Vision with OpenCV"
@@ -52,148 +104,257 @@ void featureExtraction(char *filename, FILE *fp_out) {
    threshold(gray,binary,128, 255,THRESH_BINARY_INV  | THRESH_OTSU); // David Vernon: substituted in automatic threshold selection
  
    /* extract the contours of the objects in the binary image */
-   vector <vector<Point> > contours;
-	vector<Vec4i>         hierarchy;
+   runLengthImageType    binary_runs;
 
    /* David Vernon: see http://docs.opencv.org/2.4.10/modules/imgproc/doc/structural_analysis_and_shape_descriptors.html#findcontours */
-	findContours(binary,contours,hierarchy,RETR_TREE,CHAIN_APPROX_NONE);
+   /* traceContours() returns the same contours and hierarchy as findContours(binary,contours,hierarchy,RETR_TREE,CHAIN_APPROX_NONE) */
+   binaryToRuns(binary, binary_runs);
+   traceContours(binary_runs, contours, hierarchy);
 
    /* extract features from the contours */
-	Mat contours_image = Mat::zeros(binary.size(), CV_8UC3);
-	contours_image = Scalar(255,255,255);
-	
-   //binary.copyTo(contours_image,binary);
+   extractFeatures(contours, hierarchy, features);
+}
+
+/*
+ * extractFeatures
+ * Compute the features of every contour once and store them in the feature table.
+ * The contours are independent so they are shared among the threads; each contour is one unit of work
+ * because the cost varies greatly with the contour length.
+ * The convex hull is built once, as indices, and the hull points are gathered from the indices.
+ */
+
+void extractFeatures(const vector<vector<Point> > &contours, const vector<Vec4i> &hierarchy, featureTableType &features) {
+
+   int    number_of_contours = (int) contours.size();
+
+   features.number_of_contours = number_of_contours;
+   features.analysed.assign(number_of_contours, 0);
+   features.perimeter.assign(number_of_contours, 0);
+   features.contour_area.assign(number_of_contours, 0);
+   features.hole_area.assign(number_of_contours, 0);
+   features.object_area.assign(number_of_contours, 0);
+   features.bounding_rectangle.assign(number_of_contours, RotatedRect());
+   features.bounding_rectangle_area.assign(number_of_contours, 0);
+   features.hull_indices.assign(number_of_contours, vector<int>());
+   features.hull.assign(number_of_contours, vector<Point>());
+   features.hull_area.assign(number_of_contours, 0);
+   features.convexity_defects.assign(number_of_contours, vector<Vec4i>());
+   features.largest_convexity_depth.assign(number_of_contours, 0);
+   features.contour_moments.assign(number_of_contours, Moments());
+   for (int k = 0; k < NUMBER_OF_HU_MOMENTS; k++) {
+      features.hu_moments[k].assign(number_of_contours, 0);
+   }
 
-	/* Prepare to do some processing on all contours (objects and holes!) by declaring appropriate data-structures */
-	vector<RotatedRect>   min_bounding_rectangle(contours.size());   // bounding rectangles
-	vector <vector<Point> > hulls(contours.size());                    // convex hulls
-	vector <vector<int> >   hull_indices(contours.size());             // indices of convex hulls
-	vector <vector<Vec4i> > convexity_defects(contours.size());        // convex cavities
-	vector<Moments>       contour_moments(contours.size());          // Hu moments
+   parallel_for_(Range(0, number_of_contours), [&](const Range &range) {
+      for (int i = range.start; i < range.end; i++) {
+         const vector<Point> &contour = contours[i];
+         int perimeter = (int) contour.size();
 
-	for (int contour_number=0; (contour_number<(int)contours.size()); contour_number++) {
-		if (contours[contour_number].size() > 10) { // only consider contours of appreciable length
+         features.perimeter[i]    = perimeter;
+         features.contour_area[i] = contourArea(contour);
+
+         // David Vernon: Ken Dawson-Howe adjusts area as it seems to be underestimated by half the number of pixels on the perimeter
+         features.hole_area[i]    = features.contour_area[i] - perimeter/2 + 1;
+
+         if (perimeter <= MIN_CONTOUR_LENGTH) continue;   // only consider contours of appreciable length
+
+         features.analysed[i] = 1;
 
          /* David Vernon: see http://docs.opencv.org/2.4.10/modules/imgproc/doc/structural_analysis_and_shape_descriptors.html#boundingrect */
-			min_bounding_rectangle[contour_number] = minAreaRect(contours[contour_number]);
+         features.bounding_rectangle[i]      = minAreaRect(contour);
+         features.bounding_rectangle_area[i] = features.bounding_rectangle[i].size.area() + perimeter/2 + 1;
 
          /* David Vernon: see http://docs.opencv.org/2.4.10/modules/imgproc/doc/structural_analysis_and_shape_descriptors.html#convexhull */
-			convexHull(contours[contour_number], hulls[contour_number]);
-			convexHull(contours[contour_number], hull_indices[contour_number]);
+         convexHull(contour, features.hull_indices[i]);
+
+         vector<Point> &hull = features.hull[i];
+         hull.resize(features.hull_indices[i].size());
+         for (int j = 0; j < (int) hull.size(); j++) {
+            hull[j] = contour[features.hull_indices[i][j]];
+         }
+         features.hull_area[i] = contourArea(hull) + perimeter/2 + 1;
 
          /* David Vernon: see http://docs.opencv.org/2.4.10/modules/imgproc/doc/structural_analysis_and_shape_descriptors.html#convexitydefects */
-			convexityDefects(contours[contour_number], hull_indices[contour_number], convexity_defects[contour_number]);
+         convexityDefects(contour, features.hull_indices[i], features.convexity_defects[i]);
+
+         int largest_convexity_depth = 0;
+         for (int j = 0; j < (int) features.convexity_defects[i].size(); j++) {
+            if (features.convexity_defects[i][j][3] > largest_convexity_depth)
+               largest_convexity_depth = features.convexity_defects[i][j][3];
+         }
+         features.largest_convexity_depth[i] = largest_convexity_depth;
 
          /* David Vernon: see http://docs.opencv.org/2.4.10/modules/imgproc/doc/structural_analysis_and_shape_descriptors.html#moments*/
-			contour_moments[contour_number] = moments( contours[contour_number] );
-		}
-	}
+         features.contour_moments[i] = moments(contour);
 
-   /* for all contours */
-	for (int contour_number=0; (contour_number>=0); contour_number=hierarchy[contour_number][0]) {
+         /* David Vernon: see http://docs.opencv.org/2.4.10/modules/imgproc/doc/structural_analysis_and_shape_descriptors.html#humoments */
+         double hu_moments[NUMBER_OF_HU_MOMENTS];
+         HuMoments(features.contour_moments[i], hu_moments);
+         for (int k = 0; k < NUMBER_OF_HU_MOMENTS; k++) {
+            features.hu_moments[k][i] = hu_moments[k];
+         }
+      }
+   });
 
-      /* only consider contours of appreciable length */
-		if (contours[contour_number].size() > 10) {
-         Scalar colour(rand()&0x7F, rand()&0x7F, rand()&0x7F );                                    // generate a random colour 
-         drawContours(contours_image, contours, contour_number, colour, FILLED, 8, hierarchy ); // draw the contour
-		
-         char output[500];
+   /* the object area needs the area of its holes, so it is computed once all the contours are done */
 
-         // David Vernon: Ken Dawson-Howe adjusts area as it seems to be underestimated by half the number of pixels on the perimeter
-		   double area = contourArea(contours[contour_number]) + contours[contour_number].size()/2 + 1; 
+   for (int i = 0; i < number_of_contours; i++) {
+      features.object_area[i] = features.contour_area[i] + features.perimeter[i]/2 + 1;
 
-		   // Process any holes (removing the area from the area of the enclosing contour)
-         for (int hole_number=hierarchy[contour_number][2]; (hole_number>=0); hole_number=hierarchy[hole_number][0]) {
-           
-            // David Vernon: Ken Dawson-Howe adjusts area as it seems to be underestimated by half the number of pixels on the perimeter
-            area -= (contourArea(contours[hole_number]) - contours[hole_number].size()/2 + 1); 
-            
-            Scalar colour( rand()&0x7F, rand()&0x7F, rand()&0x7F );
-            drawContours( contours_image, contours, hole_number, colour, FILLED, 8, hierarchy );
+      for (int hole_number = hierarchy[i][2]; hole_number >= 0; hole_number = hierarchy[hole_number][0]) {
+         features.object_area[i] -= features.hole_area[hole_number];
+      }
+   }
+}
 
-            sprintf(output,"Area=%.0f", contourArea(contours[hole_number]) -contours[hole_number].size()/2+1); 
 
-            /* write to file added by David Vernon */
-            fprintf(fp_out,"Object %d, Hole %d: Area = %.0f\n",
-                    contour_number, hole_number, contourArea(contours[hole_number]) - contours[hole_number].size()/2 + 1);
+/*
+ * drawFeatures
+ * Draw the objects and their holes in random colours, with the bounding rectangles, convex hulls, and deep convexities,
+ * and label them with their features.  The features are read from the table.
+ */
 
-            Point location( contours[hole_number][0].x + 20, contours[hole_number][0].y + 5 );  
-            putText( contours_image, output, location, FONT_HERSHEY_SIMPLEX, 0.4, colour );
-         }
+void drawFeatures(const vector<vector<Point> > &contours, const vector<Vec4i> &hierarchy, const featureTableType &features, Mat &contours_image) {
 
-         /* Draw the minimum bounding rectangle */
-         Point2f bounding_rect_points[4];
-         min_bounding_rectangle[contour_number].points(bounding_rect_points);
-         line(contours_image, bounding_rect_points[0], bounding_rect_points[1], Scalar(0, 0, 127));
-         line(contours_image, bounding_rect_points[1], bounding_rect_points[2], Scalar(0, 0, 127));
-         line(contours_image, bounding_rect_points[2], bounding_rect_points[3], Scalar(0, 0, 127));
-         line(contours_image, bounding_rect_points[3], bounding_rect_points[0], Scalar(0, 0, 127));
+   char output[500];
 
-         float bounding_rectangle_area = min_bounding_rectangle[contour_number].size.area();
-		
-         /* Draw the convex hull */
-         drawContours(contours_image, hulls, contour_number, Scalar(255,0,255) );  // purple
+   /* for all contours */
+	for (int contour_number = (features.number_of_contours > 0 ? 0 : -1); (contour_number>=0); contour_number=hierarchy[contour_number][0]) {
+
+      /* only consider contours of appreciable length */
+		if (!features.analysed[contour_number]) continue;
+
+      Scalar colour(rand()&0x7F, rand()&0x7F, rand()&0x7F );                                    // generate a random colour 
+      drawContours(contours_image, contours, contour_number, colour, FILLED, 8, hierarchy ); // draw the contour
 		
-         /* Highlight any convexities */
-         int largest_convexity_depth=0;
+      for (int hole_number=hierarchy[contour_number][2]; (hole_number>=0); hole_number=hierarchy[hole_number][0]) {
+         Scalar colour( rand()&0x7F, rand()&0x7F, rand()&0x7F );
+         drawContours( contours_image, contours, hole_number, colour, FILLED, 8, hierarchy );
+
+         sprintf(output,"Area=%.0f", features.hole_area[hole_number]); 
+
+         Point location( contours[hole_number][0].x + 20, contours[hole_number][0].y + 5 );  
+         putText( contours_image, output, location, FONT_HERSHEY_SIMPLEX, 0.4, colour );
+      }
+
+      /* Draw the minimum bounding rectangle */
+      Point2f bounding_rect_points[4];
+      features.bounding_rectangle[contour_number].points(bounding_rect_points);
+      line(contours_image, bounding_rect_points[0], bounding_rect_points[1], Scalar(0, 0, 127));
+      line(contours_image, bounding_rect_points[1], bounding_rect_points[2], Scalar(0, 0, 127));
+      line(contours_image, bounding_rect_points[2], bounding_rect_points[3], Scalar(0, 0, 127));
+      line(contours_image, bounding_rect_points[3], bounding_rect_points[0], Scalar(0, 0, 127));
+
+      /* Draw the convex hull */
+      drawContours(contours_image, features.hull, contour_number, Scalar(255,0,255) );  // purple
 		
-         for (int convexity_index=0; convexity_index < (int)convexity_defects[contour_number].size(); convexity_index++) {
-			   if (convexity_defects[contour_number][convexity_index][3] > largest_convexity_depth)
-               largest_convexity_depth = convexity_defects[contour_number][convexity_index][3];
-			
-            if (convexity_defects[contour_number][convexity_index][3] > 256*2) {
-               line( contours_image, contours[contour_number][convexity_defects[contour_number][convexity_index][0]], 
-                                     contours[contour_number][convexity_defects[contour_number][convexity_index][2]], Scalar(0,0, 255));
-               line( contours_image, contours[contour_number][convexity_defects[contour_number][convexity_index][1]], 
-                                     contours[contour_number][convexity_defects[contour_number][convexity_index][2]], Scalar(0,0, 255));
-            }
+      /* Highlight any convexities */
+      const vector<Vec4i> &convexity_defects = features.convexity_defects[contour_number];
+
+      for (int convexity_index=0; convexity_index < (int)convexity_defects.size(); convexity_index++) {
+         if (convexity_defects[convexity_index][3] > 256*2) {
+            line( contours_image, contours[contour_number][convexity_defects[convexity_index][0]], 
+                                  contours[contour_number][convexity_defects[convexity_index][2]], Scalar(0,0, 255));
+            line( contours_image, contours[contour_number][convexity_defects[convexity_index][1]], 
+                                  contours[contour_number][convexity_defects[convexity_index][2]], Scalar(0,0, 255));
          }
+      }
 
-         //sprintf(output,"Perimeter=%d, Area=%.0f, BArea=%.0f, CArea=%.0f", contours[contour_number].size(),area,min_bounding_rectangle[contour_number].size.area(),contourArea(hulls[contour_number]));
-         /* David Vernon: alternative as area seems to be underestimated by half the number of pixels on the perimeter */
-         sprintf(output,"Perimeter=%d, Area=%.0f, BArea=%.0f, CArea=%.0f", contours[contour_number].size(),
-                                                                           area,
-                                                                           min_bounding_rectangle[contour_number].size.area() + contours[contour_number].size()/2 + 1,
-                                                                           contourArea(hulls[contour_number])+ contours[contour_number].size()/2 + 1);
-         /* file write added by David Vernon */
-         /* David Vernon: area seems to be underestimated by half the number of pixels on the perimeter */
-         fprintf(fp_out,"Object %d: perimeter = %d, object area = %.0f, bounding rectangle area = %.0f, convex hull area = %.0f \n",
-                 contour_number, 
-                 contours[contour_number].size(),
-                 area,
-                 min_bounding_rectangle[contour_number].size.area() + contours[contour_number].size()/2 + 1,
-                 contourArea(hulls[contour_number]) + contours[contour_number].size()/2 + 1);
-
-         Point location( contours[contour_number][0].x, contours[contour_number][0].y-3 );
-         putText(contours_image, output, location, FONT_HERSHEY_SIMPLEX, 0.4, colour );
-		
-         /* David Vernon: see http://docs.opencv.org/2.4.10/modules/imgproc/doc/structural_analysis_and_shape_descriptors.html#humoments */
-         double hu_moments[7];
-         HuMoments(contour_moments[contour_number], hu_moments );
+      /* David Vernon: area seems to be underestimated by half the number of pixels on the perimeter */
+      sprintf(output,"Perimeter=%d, Area=%.0f, BArea=%.0f, CArea=%.0f", features.perimeter[contour_number],
+                                                                        features.object_area[contour_number],
+                                                                        features.bounding_rectangle_area[contour_number],
+                                                                        features.hull_area[contour_number]);
+
+      Point location( contours[contour_number][0].x, contours[contour_number][0].y-3 );
+      putText(contours_image, output, location, FONT_HERSHEY_SIMPLEX, 0.4, colour );
+
+      sprintf(output,"HuMoments = %.2f, %.2f, %.2f", features.hu_moments[0][contour_number],
+                                                     features.hu_moments[1][contour_number],
+                                                     features.hu_moments[2][contour_number]);
+      Point location2( contours[contour_number][0].x+100, contours[contour_number][0].y-3+15 );
+      putText(contours_image, output, location2, FONT_HERSHEY_SIMPLEX, 0.4, colour );
+	}
+}
+
+
+/*
+ * tabulateFeatures
+ * Copy the features of the objects and their holes into a block of the binary feature file, one record each:
+ * the holes of each object come before the object, the order in which the text file listed them
+ */
+
+void tabulateFeatures(const char *filename, const vector<Vec4i> &hierarchy, const featureTableType &features, featureBlockType &block) {
 
-         sprintf(output,"HuMoments = %.2f, %.2f, %.2f", hu_moments[0],hu_moments[1],hu_moments[2]);
-         Point location2( contours[contour_number][0].x+100, contours[contour_number][0].y-3+15 );
-         putText(contours_image, output, location2, FONT_HERSHEY_SIMPLEX, 0.4, colour );
+   double hu_moments[NUMBER_OF_HU_MOMENTS];
 
-         /* filewrite added by David Vernon */
-         fprintf(fp_out,"Object %d: HuMoments = %.2f, %.2f, %.2f \n\n", contour_number, hu_moments[0],hu_moments[1],hu_moments[2]);
+   clearFeatureBlock(block, filename);
+
+   /* for all contours */
+	for (int contour_number = (features.number_of_contours > 0 ? 0 : -1); (contour_number>=0); contour_number=hierarchy[contour_number][0]) {
+
+      /* only consider contours of appreciable length */
+		if (!features.analysed[contour_number]) continue;
+
+      for (int hole_number=hierarchy[contour_number][2]; (hole_number>=0); hole_number=hierarchy[hole_number][0]) {
+         addFeatureRecord(block, hole_number, contour_number, features.perimeter[hole_number], features.hole_area[hole_number], 0, 0, NULL);
       }
-      fprintf(fp_out,"\n"); //file write added by David Vernon 
+
+      for (int k = 0; k < NUMBER_OF_HU_MOMENTS; k++) {
+         hu_moments[k] = features.hu_moments[k][contour_number];
+      }
+
+      addFeatureRecord(block, contour_number, -1,
+                       features.perimeter[contour_number],
+                       features.object_area[contour_number],
+                       features.bounding_rectangle_area[contour_number],
+                       features.hull_area[contour_number],
+                       hu_moments);
 	}
+}
 
-   imshow(inputWindowName,  inputImage );        
-   imshow(outputWindowName, contours_image);  
 
-   do{
-      waitKey(30);           
-   } while (!_kbhit());              
-                                    
-   getchar(); // flush the buffer from the keyboard hit
+/*
+ * writeFeatures
+ * Write the features of the objects and their holes to the binary feature file as one block
+ */
 
-   destroyWindow(inputWindowName);  
-   destroyWindow(outputWindowName); 
+void writeFeatures(FILE *fp_out, char *filename, const vector<Vec4i> &hierarchy, const featureTableType &features) {
+
+   static featureBlockType block;   // keeps its column capacity from one image to the next
+
+   tabulateFeatures(filename, hierarchy, features, block);
+
+   if (!writeFeatureBlock(fp_out, block)) {
+      printf("Error: failed to write the features of %s\n", filename);
+      prompt_and_exit(1);
+   }
 }
- 
+
+
+/*
+ * featureExtractionBatch
+ * Batch mode: append the features of the image to the feature file of the batch; context is a featureBatchType.
+ * The blocks are written in the order in which the worker threads finish, and each holds the image filename
+ */
+
+bool featureExtractionBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   featureBatchType *batch = (featureBatchType *) context;
+
+   vector <vector<Point> > contours;
+	vector<Vec4i>         hierarchy;
+   featureTableType      features;
+   featureBlockType      block;
+
+   extractImageFeatures(image, contours, hierarchy, features);
+   tabulateFeatures(image_filename, hierarchy, features, block);
+
+   AutoLock lock(batch->mutex);
+
+   return writeFeatureBlock(batch->fp_out, block);
+}
+
 
 /*=======================================================*/
 /* Utility functions to prompt user to continue          */ 
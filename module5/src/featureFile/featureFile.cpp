@@ -0,0 +1,336 @@
+/*
+  Binary feature files
+  --------------------
+
+  (This is the implementation file: it contains the code for the functions that write and read binary feature files.
+  The functions are declared in the interface file featureFile.h, which also describes the file layout.)
+
+  Audit Trail
+  --------------------
+  Created: writeFeatureFileHeader(), writeFeatureBlock(), readFeatureFileHeader(), readFeatureBlock(),
+  writeFeatureBlockText()
+  17 October 2026
+
+  readFeatureBlock() checks the number of records against the rest of the file before allocating the columns;
+  readFeatureFileHeader() rejects version 0; writeFeatureFileHeader() no longer supports appending to a file
+  17 October 2026
+
+  Added openFeatureFile(): a file is appended to only after its header and blocks have been read back
+  17 October 2026
+*/
+
+#include "module5/featureFile.h"
+
+
+/* write and read one column of n values; true if all n were transferred */
+
+template <typename T> static bool writeColumn(FILE *fp, const vector<T> &column) {
+
+   if (column.empty()) return true;
+   return fwrite(&column[0], sizeof(T), column.size(), fp) == column.size();
+}
+
+template <typename T> static bool readColumn(FILE *fp, vector<T> &column, size_t n) {
+
+   column.resize(n);
+   if (n == 0) return true;
+   return fread(&column[0], sizeof(T), n, fp) == n;
+}
+
+
+/* clearFeatureBlock()
+
+   Empty the block and set the image filename, ready for addFeatureRecord()
+*/
+
+void clearFeatureBlock(featureBlockType &block, const char *image_filename) {
+
+   int k;
+
+   block.image_filename = image_filename;
+   block.id.clear();
+   block.parent.clear();
+   block.perimeter.clear();
+   block.area.clear();
+   block.bounding_rectangle_area.clear();
+   block.hull_area.clear();
+   for (k = 0; k < FEATURE_HU_MOMENTS; k++) {
+      block.hu_moments[k].clear();
+   }
+}
+
+
+/* addFeatureRecord()
+
+   Append one object or hole to the block; hu_moments is an array of FEATURE_HU_MOMENTS values, or NULL for zeros
+*/
+
+void addFeatureRecord(featureBlockType &block, int id, int parent, int perimeter, double area,
+                      double bounding_rectangle_area, double hull_area, const double *hu_moments) {
+
+   int k;
+
+   block.id.push_back(id);
+   block.parent.push_back(parent);
+   block.perimeter.push_back(perimeter);
+   block.area.push_back(area);
+   block.bounding_rectangle_area.push_back(bounding_rectangle_area);
+   block.hull_area.push_back(hull_area);
+   for (k = 0; k < FEATURE_HU_MOMENTS; k++) {
+      block.hu_moments[k].push_back(hu_moments != NULL ? hu_moments[k] : 0);
+   }
+}
+
+
+int numberOfFeatureRecords(const featureBlockType &block) {
+
+   return (int) block.id.size();
+}
+
+
+/* writeFeatureFileHeader()
+
+   Write the file header at the start of a file opened with mode "wb"
+*/
+
+bool writeFeatureFileHeader(FILE *fp) {
+
+   uint32_t header[3] = {FEATURE_FILE_MAGIC, FEATURE_FILE_VERSION, FEATURE_COLUMNS};
+
+   return fwrite(header, sizeof(uint32_t), 3, fp) == 3;
+}
+
+
+/* writeFeatureBlock()
+
+   Write the records of one image: the block header, the filename, and then the columns
+*/
+
+bool writeFeatureBlock(FILE *fp, const featureBlockType &block) {
+
+   uint32_t header[3];
+   bool     ok;
+   int      k;
+
+   header[0] = FEATURE_BLOCK_MAGIC;
+   header[1] = (uint32_t) block.id.size();
+   header[2] = (uint32_t) block.image_filename.size();
+
+   ok =       fwrite(header, sizeof(uint32_t), 3, fp) == 3;
+   ok = ok && fwrite(block.image_filename.data(), 1, header[2], fp) == header[2];
+   ok = ok && writeColumn(fp, block.id);
+   ok = ok && writeColumn(fp, block.parent);
+   ok = ok && writeColumn(fp, block.perimeter);
+   ok = ok && writeColumn(fp, block.area);
+   ok = ok && writeColumn(fp, block.bounding_rectangle_area);
+   ok = ok && writeColumn(fp, block.hull_area);
+   for (k = 0; k < FEATURE_HU_MOMENTS; k++) {
+      ok = ok && writeColumn(fp, block.hu_moments[k]);
+   }
+
+   return ok;
+}
+
+
+/* readFeatureFileHeader()
+
+   Check the file header and return the version; false if this is not a feature file, if it was written with the
+   other byte order, or if it was written by a later version of this library
+*/
+
+bool readFeatureFileHeader(FILE *fp, int *version) {
+
+   uint32_t header[3];
+
+   if (fread(header, sizeof(uint32_t), 3, fp) != 3) {
+      printf("readFeatureFileHeader: the file is too short to be a feature file\n");
+      return false;
+   }
+
+   if (header[0] != FEATURE_FILE_MAGIC) {
+      printf("readFeatureFileHeader: not a feature file, or written with the other byte order\n");
+      return false;
+   }
+
+   if (header[1] < 1 || header[1] > FEATURE_FILE_VERSION || header[2] != FEATURE_COLUMNS) {
+      printf("readFeatureFileHeader: version %d with %d columns is not supported\n", (int) header[1], (int) header[2]);
+      return false;
+   }
+
+   *version = (int) header[1];
+   return true;
+}
+
+
+/* remainingBytes()
+
+   Number of bytes between the current position and the end of the file, or -1 if the file cannot be seeked
+*/
+
+static long long remainingBytes(FILE *fp) {
+
+   long position;
+   long end;
+
+   if ((position = ftell(fp)) < 0 || fseek(fp, 0, SEEK_END) != 0) return -1;
+   end = ftell(fp);
+   if (fseek(fp, position, SEEK_SET) != 0 || end < 0) return -1;
+
+   return (long long) end - position;
+}
+
+
+/* openFeatureFile()
+
+   Open a feature file for writing blocks.  Unless append is true, or if the file does not exist or is empty, the file 
+   is created with mode "wb" and the file header is written.  Otherwise the file is first read with readFeatureFileHeader() 
+   and readFeatureBlock(): it must be a feature file of this version whose blocks are all complete, so that the new 
+   blocks can be read back after them; it is then reopened with mode "ab".
+   Returns NULL, with a message, if the file can't be opened or can't be appended to
+*/
+
+FILE *openFeatureFile(const char *filename, bool append) {
+
+   featureBlockType block;
+   FILE *fp;
+   long long size;
+   int  version;
+   int  status;
+
+   if (append && (fp = fopen(filename, "rb")) != 0) {
+
+      size = remainingBytes(fp);
+
+      if (size != 0) {
+
+         if (!readFeatureFileHeader(fp, &version)) {
+            fclose(fp);
+            printf("openFeatureFile: can't append to %s\n", filename);
+            return NULL;
+         }
+
+         if (version != FEATURE_FILE_VERSION) {
+            fclose(fp);
+            printf("openFeatureFile: can't append to %s: it is version %d, not %d\n", filename, version, FEATURE_FILE_VERSION);
+            return NULL;
+         }
+
+         while ((status = readFeatureBlock(fp, block)) == 1) {}
+
+         fclose(fp);
+
+         if (status < 0) {
+            printf("openFeatureFile: can't append to %s\n", filename);
+            return NULL;
+         }
+
+         if ((fp = fopen(filename, "ab")) == 0) {
+            printf("openFeatureFile: can't open %s\n", filename);
+         }
+         return fp;
+      }
+
+      fclose(fp);
+   }
+
+   if ((fp = fopen(filename, "wb")) == 0) {
+      printf("openFeatureFile: can't open %s\n", filename);
+      return NULL;
+   }
+
+   if (!writeFeatureFileHeader(fp)) {
+      fclose(fp);
+      printf("openFeatureFile: can't write the header of %s\n", filename);
+      return NULL;
+   }
+
+   return fp;
+}
+
+
+/* readFeatureBlock()
+
+   Read the records of the next image; returns 1 if a block was read, 0 at the end of the file,
+   and -1 if the block is damaged or incomplete
+   The size of the block given by its header is checked against the rest of the file before the columns are 
+   allocated, so that a damaged record count is reported as an error rather than exhausting memory
+*/
+
+int readFeatureBlock(FILE *fp, featureBlockType &block) {
+
+   uint32_t  header[3];
+   size_t    n;
+   size_t    items;
+   long long remaining;
+   long long block_size;
+   bool      ok;
+   int       k;
+
+   items = fread(header, sizeof(uint32_t), 3, fp);
+
+   if (items == 0 && feof(fp)) return 0;
+
+   if (items != 3 || header[0] != FEATURE_BLOCK_MAGIC || header[2] > FEATURE_MAX_FILENAME) {
+      printf("readFeatureBlock: damaged block header\n");
+      return -1;
+   }
+
+   n = header[1];
+
+   block_size = (long long) header[2] + (long long) n * (FEATURE_INTEGER_COLUMNS * sizeof(int32_t) + FEATURE_REAL_COLUMNS * sizeof(double));
+   remaining  = remainingBytes(fp);
+
+   if (remaining >= 0 && block_size > remaining) {
+      printf("readFeatureBlock: damaged block header: %u records do not fit in the rest of the file\n", header[1]);
+      return -1;
+   }
+
+   block.image_filename.resize(header[2]);
+
+   ok =       header[2] == 0 || fread(&block.image_filename[0], 1, header[2], fp) == header[2];
+   ok = ok && readColumn(fp, block.id, n);
+   ok = ok && readColumn(fp, block.parent, n);
+   ok = ok && readColumn(fp, block.perimeter, n);
+   ok = ok && readColumn(fp, block.area, n);
+   ok = ok && readColumn(fp, block.bounding_rectangle_area, n);
+   ok = ok && readColumn(fp, block.hull_area, n);
+   for (k = 0; k < FEATURE_HU_MOMENTS; k++) {
+      ok = ok && readColumn(fp, block.hu_moments[k], n);
+   }
+
+   if (!ok) {
+      printf("readFeatureBlock: incomplete block for %s\n", block.image_filename.c_str());
+      return -1;
+   }
+
+   return 1;
+}
+
+
+/* writeFeatureBlockText()
+
+   Write the records of one image as text, in the format of the original featureExtractionOutput.txt:
+   the holes of each object come before it in the block, as they did in the text file
+   The original file also had an empty line for each top-level contour too short to be analysed; those contours 
+   have no record, so their empty lines are not written and the text differs from the original by those lines only
+*/
+
+void writeFeatureBlockText(FILE *fp_out, const featureBlockType &block) {
+
+   int i;
+
+   fprintf(fp_out, "%s \n", block.image_filename.c_str());
+
+   for (i = 0; i < numberOfFeatureRecords(block); i++) {
+      if (block.parent[i] >= 0) {
+         fprintf(fp_out, "Object %d, Hole %d: Area = %.0f\n", block.parent[i], block.id[i], block.area[i]);
+      }
+      else {
+         fprintf(fp_out, "Object %d: perimeter = %d, object area = %.0f, bounding rectangle area = %.0f, convex hull area = %.0f \n",
+                 block.id[i], block.perimeter[i], block.area[i], block.bounding_rectangle_area[i], block.hull_area[i]);
+         fprintf(fp_out, "Object %d: HuMoments = %.2f, %.2f, %.2f \n\n",
+                 block.id[i], block.hu_moments[0][i], block.hu_moments[1][i], block.hu_moments[2][i]);
+         fprintf(fp_out, "\n");
+      }
+   }
+}
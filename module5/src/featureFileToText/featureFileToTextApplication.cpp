@@ -0,0 +1,63 @@
+/* 
+  Convert a binary feature file to text
+  -------------------------------------
+ 
+  featureExtraction writes its features to the binary feature file featureExtractionOutput.fea (see featureFile.h).
+  This application converts a feature file to the text format that featureExtraction used to write, one image after another.
+
+  Usage: featureFileToText [feature_file [text_file]]
+
+  The default feature file is featureExtractionOutput.fea and the default text file is featureExtractionOutput.txt.
+  Filenames without a path are in the data directory.
+
+  (This is the application file: it contains the client code that calls dedicated functions to implement the application.
+  The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
+
+  Audit Trail
+  --------------------
+  Created
+  17 October 2026
+*/
+ 
+#include "module5/featureFileToText.h"
+
+int main(int argc, char **argv) {
+   
+   char data_dir[MAX_FILENAME_LENGTH];
+   char feature_filename[MAX_FILENAME_LENGTH];
+   char text_filename[MAX_FILENAME_LENGTH];
+   const char *feature_name = "featureExtractionOutput.fea";
+   const char *text_name    = "featureExtractionOutput.txt";
+   int  number_of_images;
+
+   #ifdef ROS   
+      strcpy(data_dir, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+   #else
+      strcpy(data_dir, "..");
+   #endif
+   
+   strcat(data_dir, "/data/");
+
+   if (argc > 1) feature_name = argv[1];
+   if (argc > 2) text_name    = argv[2];
+
+   if (strlen(data_dir) + strlen(feature_name) >= MAX_FILENAME_LENGTH || strlen(data_dir) + strlen(text_name) >= MAX_FILENAME_LENGTH) {
+      printf("Error: filename too long\n");
+      prompt_and_exit(1);
+   }
+
+   strcpy(feature_filename, strchr(feature_name, '/') != NULL ? "" : data_dir);
+   strcat(feature_filename, feature_name);
+   strcpy(text_filename, strchr(text_name, '/') != NULL ? "" : data_dir);
+   strcat(text_filename, text_name);
+
+   number_of_images = featureFileToText(feature_filename, text_filename);
+
+   if (number_of_images < 0) {
+      prompt_and_exit(1);
+   }
+
+   printf("%d images converted from %s to %s\n", number_of_images, feature_filename, text_filename);
+
+   return 0;
+}
@@ -0,0 +1,66 @@
+/* 
+  Convert a binary feature file to text
+  -------------------------------------
+  
+  (This is the implementation file: it contains the code for dedicated functions to implement the application.
+  These functions are called by client code in the application file. The functions are declared in the interface file.) 
+
+  Audit Trail
+  --------------------
+  Created
+  17 October 2026
+*/
+ 
+#include "module5/featureFileToText.h"
+
+/*
+ * featureFileToText
+ * Write every block of the feature file as text; returns the number of images, or -1 on error
+ */
+
+int featureFileToText(const char *feature_filename, const char *text_filename) {
+
+   FILE *fp_in;
+   FILE *fp_out;
+   featureBlockType block;
+   int  version;
+   int  status;
+   int  number_of_images = 0;
+
+   if ((fp_in = fopen(feature_filename, "rb")) == 0) {
+      printf("Error can't open input %s\n", feature_filename);
+      return -1;
+   }
+
+   if (!readFeatureFileHeader(fp_in, &version)) {
+      fclose(fp_in);
+      return -1;
+   }
+
+   if ((fp_out = fopen(text_filename, "w")) == 0) {
+      printf("Error can't open output %s\n", text_filename);
+      fclose(fp_in);
+      return -1;
+   }
+
+   while ((status = readFeatureBlock(fp_in, block)) == 1) {
+      writeFeatureBlockText(fp_out, block);
+      number_of_images++;
+   }
+
+   fclose(fp_in);
+   fclose(fp_out);
+
+   return status < 0 ? -1 : number_of_images;
+}
+
+
+/*=======================================================*/
+/* Utility function to prompt user to exit               */ 
+/*=======================================================*/
+
+void prompt_and_exit(int status) {
+   printf("Press any key to continue and close terminal ... \n");
+   getchar();
+   exit(status);
+}
@@ -10,6 +10,10 @@
 
   The user can interactively select the amount of noise added and the standard deviation of the Gaussian filter.
   For the standard deviation, the value used is four times the value specified using the interactive slider, plus 1.
+  The Mode slider selects the filter implementation: 0 OpenCV GaussianBlur(), 1 fixed-point FIR, 2 recursive IIR, 
+  3 box-filter cascade.  The Cache slider selects whether the noisy image is kept until the image or the noise level
+  changes (1, the default) or the noise is generated again on every change (0).  Nothing is printed on each trackbar event; the time taken by each mode, and the PSNR of the 
+  native filters with respect to GaussianBlur(), are reported by gaussianFilteringBenchmark.
 
   (This is the application file: it contains the client code that calls dedicated functions to implement the application.
   The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
@@ -31,6 +35,20 @@
   David Vernon
   11 July 2024
 
+  Added the Mode slider and the native Gaussian filters
+  17 October 2026
+
+  Added cache_noise: the same noisy image is filtered until the noise level changes
+  17 October 2026
+
+  Added image_number: each image gets different noise
+  17 October 2026
+
+  Added the Cache slider for cache_noise
+  17 October 2026
+
+  Headless batch mode: gaussianFiltering --batch <images> <output directory> [number of threads]
+  17 October 2026
 */
 
 #include "module5/gaussianFiltering.h"
@@ -41,13 +59,25 @@
 Mat src;
 int noise_std_dev             = 0; // default standard deviation for additive Gaussian noise
 int gaussian_std_dev          = 0; // default standard deviation for Gaussian filter: filter size = value * 4 + 1
+int filter_mode               = GAUSSIAN_OPENCV; // 0 OpenCV, 1 FIR, 2 IIR, 3 box cascade: see gaussianFilter()
+int cache_noise               = 1;    // 1: reuse the noisy image until the image or the noise level changes; 0: new noise on every event
+unsigned int image_number     = 0;    // incremented for each image read: selects the noise and invalidates the cache
 
 const char* input_window_name     = "Input Image";
 const char* processed_window_name = "Gaussian Image";
 
 int view;
 
-int main() {
+int main(int argc, char **argv) {
+
+   /* headless batch mode: see batchProcessing.h */
+
+   batchOptionsType batch_options;
+
+   if (isBatchMode(argc, argv)) {
+      if (!getBatchOptions(argc, argv, &batch_options)) return 1;
+      return runBatch(batch_options, "gaussianFiltering", IMREAD_UNCHANGED, gaussianFilteringBatch, NULL);
+   }
   
   /* removing this stops a core dump on exit. DV 28/10/2021
    #ifdef ROS
@@ -72,7 +102,9 @@ int main() {
    char filename[MAX_FILENAME_LENGTH];
 
    int const max_noise_std_dev     = 50;
-   int const max_gaussian_std_dev  = 5;   
+   int const max_gaussian_std_dev  = 20;   
+   int const max_filter_mode       = GAUSSIAN_BOX;
+   int const max_cache_noise       = 1;
 
    FILE *fp_in; 
 
@@ -109,6 +141,7 @@ int main() {
             cout << "can not open " << filename << endl;
             prompt_and_exit(-1);
          }
+         image_number++;
           
          printf("Press any key to continue ...\n");
 
@@ -121,6 +154,8 @@ int main() {
 
          createTrackbar( "Noise", processed_window_name, &noise_std_dev,    max_noise_std_dev,    processNoiseAndAveraging); // same callback
          createTrackbar( "Std Dev",processed_window_name, &gaussian_std_dev, max_gaussian_std_dev, processNoiseAndAveraging); // same callback
+         createTrackbar( "Mode",   processed_window_name, &filter_mode,      max_filter_mode,      processNoiseAndAveraging); // same callback
+         createTrackbar( "Cache",  processed_window_name, &cache_noise,      max_cache_noise,      processNoiseAndAveraging); // same callback
 
          // Show the image
          processNoiseAndAveraging(0, 0);
@@ -12,6 +12,34 @@
   --------------------
   Added _kbhit
   18 February 2021
+
+  Added native Gaussian filters selected with the Mode trackbar: a separable fixed-point FIR filter, 
+  the Young - van Vliet recursive (IIR) filter, and a cascade of box filters; the time taken and the 
+  PSNR with respect to OpenCV GaussianBlur() are printed for each
+  17 October 2026
+
+  Removed the time and PSNR printed on every trackbar event; gaussianFilteringBenchmark sweeps sigma from 1 to 20 
+  and reports both for each mode
+  17 October 2026
+
+  Both passes of gaussianFIR() accumulate one kernel tap at a time along the row with accumulateTap(), so that 
+  they are vectorised; the output is unchanged
+  17 October 2026
+
+  8-bit images now have noise added in place from a counter-based (Philox) normal generator, and the noisy image 
+  is cached so that moving the Std Dev or Mode trackbars does not regenerate the noise
+  17 October 2026
+
+  The Philox key of addGaussianNoise8U() includes an image number, so that each image gets different noise; the 
+  noisy image is cached on the image number, size, and type; the Box-Muller transform is vectorised in boxMuller()
+  17 October 2026
+
+  The noise generation of 8-bit images is in its own section, with addNoise() choosing between addGaussianNoise8U() 
+  and the original addGaussianNoise(), which is restored; the Cache trackbar sets cache_noise
+  17 October 2026
+
+  Added gaussianFilteringBatch(): the core of the application for headless batch mode
+  17 October 2026
     
 */
  
@@ -28,23 +56,631 @@ void processNoiseAndAveraging(int, void*) {
    extern Mat src; 
    extern int noise_std_dev;
    extern int gaussian_std_dev; 
-   extern char* processed_window_name;
+   extern int filter_mode; 
+   extern int cache_noise; 
+   extern unsigned int image_number;
+   extern const char* processed_window_name;
 
-   Mat noisy_image;
+   static Mat noisy_image;                   // cached: regenerated only when the input image or the noise level changes
+   static unsigned int noisy_image_number = 0;
+   static Size noisy_size;
+   static int noisy_type      = -1;
+   static int noisy_std_dev   = -1;
    Mat filtered_image; 
 
-   int filter_size;
-
-   filter_size = gaussian_std_dev * 4 + 1;
-	noisy_image = src.clone();
+   /* the application increments image_number for each image it reads, which invalidates the cache */
 
-	addGaussianNoise(noisy_image, 0.0, (double)noise_std_dev); 
+   if (!cache_noise || noisy_image_number != image_number || noisy_size != src.size() || noisy_type != src.type() ||
+       noisy_std_dev != noise_std_dev) {
+	   src.copyTo(noisy_image);
+	   addNoise(noisy_image, 0.0, (double)noise_std_dev, image_number); 
+      noisy_image_number = image_number;
+      noisy_size         = src.size();
+      noisy_type         = src.type();
+      noisy_std_dev      = noise_std_dev;
+   }
 	
-   GaussianBlur(noisy_image,filtered_image,Size(filter_size,filter_size),gaussian_std_dev);
+   gaussianFilter(noisy_image, filtered_image, gaussian_std_dev, filter_mode);
  
    imshow(processed_window_name, filtered_image);
  }
 
+
+/*=======================================================*/
+/* Native Gaussian filters                               */ 
+/*=======================================================*/
+
+/* gaussianFilter()
+
+   Gaussian filter with standard deviation sigma of an 8-bit image with any number of channels
+   mode selects the implementation:
+
+   GAUSSIAN_OPENCV  GaussianBlur() with a (4 sigma + 1) x (4 sigma + 1) kernel, as before
+   GAUSSIAN_FIR     separable fixed-point FIR filter with the same kernel: exact to within rounding, cost O(sigma) per pixel
+   GAUSSIAN_IIR     Young - van Vliet third-order recursive filter: cost independent of sigma, for sigma >= 0.5
+   GAUSSIAN_BOX     GAUSSIAN_BOX_PASSES box filters whose combined variance matches sigma: cost independent of sigma
+
+   All the native filters use BORDER_REFLECT_101 (OpenCV's default border) or, for the IIR filter, replicate the 
+   border pixel in the initial conditions.  A sigma of zero leaves the image unchanged.
+*/
+
+void gaussianFilter(const Mat &src, Mat &dst, double sigma, int mode) {
+
+   int filter_size;
+
+   CV_Assert(src.depth() == CV_8U);
+
+   if (sigma <= 0) {
+      src.copyTo(dst);
+      return;
+   }
+
+   switch (mode) {
+
+   case GAUSSIAN_FIR:
+      gaussianFIR(src, dst, sigma);
+      break;
+
+   case GAUSSIAN_IIR:
+      gaussianIIR(src, dst, sigma);
+      break;
+
+   case GAUSSIAN_BOX:
+      gaussianBoxCascade(src, dst, sigma);
+      break;
+
+   default:
+      filter_size = 2 * cvRound(2 * sigma) + 1;
+      GaussianBlur(src, dst, Size(filter_size, filter_size), sigma);
+      break;
+   }
+}
+
+
+/* reflect101()
+
+   Index of the pixel used for position i in a row or column of n pixels with BORDER_REFLECT_101: ... 2 1 | 0 1 2 ... 
+*/
+
+static int reflect101(int i, int n) {
+
+   if (n == 1) return 0;
+
+   while (i < 0 || i >= n) {
+      if (i < 0)  i = -i;
+      if (i >= n) i = 2 * n - 2 - i;
+   }
+   return i;
+}
+
+
+/* accumulateTap()
+
+   acc[j] += weight * p[j] for j = 0 .. n-1: one tap of the FIR filter applied along a row
+   The rows are declared __restrict so that the compiler does not have to allow for them overlapping, which would 
+   stop it vectorising the loop
+*/
+
+template <typename T>
+static void accumulateTap(const T * __restrict p, int weight, int * __restrict acc, int n) {
+
+   int j;
+
+   for (j = 0; j < n; j++) {
+      acc[j] += weight * p[j];
+   }
+}
+
+
+/* gaussianFIR()
+
+   Separable FIR filter with a kernel of radius 2 sigma in fixed point
+
+   The kernel weights are scaled by 2^GAUSSIAN_FIXED_POINT_BITS and rounded, and the centre weight is adjusted so that 
+   they sum exactly to 2^GAUSSIAN_FIXED_POINT_BITS; a uniform image is therefore unchanged.
+   The horizontal pass writes 16-bit intermediate values with 8 fractional bits; the vertical pass accumulates them in 
+   32 bits (at most 65280 x 2^14 < 2^31) and rounds back to 8 bits.  Rows are split across threads in both passes.
+*/
+
+void gaussianFIR(const Mat &src, Mat &dst, double sigma) {
+
+   int radius = cvRound(2 * sigma);
+   int size   = 2 * radius + 1;
+   int channels = src.channels();
+   int width    = src.cols * channels;
+   std::vector<int> kernel(size);
+   std::vector<double> weight(size);
+   double sum = 0;
+   int fixed_sum = 0;
+   int k;
+   Mat horizontal(src.rows, width, CV_16UC1);
+
+   for (k = 0; k < size; k++) {
+      weight[k] = exp(-(k - radius) * (k - radius) / (2 * sigma * sigma));
+      sum += weight[k];
+   }
+   for (k = 0; k < size; k++) {
+      kernel[k] = cvRound(weight[k] / sum * (1 << GAUSSIAN_FIXED_POINT_BITS));
+      fixed_sum += kernel[k];
+   }
+   kernel[radius] += (1 << GAUSSIAN_FIXED_POINT_BITS) - fixed_sum;
+
+   dst.create(src.size(), src.type());
+
+   /* horizontal pass: each row is copied to a buffer with reflected borders so that the inner loop has no tests, */
+   /* and the shifted copies of the row are accumulated one kernel tap at a time so that the loop runs along it    */
+
+   parallel_for_(Range(0, src.rows), [&](const Range &range) {
+
+      std::vector<unsigned char> padded((src.cols + 2 * radius) * channels);
+      std::vector<int> acc(width);
+      int row, col, c, j, k;
+
+      for (row = range.start; row < range.end; row++) {
+
+         const unsigned char *p_src = src.ptr<unsigned char>(row);
+         unsigned short *p_h        = horizontal.ptr<unsigned short>(row);
+
+         memcpy(&padded[radius * channels], p_src, width);
+         for (col = 0; col < radius; col++) {
+            for (c = 0; c < channels; c++) {
+               padded[col * channels + c]                       = p_src[reflect101(col - radius, src.cols) * channels + c];
+               padded[(src.cols + radius + col) * channels + c] = p_src[reflect101(src.cols + col, src.cols) * channels + c];
+            }
+         }
+
+         std::fill(acc.begin(), acc.end(), 1 << (GAUSSIAN_FIXED_POINT_BITS - 9));
+
+         for (k = 0; k < size; k++) {
+            accumulateTap(&padded[k * channels], kernel[k], &acc[0], width);
+         }
+
+         for (j = 0; j < width; j++) {
+            p_h[j] = (unsigned short) (acc[j] >> (GAUSSIAN_FIXED_POINT_BITS - 8));
+         }
+      }
+   });
+
+   /* vertical pass: accumulate weighted rows so that the inner loop runs along a row */
+
+   parallel_for_(Range(0, src.rows), [&](const Range &range) {
+
+      std::vector<int> acc(width);
+      int row, j, k;
+      int shift = GAUSSIAN_FIXED_POINT_BITS + 8;
+
+      for (row = range.start; row < range.end; row++) {
+
+         unsigned char *p_dst = dst.ptr<unsigned char>(row);
+
+         std::fill(acc.begin(), acc.end(), 1 << (shift - 1));
+
+         for (k = 0; k < size; k++) {
+            accumulateTap(horizontal.ptr<unsigned short>(reflect101(row - radius + k, src.rows)), kernel[k], &acc[0], width);
+         }
+
+         for (j = 0; j < width; j++) {
+            p_dst[j] = (unsigned char) (acc[j] >> shift);
+         }
+      }
+   });
+}
+
+
+/* gaussianIIR()
+
+   Young - van Vliet recursive Gaussian filter
+   I.T. Young and L.J. van Vliet, "Recursive implementation of the Gaussian filter", Signal Processing 44, 1995
+
+   Each row, and then each column, is filtered by a third-order causal recursion followed by a third-order anti-causal 
+   recursion, with coefficients computed from sigma: seven multiplications per pixel per direction, whatever sigma.
+   The recursions start from the steady state for the border pixel, i.e. the border is replicated.
+   The columns are processed a stripe at a time, one row after another, so that memory is accessed along rows.
+*/
+
+void gaussianIIR(const Mat &src, Mat &dst, double sigma) {
+
+   int channels = src.channels();
+   int width    = src.cols * channels;
+   double q;
+   double b0, b1, b2, b3;
+   float B, c1, c2, c3;
+   Mat image;
+
+   if (sigma < 0.5) sigma = 0.5;  // the approximation for q is not valid below 0.5
+
+   if (sigma >= 2.5) q = 0.98711 * sigma - 0.96330;
+   else              q = 3.97156 - 4.14554 * sqrt(1 - 0.26891 * sigma);
+
+   b0 = 1.57825 + 2.44413 * q + 1.4281 * q * q + 0.422205 * q * q * q;
+   b1 = 2.44413 * q + 2.85619 * q * q + 1.26661 * q * q * q;
+   b2 = -(1.4281 * q * q + 1.26661 * q * q * q);
+   b3 = 0.422205 * q * q * q;
+
+   B  = (float) (1 - (b1 + b2 + b3) / b0);
+   c1 = (float) (b1 / b0);
+   c2 = (float) (b2 / b0);
+   c3 = (float) (b3 / b0);
+
+   src.convertTo(image, CV_MAKETYPE(CV_32F, channels));
+
+   /* horizontal: each row in place, channels interleaved */
+
+   parallel_for_(Range(0, src.rows), [&](const Range &range) {
+
+      int row, col, c, n;
+      float w1, w2, w3, w;
+      float *p;
+
+      for (row = range.start; row < range.end; row++) {
+
+         p = image.ptr<float>(row);
+
+         for (c = 0; c < channels; c++) {
+
+            w1 = w2 = w3 = p[c];
+            for (col = 0; col < src.cols; col++) {
+               n = col * channels + c;
+               w = B * p[n] + c1 * w1 + c2 * w2 + c3 * w3;
+               w3 = w2; w2 = w1; w1 = w;
+               p[n] = w;
+            }
+
+            w1 = w2 = w3 = p[(src.cols - 1) * channels + c];
+            for (col = src.cols - 1; col >= 0; col--) {
+               n = col * channels + c;
+               w = B * p[n] + c1 * w1 + c2 * w2 + c3 * w3;
+               w3 = w2; w2 = w1; w1 = w;
+               p[n] = w;
+            }
+         }
+      }
+   });
+
+   /* vertical: stripes of columns, the recursion state for each column held in three row buffers */
+
+   parallel_for_(Range(0, width), [&](const Range &range) {
+
+      int stripe = range.end - range.start;
+      std::vector<float> state(3 * stripe);
+      float *w1 = &state[0];
+      float *w2 = &state[stripe];
+      float *w3 = &state[2 * stripe];
+      float w;
+      float *p;
+      int row, j;
+
+      p = image.ptr<float>(0) + range.start;
+      for (j = 0; j < stripe; j++) w1[j] = w2[j] = w3[j] = p[j];
+
+      for (row = 0; row < src.rows; row++) {
+         p = image.ptr<float>(row) + range.start;
+         for (j = 0; j < stripe; j++) {
+            w = B * p[j] + c1 * w1[j] + c2 * w2[j] + c3 * w3[j];
+            w3[j] = w2[j]; w2[j] = w1[j]; w1[j] = w;
+            p[j] = w;
+         }
+      }
+
+      p = image.ptr<float>(src.rows - 1) + range.start;
+      for (j = 0; j < stripe; j++) w1[j] = w2[j] = w3[j] = p[j];
+
+      for (row = src.rows - 1; row >= 0; row--) {
+         p = image.ptr<float>(row) + range.start;
+         for (j = 0; j < stripe; j++) {
+            w = B * p[j] + c1 * w1[j] + c2 * w2[j] + c3 * w3[j];
+            w3[j] = w2[j]; w2[j] = w1[j]; w1[j] = w;
+            p[j] = w;
+         }
+      }
+   });
+
+   image.convertTo(dst, src.type());
+}
+
+
+/* gaussianBoxCascade()
+
+   Approximate a Gaussian by GAUSSIAN_BOX_PASSES successive box filters
+   P. Kovesi, "Fast almost-Gaussian filtering", Proc. DICTA, 2010
+
+   Boxes of two odd widths wl and wl + 2 are used, m of the smaller, so that the variance of the cascade, 
+   the sum of (w^2 - 1) / 12 over the passes, is as close as possible to sigma^2.
+   Each box is computed with running sums, so the cost does not depend on the width.
+*/
+
+void gaussianBoxCascade(const Mat &src, Mat &dst, double sigma) {
+
+   int channels = src.channels();
+   int width    = src.cols * channels;
+   int n = GAUSSIAN_BOX_PASSES;
+   double w_ideal;
+   int wl, wu, m;
+   int pass;
+   int radius;
+   Mat image;
+   Mat temp;
+
+   w_ideal = sqrt(12 * sigma * sigma / n + 1);
+   wl = (int) floor(w_ideal);
+   if (wl % 2 == 0) wl--;
+   wu = wl + 2;
+   m = cvRound((12 * sigma * sigma - n * wl * wl - 4 * n * wl - 3 * n) / (-4 * wl - 4));
+
+   src.convertTo(image, CV_MAKETYPE(CV_32F, channels));
+   temp.create(image.size(), image.type());
+
+   for (pass = 0; pass < n; pass++) {
+
+      radius = ((pass < m) ? wl : wu) / 2;
+
+      /* horizontal: image -> temp */
+
+      parallel_for_(Range(0, src.rows), [&](const Range &range) {
+
+         int row, col, c;
+         float sum;
+         float scale = 1.0f / (2 * radius + 1);
+
+         for (row = range.start; row < range.end; row++) {
+
+            const float *p = image.ptr<float>(row);
+            float *q       = temp.ptr<float>(row);
+
+            for (c = 0; c < channels; c++) {
+               sum = 0;
+               for (col = -radius; col <= radius; col++) {
+                  sum += p[reflect101(col, src.cols) * channels + c];
+               }
+               for (col = 0; col < src.cols; col++) {
+                  q[col * channels + c] = sum * scale;
+                  sum += p[reflect101(col + radius + 1, src.cols) * channels + c] - p[reflect101(col - radius, src.cols) * channels + c];
+               }
+            }
+         }
+      });
+
+      /* vertical: temp -> image, a stripe of columns at a time with one running sum per column */
+
+      parallel_for_(Range(0, width), [&](const Range &range) {
+
+         int stripe = range.end - range.start;
+         std::vector<float> sum(stripe, 0.0f);
+         float scale = 1.0f / (2 * radius + 1);
+         int row, j;
+
+         for (row = -radius; row <= radius; row++) {
+            const float *p = temp.ptr<float>(reflect101(row, src.rows)) + range.start;
+            for (j = 0; j < stripe; j++) sum[j] += p[j];
+         }
+
+         for (row = 0; row < src.rows; row++) {
+            const float *p_add = temp.ptr<float>(reflect101(row + radius + 1, src.rows)) + range.start;
+            const float *p_sub = temp.ptr<float>(reflect101(row - radius, src.rows)) + range.start;
+            float *q           = image.ptr<float>(row) + range.start;
+            for (j = 0; j < stripe; j++) {
+               q[j] = sum[j] * scale;
+               sum[j] += p_add[j] - p_sub[j];
+            }
+         }
+      });
+   }
+
+   image.convertTo(dst, src.type());
+}
+
+
+/*=======================================================*/
+/* Gaussian noise                                        */ 
+/*=======================================================*/
+
+/* addNoise()
+
+   Add Gaussian noise in place: 8-bit images with addGaussianNoise8U(), other images with addGaussianNoise()
+   image_number selects the noise of an 8-bit image; see addGaussianNoise8U()
+*/
+
+void addNoise(Mat &image, double average, double standard_deviation, unsigned int image_number) {
+
+   if (image.depth() == CV_8U) {
+      addGaussianNoise8U(image, average, standard_deviation, NOISE_SEED, image_number);
+   }
+   else {
+      addGaussianNoise(image, average, standard_deviation);
+   }
+}
+
+
+/* philox4x32()
+
+   Philox-4x32-10 counter-based random number generator
+   J.K. Salmon, M.A. Moraes, R.O. Dror, and D.E. Shaw, "Parallel random numbers: as easy as 1, 2, 3", Proc. SC11, 2011
+
+   Maps a 128-bit counter and a 64-bit key to four independent, uniformly distributed 32-bit numbers.
+   There is no state: any pixel's random numbers can be computed directly from its position, so the rows can be 
+   processed in parallel and the same seed always gives the same noise.
+*/
+
+static void philox4x32(const unsigned int counter[4], const unsigned int key_in[2], unsigned int out[4]) {
+
+   unsigned int x0 = counter[0], x1 = counter[1], x2 = counter[2], x3 = counter[3];
+   unsigned int k0 = key_in[0], k1 = key_in[1];
+   unsigned long long p0, p1;
+   int round;
+
+   for (round = 0; round < 10; round++) {
+      p0 = (unsigned long long) PHILOX_M0 * x0;
+      p1 = (unsigned long long) PHILOX_M1 * x2;
+      x0 = (unsigned int) (p1 >> 32) ^ x1 ^ k0;
+      x1 = (unsigned int) p1;
+      x2 = (unsigned int) (p0 >> 32) ^ x3 ^ k1;
+      x3 = (unsigned int) p0;
+      k0 += PHILOX_W0;
+      k1 += PHILOX_W1;
+   }
+
+   out[0] = x0; out[1] = x1; out[2] = x2; out[3] = x3;
+}
+
+
+/* boxMuller()
+
+   Box-Muller transform of pairs of uniform 32-bit numbers to pairs of standard normal values:
+   normal[2k] = r cos(theta), normal[2k+1] = r sin(theta), with r = sqrt(-2 ln u1), theta = 2 pi u2,
+   u1 = uniform[2k] and u2 = uniform[2k+1], both scaled to [0, 1)
+
+   logf(), cosf(), and sinf() are replaced by polynomials written so that the loop is vectorised:
+
+   ln u1   u1 = ((uniform >> 8) + 1) 2^-24 is in (0, 1] and converts exactly; it is split into 2^e m with m in
+           [sqrt(1/2), sqrt(2)) by its exponent bits, and ln m = 2 atanh(s), s = (m - 1)/(m + 1), from the series in s
+           to s^9: the error is below 1e-9, far below that of float; the split is done on the integer bits because
+           GCC does not if-convert a conditional floating-point multiplication
+   theta   the top two bits of u2 give the quadrant and the remaining 30 bits the angle x in [0, pi/2) within it;
+           sin x and cos x are Taylor polynomials to x^11 and x^12 (error below 1e-7) and are swapped and negated
+           according to the quadrant
+
+   The loop is vectorised only if sqrtf() need not set errno: module5 is compiled with -fno-math-errno
+*/
+
+static void boxMuller(const unsigned int * __restrict uniform, float * __restrict normal, int pairs) {
+
+   const float ln_2         = 0.69314718f;
+   const float scale_24     = 1.0f / 16777216.0f;     // 2^-24
+   const float half_pi_30   = (float) (CV_PI / 2) / 1073741824.0f;   // pi/2 2^-30
+   int k;
+
+   for (k = 0; k < pairs; k++) {
+
+      float u1 = (float) ((int) (uniform[2*k] >> 8) + 1) * scale_24;
+      unsigned int u2 = uniform[2*k+1];
+
+      /* ln u1 */
+
+      int bits = 0;
+      memcpy(&bits, &u1, sizeof(bits));
+      int high = (bits & 0x007fffff) > 0x003504f3;        // mantissa above sqrt(2): halve m and increment e
+      int e    = ((bits >> 23) & 0xff) - 127 + high;
+      int mantissa = (bits & 0x007fffff) | (0x3f800000 - (high << 23));
+      float m;
+      memcpy(&m, &mantissa, sizeof(m));
+      float s  = (m - 1.0f) / (m + 1.0f);
+      float s2 = s * s;
+      float ln_u1 = 2.0f * s * (1.0f + s2 * (1.0f/3 + s2 * (1.0f/5 + s2 * (1.0f/7 + s2 * (1.0f/9))))) + (float) e * ln_2;
+
+      float r = sqrtf(-2.0f * ln_u1);
+
+      /* sin and cos of 2 pi u2 */
+
+      int   quadrant = (int) (u2 >> 30);
+      float x  = (float) (int) (u2 & 0x3fffffff) * half_pi_30;
+      float x2 = x * x;
+      float sin_x = x * (1.0f - x2/6 * (1.0f - x2/20 * (1.0f - x2/42 * (1.0f - x2/72 * (1.0f - x2/110)))));
+      float cos_x = 1.0f - x2/2 * (1.0f - x2/12 * (1.0f - x2/30 * (1.0f - x2/56 * (1.0f - x2/90 * (1.0f - x2/132)))));
+
+      float c = (quadrant & 1) ? sin_x : cos_x;
+      float d = (quadrant & 1) ? cos_x : sin_x;
+      normal[2*k]   = r * ((quadrant == 1 || quadrant == 2) ? -c : c);
+      normal[2*k+1] = r * ((quadrant >= 2) ? -d : d);
+   }
+}
+
+
+/* addGaussianNoise8U()
+
+   Add Gaussian noise in place to an 8-bit image with any number of channels, saturating at 0 and 255
+   Each group of four values in a row takes four uniform numbers from philox4x32() with counter (group, row, 0, 0)
+   and key (seed, image_number), so that each image gets different noise and the same image always gets the same
+   noise.  The uniform numbers of a row are turned into normal values by boxMuller() and the noise is then added in a
+   separate pass; both passes are vectorised.  The rows are split across threads.
+*/
+
+void addGaussianNoise8U(Mat &image, double average, double standard_deviation, unsigned int seed, unsigned int image_number) {
+
+   CV_Assert(image.depth() == CV_8U);
+
+   parallel_for_(Range(0, image.rows), [&](const Range &range) {
+
+      int n      = image.cols * image.channels();
+      int groups = (n + 3) / 4;
+      unsigned int counter[4] = {0, 0, 0, 0};
+      unsigned int key[2]     = {seed, image_number};
+      vector<unsigned int> uniform(4 * groups);
+      vector<float> normal(4 * groups);
+      const float *p_normal = &normal[0];
+      float mean  = (float) average;
+      float sigma = (float) standard_deviation;
+      float value;
+      int row, i;
+
+      for (row = range.start; row < range.end; row++) {
+
+         unsigned char *p = image.ptr<unsigned char>(row);
+
+         counter[1] = (unsigned int) row;
+
+         for (i = 0; i < groups; i++) {
+            counter[0] = (unsigned int) i;
+            philox4x32(counter, key, &uniform[4*i]);
+         }
+
+         boxMuller(&uniform[0], &normal[0], 2 * groups);
+
+         for (i = 0; i < n; i++) {
+            value = p[i] + mean + sigma * p_normal[i];
+            value = value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+            p[i]  = (unsigned char) (int) (value + 0.5f);
+         }
+      }
+   });
+}
+
+
+/*
+ * gaussianFilteringBatch
+ * Batch mode: add noise and filter with the default noise level, standard deviation, and filter mode, 
+ * and write <output_stem>_gaussian.png
+ * The images are processed in any order, so the image number of the noise is a hash of the image filename:
+ * each image gets different noise and the same image always gets the same noise
+ */
+
+/* FNV-1a hash of a filename */
+
+static unsigned int filenameHash(const char *filename) {
+
+   unsigned int hash = 2166136261u;
+
+   for (; *filename != '\0'; filename++) {
+      hash = (hash ^ (unsigned char) *filename) * 16777619u;
+   }
+   return hash;
+}
+
+
+bool gaussianFilteringBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   extern int noise_std_dev;
+   extern int gaussian_std_dev; 
+   extern int filter_mode; 
+
+   Mat noisy_image;
+   Mat filtered_image; 
+
+   if (image.depth() != CV_8U) {
+      printf("Error: %s is not an 8-bit image\n", image_filename);
+      return false;
+   }
+
+   image.copyTo(noisy_image);
+   if (noise_std_dev > 0) {
+      addNoise(noisy_image, 0.0, (double)noise_std_dev, filenameHash(image_filename)); 
+   }
+
+   gaussianFilter(noisy_image, filtered_image, gaussian_std_dev, filter_mode);
+
+   return imwrite(string(output_stem) + "_gaussian.png", filtered_image);
+}
+
+
 void prompt_and_exit(int status) {
    printf("Press any key to continue and close terminal ... \n");
    getchar();
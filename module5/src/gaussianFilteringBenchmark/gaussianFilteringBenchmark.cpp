@@ -0,0 +1,98 @@
+/*
+  Benchmark of the native Gaussian filters
+  ----------------------------------------
+
+  Sweeps the standard deviation sigma from 1 to BENCHMARK_MAX_SIGMA and, for each of the modes of gaussianFilter(),
+  reports the time taken to filter images from the data/Media directory resized to BENCHMARK_WIDTH x BENCHMARK_HEIGHT
+  and the PSNR of the result with respect to OpenCV GaussianBlur() with the same (4 sigma + 1)-wide kernel:
+
+  GAUSSIAN_OPENCV  GaussianBlur() itself, the reference for the time
+  GAUSSIAN_FIR     separable fixed-point FIR filter: must reach a PSNR of at least FIR_MIN_PSNR
+  GAUSSIAN_IIR     Young - van Vliet recursive filter: must reach a PSNR of at least APPROXIMATION_MIN_PSNR
+  GAUSSIAN_BOX     cascade of box filters:            must reach a PSNR of at least APPROXIMATION_MIN_PSNR
+
+  The FIR filter differs from GaussianBlur() only by rounding; the IIR and box filters approximate the Gaussian,
+  so their PSNR is lower.
+
+  The images are given on the command line, relative to data/Media (see module5/imageBenchmark.h).
+  Each time is the shortest of GAUSSIAN_REPETITIONS runs.
+
+  The exit status is 0 if every native filter reaches its minimum PSNR for every image and sigma and 1 otherwise.
+
+  Audit Trail
+  --------------------
+  17 October 2026: created
+*/
+
+#include "module5/gaussianFiltering.h"
+#include "module5/imageBenchmark.h"
+
+#define GAUSSIAN_REPETITIONS    3      // fewer than BENCHMARK_REPETITIONS: every image is filtered 4 x BENCHMARK_MAX_SIGMA times
+#define BENCHMARK_MAX_SIGMA     20
+#define BENCHMARK_WIDTH         1920
+#define BENCHMARK_HEIGHT        1080
+#define FIR_MIN_PSNR            48.0   // dB: a difference of at most one grey-level everywhere gives at least 48.1 dB
+#define APPROXIMATION_MIN_PSNR  30.0   // dB
+
+/* globals used by the trackbar callback in gaussianFilteringImplementation.cpp; the benchmark does not call it */
+
+Mat src;
+int noise_std_dev    = 0;
+int gaussian_std_dev = 0;
+int filter_mode      = GAUSSIAN_OPENCV;
+int cache_noise      = 1;
+unsigned int image_number = 0;
+const char* processed_window_name = "Gaussian Image";
+
+
+int main(int argc, char **argv) {
+
+   int  number_of_images = numberOfBenchmarkImages(argc, argv);
+   int  i, sigma, mode;
+   bool passed = true;
+   bool mode_passed;
+
+   Mat original, image;
+   Mat reference, filtered;
+   double elapsed_ms[4];
+   double psnr[4];
+   const char *mode_names[] = {"OpenCV", "FIR", "IIR", "Box"};
+
+   for (i = 0; i < number_of_images; i++) {
+
+      if (!readBenchmarkImage(argc, argv, i, original)) {
+         return 1;
+      }
+
+      resize(original, image, Size(BENCHMARK_WIDTH, BENCHMARK_HEIGHT), 0, 0, INTER_LINEAR);
+
+      printf("%s, %d x %d: time in ms (PSNR in dB with respect to OpenCV)\n", benchmarkImageName(argc, argv, i),
+             image.cols, image.rows);
+      printf("sigma");
+      for (mode = GAUSSIAN_OPENCV; mode <= GAUSSIAN_BOX; mode++) printf(" %18s", mode_names[mode]);
+      printf("\n");
+
+      for (sigma = 1; sigma <= BENCHMARK_MAX_SIGMA; sigma++) {
+
+         GaussianBlur(image, reference, Size(4 * sigma + 1, 4 * sigma + 1), sigma);
+
+         for (mode = GAUSSIAN_OPENCV; mode <= GAUSSIAN_BOX; mode++) {
+            elapsed_ms[mode] = shortestTime([&] { gaussianFilter(image, filtered, sigma, mode); }, GAUSSIAN_REPETITIONS);
+            psnr[mode]       = PSNR(filtered, reference);
+         }
+
+         printf("%5d", sigma);
+         for (mode = GAUSSIAN_OPENCV; mode <= GAUSSIAN_BOX; mode++) {
+            mode_passed = mode == GAUSSIAN_OPENCV || psnr[mode] >= (mode == GAUSSIAN_FIR ? FIR_MIN_PSNR : APPROXIMATION_MIN_PSNR);
+            passed      = passed && mode_passed;
+            printf(" %9.2f (%5.1f)%s", elapsed_ms[mode], psnr[mode], mode_passed ? " " : "*");
+         }
+         printf("\n");
+      }
+      printf("\n");
+   }
+
+   printf("* below the minimum PSNR\n");
+   printf(passed ? "gaussianFilteringBenchmark: passed\n" : "gaussianFilteringBenchmark: FAILED\n");
+   return passed ? 0 : 1;
+}
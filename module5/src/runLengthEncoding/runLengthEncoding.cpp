@@ -0,0 +1,677 @@
+/*
+  Run-length encoded binary images
+  --------------------------------
+
+  (This is the implementation file: it contains the code for the functions that create and process run-length encoded
+  binary images.  The functions are declared in the interface file runLengthEncoding.h.)
+
+  Audit Trail
+  --------------------
+  Created: thresholdToRuns(), binaryToRuns(), runsToBinary(), labelRuns(), runLabelsToImage(), traceContours(),
+  runMoments(); labelRuns() is the run-length union-find labeller that was in connectedComponents
+  17 October 2026
+*/
+
+#include "module5/runLengthEncoding.h"
+
+
+/* number of horizontal stripes of rows processed in parallel */
+
+static int numberOfStripes(int rows) {
+
+   return max(1, min(getNumThreads(), rows / RLE_MIN_STRIPE_ROWS));
+}
+
+
+/* thresholdToRuns()
+
+   Threshold an 8-bit greyscale image directly to runs, without an intermediate binary image
+   type THRESH_BINARY:     the foreground is the pixels greater than threshold
+   type THRESH_BINARY_INV: the foreground is the pixels less than or equal to threshold
+   i.e. the same foreground as threshold(greyscaleImage, binaryImage, threshold, 255, type)
+
+   Stripes of rows are encoded in parallel and then concatenated.
+*/
+
+void thresholdToRuns(const Mat &greyscaleImage, int threshold, int type, runLengthImageType &rle) {
+
+   int rows = greyscaleImage.rows;
+   int cols = greyscaleImage.cols;
+   int number_of_stripes = numberOfStripes(rows);
+   int offset;
+   int row, stripe;
+   uchar foreground[256];
+   int i;
+
+   CV_Assert(greyscaleImage.type() == CV_8UC1);
+   CV_Assert(type == THRESH_BINARY || type == THRESH_BINARY_INV);
+
+   for (i = 0; i < 256; i++) {
+      foreground[i] = (i > threshold) == (type == THRESH_BINARY);
+   }
+
+   vector< vector<runType> > stripe_runs(number_of_stripes);
+
+   rle.rows = rows;
+   rle.cols = cols;
+   rle.row_start.resize(rows + 1);
+
+   parallel_for_(Range(0, number_of_stripes), [&](const Range &range) {
+
+      for (int stripe = range.start; stripe < range.end; stripe++) {
+
+         vector<runType> &runs = stripe_runs[stripe];
+         runType run;
+
+         for (int row = stripe * rows / number_of_stripes; row < (stripe + 1) * rows / number_of_stripes; row++) {
+
+            const uchar *p = greyscaleImage.ptr<uchar>(row);
+            int col = 0;
+
+            rle.row_start[row] = (int) runs.size();   // index within the stripe for now
+
+            while (col < cols) {
+               while (col < cols && !foreground[p[col]]) col++;
+               if (col == cols) break;
+               run.start = col;
+               while (col < cols && foreground[p[col]]) col++;
+               run.end = col - 1;
+               runs.push_back(run);
+            }
+         }
+      }
+   });
+
+   offset = 0;
+   rle.runs.clear();
+
+   for (stripe = 0; stripe < number_of_stripes; stripe++) {
+      for (row = stripe * rows / number_of_stripes; row < (stripe + 1) * rows / number_of_stripes; row++) {
+         rle.row_start[row] += offset;
+      }
+      rle.runs.insert(rle.runs.end(), stripe_runs[stripe].begin(), stripe_runs[stripe].end());
+      offset += (int) stripe_runs[stripe].size();
+   }
+
+   rle.row_start[rows] = offset;
+}
+
+
+/* binaryToRuns()
+
+   Encode a binary image, e.g. the output of threshold(): the foreground is the non-zero pixels
+*/
+
+void binaryToRuns(const Mat &binaryImage, runLengthImageType &rle) {
+
+   thresholdToRuns(binaryImage, 0, THRESH_BINARY, rle);
+}
+
+
+/* runsToBinary()
+
+   Decode to a CV_8UC1 image: 255 for the foreground, 0 for the background
+*/
+
+void runsToBinary(const runLengthImageType &rle, Mat &binaryImage) {
+
+   binaryImage.create(rle.rows, rle.cols, CV_8UC1);
+
+   parallel_for_(Range(0, rle.rows), [&](const Range &range) {
+      for (int row = range.start; row < range.end; row++) {
+         uchar *p = binaryImage.ptr<uchar>(row);
+         memset(p, 0, rle.cols);
+         for (int i = rle.row_start[row]; i < rle.row_start[row + 1]; i++) {
+            memset(p + rle.runs[i].start, 255, rle.runs[i].end - rle.runs[i].start + 1);
+         }
+      }
+   });
+}
+
+
+/* complementRuns()
+
+   The runs of the background: the gaps between the runs of each row
+*/
+
+void complementRuns(const runLengthImageType &rle, runLengthImageType &complement) {
+
+   int row, i, col;
+   runType gap;
+
+   complement.rows = rle.rows;
+   complement.cols = rle.cols;
+   complement.row_start.resize(rle.rows + 1);
+   complement.runs.clear();
+   complement.runs.reserve(rle.runs.size() + rle.rows);
+
+   for (row = 0; row < rle.rows; row++) {
+
+      complement.row_start[row] = (int) complement.runs.size();
+      col = 0;
+
+      for (i = rle.row_start[row]; i < rle.row_start[row + 1]; i++) {
+         if (rle.runs[i].start > col) {
+            gap.start = col;
+            gap.end   = rle.runs[i].start - 1;
+            complement.runs.push_back(gap);
+         }
+         col = rle.runs[i].end + 1;
+      }
+
+      if (col < rle.cols) {
+         gap.start = col;
+         gap.end   = rle.cols - 1;
+         complement.runs.push_back(gap);
+      }
+   }
+
+   complement.row_start[rle.rows] = (int) complement.runs.size();
+}
+
+
+/* index of the run of row that ends at or after col, or the end of the row's runs if there is none */
+
+static int findRun(const runLengthImageType &rle, int row, int col) {
+
+   int low  = rle.row_start[row];
+   int high = rle.row_start[row + 1];
+   int middle;
+
+   while (low < high) {
+      middle = (low + high) / 2;
+      if (rle.runs[middle].end < col) low  = middle + 1;
+      else                            high = middle;
+   }
+   return low;
+}
+
+
+/* runPixel()
+
+   true if the pixel at (row, col) is foreground; pixels outside the image are background
+*/
+
+bool runPixel(const runLengthImageType &rle, int row, int col) {
+
+   int i;
+
+   if (row < 0 || row >= rle.rows || col < 0 || col >= rle.cols) return false;
+
+   i = findRun(rle, row, col);
+
+   return i < rle.row_start[row + 1] && rle.runs[i].start <= col;
+}
+
+
+/* runCompression()
+
+   Size of the 8-bit image divided by the size of its run-length encoding
+*/
+
+double runCompression(const runLengthImageType &rle) {
+
+   double encoded_size = (double) rle.runs.size() * sizeof(runType) + (double) rle.row_start.size() * sizeof(int);
+
+   return (double) rle.rows * rle.cols / encoded_size;
+}
+
+
+/* union-find over run indices: the root of a set is its smallest index, i.e. its first run in raster order */
+
+static int findRoot(vector<int> &parent, int i) {
+
+   while (parent[i] != i) {
+      parent[i] = parent[parent[i]];  // path halving
+      i = parent[i];
+   }
+   return i;
+}
+
+static void unite(vector<int> &parent, int i, int j) {
+
+   i = findRoot(parent, i);
+   j = findRoot(parent, j);
+
+   if (i < j)      parent[j] = i;
+   else if (j < i) parent[i] = j;
+}
+
+
+/* unite the runs of row - 1 with the runs of row that touch them: gap is 1 for 8-connectivity and 0 for 4-connectivity */
+
+static void uniteRows(const runLengthImageType &rle, vector<int> &parent, int row, int gap) {
+
+   int a     = rle.row_start[row - 1];
+   int end_a = rle.row_start[row];
+   int b     = rle.row_start[row];
+   int end_b = rle.row_start[row + 1];
+
+   while (a < end_a && b < end_b) {
+
+      if (rle.runs[a].start <= rle.runs[b].end + gap && rle.runs[b].start <= rle.runs[a].end + gap) {
+         unite(parent, a, b);
+      }
+
+      /* advance the run that finishes first; the other may still touch the next run */
+
+      if (rle.runs[a].end < rle.runs[b].end) a++;
+      else                                   b++;
+   }
+}
+
+
+/* labelRuns()
+
+   Label the connected components of the runs, with 8-connectivity or 4-connectivity
+
+   run_label:   one entry per run: 1 to n, numbered in raster order of the first pixel of each component,
+                as cv::connectedComponents() does with CCL_WU
+   statistics:  if not NULL, n + 1 entries; entry i describes component i (entry 0 is not used)
+
+   Returns n, the number of components.
+
+   The runs are united with a union-find over run indices.  Each stripe of rows unites its own runs in parallel; the
+   runs on either side of each stripe boundary are then united, and the sets are numbered.
+   The moments of a run have a closed form, so the statistics are accumulated per run, not per pixel.
+*/
+
+int labelRuns(const runLengthImageType &rle, int connectivity, vector<int> &run_label, vector<componentStatisticsType> *statistics) {
+
+   int rows = rle.rows;
+   int number_of_stripes = numberOfStripes(rows);
+   int number_of_runs = (int) rle.runs.size();
+   int number_of_components;
+   int gap = connectivity == 8 ? 1 : 0;
+   int stripe, row, i, root;
+   double n, y, sum_x, sum_xx;
+
+   CV_Assert(connectivity == 8 || connectivity == 4);
+
+   vector<int> parent(number_of_runs);
+
+   for (i = 0; i < number_of_runs; i++) {
+      parent[i] = i;
+   }
+
+   /* unions within a stripe only involve runs of that stripe, so the stripes share the parent array safely */
+
+   parallel_for_(Range(0, number_of_stripes), [&](const Range &range) {
+      for (int stripe = range.start; stripe < range.end; stripe++) {
+         for (int row = stripe * rows / number_of_stripes + 1; row < (stripe + 1) * rows / number_of_stripes; row++) {
+            uniteRows(rle, parent, row, gap);
+         }
+      }
+   });
+
+   for (stripe = 1; stripe < number_of_stripes; stripe++) {
+      uniteRows(rle, parent, stripe * rows / number_of_stripes, gap);
+   }
+
+   /* number the sets in raster order and accumulate the statistics of each run into its component */
+
+   run_label.resize(number_of_runs);
+
+   if (statistics != NULL) {
+      statistics->clear();
+      statistics->push_back(componentStatisticsType());  // the background
+   }
+
+   number_of_components = 0;
+
+   for (row = 0; row < rows; row++) {
+      for (i = rle.row_start[row]; i < rle.row_start[row + 1]; i++) {
+
+         const runType &run = rle.runs[i];
+
+         root = findRoot(parent, i);
+
+         if (root == i) {
+            run_label[i] = ++number_of_components;
+
+            if (statistics != NULL) {
+               componentStatisticsType component;
+               memset(&component, 0, sizeof(component));
+               component.left   = run.start;
+               component.top    = row;
+               component.right  = run.end;
+               component.bottom = row;
+               statistics->push_back(component);
+            }
+         }
+         else {
+            run_label[i] = run_label[root];   // root < i, so it has already been numbered
+         }
+
+         if (statistics == NULL) continue;
+
+         componentStatisticsType &c = (*statistics)[run_label[i]];
+
+         /* sums over x = start ... end of 1, x, and x^2 */
+
+         n      = run.end - run.start + 1;
+         y      = row;
+         sum_x  = n * (run.start + run.end) / 2.0;
+         sum_xx = ((double) run.end * (run.end + 1) * (2.0 * run.end + 1) -
+                   (double) (run.start - 1) * run.start * (2.0 * run.start - 1)) / 6.0;
+
+         c.area += n;
+         c.m10  += sum_x;
+         c.m01  += n * y;
+         c.m20  += sum_xx;
+         c.m11  += y * sum_x;
+         c.m02  += n * y * y;
+
+         if (run.start < c.left)   c.left   = run.start;
+         if (run.end   > c.right)  c.right  = run.end;
+         if (row       > c.bottom) c.bottom = row;
+      }
+   }
+
+   if (statistics != NULL) {
+      for (i = 1; i <= number_of_components; i++) {
+         componentStatisticsType &c = (*statistics)[i];
+         c.centroid_x = c.m10 / c.area;
+         c.centroid_y = c.m01 / c.area;
+         c.mu20 = c.m20 - c.centroid_x * c.m10;
+         c.mu11 = c.m11 - c.centroid_x * c.m01;
+         c.mu02 = c.m02 - c.centroid_y * c.m01;
+      }
+   }
+
+   return number_of_components;
+}
+
+
+/* runLabelsToImage()
+
+   labels: CV_32SC1, the label of each run written to its pixels, 0 for the background
+*/
+
+void runLabelsToImage(const runLengthImageType &rle, const vector<int> &run_label, Mat &labels) {
+
+   labels.create(rle.rows, rle.cols, CV_32SC1);
+
+   parallel_for_(Range(0, rle.rows), [&](const Range &range) {
+      for (int row = range.start; row < range.end; row++) {
+         int *p = labels.ptr<int>(row);
+         memset(p, 0, rle.cols * sizeof(int));
+         for (int i = rle.row_start[row]; i < rle.row_start[row + 1]; i++) {
+            for (int col = rle.runs[i].start; col <= rle.runs[i].end; col++) {
+               p[col] = run_label[i];
+            }
+         }
+      }
+   });
+}
+
+
+/* traceBorder()
+
+   Follow one border with the border following procedure of S. Suzuki and K. Abe, "Topological structural analysis of
+   digitized binary images by border following", CVGIP 30(1), 1985, which is also the one used by findContours().
+
+   (row, col) is the first pixel of the border and start_direction the direction of its background neighbour:
+   west for an outer border, east for a hole border.  Directions are numbered clockwise from east.
+   The pixels are queried in the runs, so only the pixels next to the border are visited.
+*/
+
+static void traceBorder(const runLengthImageType &rle, int row, int col, int start_direction, vector<Point> &contour) {
+
+   static const int d_row[8] = {0, 1, 1,  1,  0, -1, -1, -1};
+   static const int d_col[8] = {1, 1, 0, -1, -1, -1,  0,  1};
+
+   int d, k;
+   int previous;                // direction from the current pixel to the previous pixel
+   int first_row, first_col;    // second pixel of the border: tracing stops when it follows the first pixel again
+   int r, c;
+
+   contour.clear();
+
+   /* find the first foreground neighbour, clockwise from the background neighbour */
+
+   for (k = 0; k < 8; k++) {
+      d = (start_direction + k) & 7;
+      if (runPixel(rle, row + d_row[d], col + d_col[d])) break;
+   }
+
+   if (k == 8) {                // an isolated pixel
+      contour.push_back(Point(col, row));
+      return;
+   }
+
+   first_row = row + d_row[d];
+   first_col = col + d_col[d];
+   previous  = d;
+   r = row;
+   c = col;
+
+   while (true) {
+
+      /* find the next foreground neighbour, counterclockwise from the previous pixel */
+
+      for (k = 1; k <= 8; k++) {
+         d = (previous - k) & 7;
+         if (runPixel(rle, r + d_row[d], c + d_col[d])) break;
+      }
+
+      contour.push_back(Point(c, r));
+
+      if (r + d_row[d] == row && c + d_col[d] == col && r == first_row && c == first_col) break;
+
+      r += d_row[d];
+      c += d_col[d];
+      previous = (d + 4) & 7;
+   }
+}
+
+
+/* traceContours()
+
+   The outer border of every 8-connected component and the border of every hole (a 4-connected component of the
+   background that does not touch the edge of the image), with the same points and the same hierarchy layout as
+   findContours() with RETR_TREE and CHAIN_APPROX_NONE: hierarchy[i] is [next, previous, first child, parent],
+   and the contours are numbered in the same order.  This was checked point for point against findContours() in
+   OpenCV 4.11 and 5.0; the ordering is not part of the documented interface of findContours(), so check it again
+   before relying on it with another version.
+
+   The components and the holes are found by labelling the runs and the background runs; the parent of a component is
+   the hole to the left of its first pixel, and the parent of a hole is the component to the left of its first pixel.
+   The borders are then followed in parallel.
+*/
+
+void traceContours(const runLengthImageType &rle, vector<vector<Point> > &contours, vector<Vec4i> &hierarchy) {
+
+   runLengthImageType background;
+   vector<int> object_label;
+   vector<int> background_label;
+   int number_of_objects;
+   int number_of_backgrounds;
+   int number_of_contours;
+   int row, i, j, label;
+
+   number_of_objects = labelRuns(rle, 8, object_label);
+
+   complementRuns(rle, background);
+   number_of_backgrounds = labelRuns(background, 4, background_label);
+
+   /* background components that touch the edge of the image are not holes */
+
+   vector<bool> hole(number_of_backgrounds + 1, true);
+
+   for (row = 0; row < background.rows; row++) {
+      for (i = background.row_start[row]; i < background.row_start[row + 1]; i++) {
+         if (row == 0 || row == background.rows - 1 || background.runs[i].start == 0 || background.runs[i].end == background.cols - 1) {
+            hole[background_label[i]] = false;
+         }
+      }
+   }
+
+   /* the first run of each component and of each hole gives the first pixel of its border */
+
+   typedef struct {
+      int row;
+      int col;
+      int run;            // first run of the component or the hole
+      bool is_hole;
+   } borderStartType;
+
+   vector<borderStartType> starts;
+   vector<int> object_contour(number_of_objects + 1, -1);
+   vector<int> hole_contour(number_of_backgrounds + 1, -1);
+   borderStartType start;
+
+   for (row = 0; row < rle.rows; row++) {
+
+      for (i = rle.row_start[row]; i < rle.row_start[row + 1]; i++) {
+         if (object_contour[object_label[i]] == -1) {
+            object_contour[object_label[i]] = 0;
+            start.row = row;  start.col = rle.runs[i].start;  start.run = i;  start.is_hole = false;
+            starts.push_back(start);
+         }
+      }
+      for (i = background.row_start[row]; i < background.row_start[row + 1]; i++) {
+         label = background_label[i];
+         if (hole[label] && hole_contour[label] == -1) {
+            hole_contour[label] = 0;
+            start.row = row;  start.col = background.runs[i].start - 1;  start.run = i;  start.is_hole = true;
+            starts.push_back(start);
+         }
+      }
+   }
+
+   sort(starts.begin(), starts.end(), [](const borderStartType &a, const borderStartType &b) {
+      return a.row < b.row || (a.row == b.row && a.col < b.col);
+   });
+
+   number_of_contours = (int) starts.size();
+
+   for (i = 0; i < number_of_contours; i++) {
+      if (starts[i].is_hole) hole_contour[background_label[starts[i].run]] = i;
+      else                   object_contour[object_label[starts[i].run]]   = i;
+   }
+
+   /* the parent of each border, in order of discovery */
+
+   vector<int> parent(number_of_contours, -1);
+
+   for (i = 0; i < number_of_contours; i++) {
+
+      row = starts[i].row;
+
+      if (starts[i].is_hole) {
+         j = findRun(rle, row, starts[i].col);                           // the object run that ends at col
+         parent[i] = object_contour[object_label[j]];
+      }
+      else if (starts[i].col > 0) {
+         j = findRun(background, row, starts[i].col - 1);                // the background run that ends at col - 1
+         label = background_label[j];
+         if (hole[label]) parent[i] = hole_contour[label];
+      }
+   }
+
+   /* number the contours as findContours() does: depth first, with the children of each contour, and the top level, 
+      in reverse order of discovery */
+
+   vector< vector<int> > children(number_of_contours + 1);             // the last entry is for the top level
+   vector<int> stack;
+   vector<int> contour_number(number_of_contours);
+   vector<borderStartType> discovered(starts);
+   int n = 0;
+
+   for (i = 0; i < number_of_contours; i++) {
+      children[parent[i] < 0 ? number_of_contours : parent[i]].push_back(i);
+   }
+
+   stack = children[number_of_contours];
+   while (!stack.empty()) {
+      i = stack.back();
+      stack.pop_back();
+      contour_number[i] = n;
+      starts[n++] = discovered[i];
+      stack.insert(stack.end(), children[i].begin(), children[i].end());
+   }
+
+   hierarchy.assign(number_of_contours, Vec4i(-1, -1, -1, -1));
+
+   for (i = 0; i <= number_of_contours; i++) {
+
+      vector<int> &siblings = children[i];
+
+      for (j = (int) siblings.size() - 1; j >= 0; j--) {
+         Vec4i &h = hierarchy[contour_number[siblings[j]]];
+         if (j > 0)                         h[0] = contour_number[siblings[j - 1]];
+         if (j < (int) siblings.size() - 1) h[1] = contour_number[siblings[j + 1]];
+         if (i < number_of_contours)        h[3] = contour_number[i];
+      }
+      if (i < number_of_contours && !siblings.empty()) {
+         hierarchy[contour_number[i]][2] = contour_number[siblings.back()];
+      }
+   }
+
+   /* follow the borders */
+
+   contours.resize(number_of_contours);
+
+   parallel_for_(Range(0, number_of_contours), [&](const Range &range) {
+      for (int k = range.start; k < range.end; k++) {
+         traceBorder(rle, starts[k].row, starts[k].col, starts[k].is_hole ? 0 : 4, contours[k]);
+      }
+   });
+}
+
+
+/* runMoments()
+
+   The spatial moments up to third order of each labelled component, computed from its runs; moments[i] is the same as
+   moments() of the binary image of component i with binaryImage = true.  moments[0] is not used.
+*/
+
+void runMoments(const runLengthImageType &rle, const vector<int> &run_label, int number_of_labels, vector<Moments> &moments) {
+
+   vector<double> m(10 * (number_of_labels + 1), 0.0);  // m00 m10 m01 m20 m11 m02 m30 m21 m12 m03 of each label
+   double s0, s1, s2, s3, a, b;
+   double y, y2, y3;
+   double *p;
+   int row, i;
+
+   for (row = 0; row < rle.rows; row++) {
+
+      y  = row;
+      y2 = y * y;
+      y3 = y2 * y;
+
+      for (i = rle.row_start[row]; i < rle.row_start[row + 1]; i++) {
+
+         /* sums over x = start ... end of 1, x, x^2, x^3, from the sums over 0 ... n */
+
+         b = rle.runs[i].end;
+         a = rle.runs[i].start - 1;
+
+         s0 = b - a;
+         s1 = (b * (b + 1) - a * (a + 1)) / 2;
+         s2 = (b * (b + 1) * (2 * b + 1) - a * (a + 1) * (2 * a + 1)) / 6;
+         s3 = (b * b * (b + 1) * (b + 1) - a * a * (a + 1) * (a + 1)) / 4;
+
+         p = &m[10 * run_label[i]];
+
+         p[0] += s0;
+         p[1] += s1;
+         p[2] += s0 * y;
+         p[3] += s2;
+         p[4] += s1 * y;
+         p[5] += s0 * y2;
+         p[6] += s3;
+         p[7] += s2 * y;
+         p[8] += s1 * y2;
+         p[9] += s0 * y3;
+      }
+   }
+
+   moments.resize(number_of_labels + 1);
+
+   for (i = 0; i <= number_of_labels; i++) {
+      p = &m[10 * i];
+      moments[i] = Moments(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8], p[9]);
+   }
+}
@@ -30,6 +30,12 @@
   Ported to OpenCV 4
   David Vernon
   11 July 2024
+
+  Added the Norm slider: L1 or L2 gradient magnitude
+  17 October 2026
+
+  Headless batch mode: sobelEdgeDetection --batch <images> <output directory> [number of threads]
+  17 October 2026
 */
 
 #include "module5/sobelEdgeDetection.h"
@@ -39,11 +45,21 @@
 
 Mat inputImage;
 int thresholdValue            = 128; // default threshold
+int normType                  = SOBEL_L2; // 0 L1, 1 L2: see sobelFused()
 const char* magnitude_window_name   = "Sobel Gradient Magnitude";
 const char* direction_window_name   = "Sobel Gradient Direction";
 const char* edge_window_name        = "Sobel Edges";
 
-int main() {
+int main(int argc, char **argv) {
+
+   /* headless batch mode: see batchProcessing.h */
+
+   batchOptionsType batch_options;
+
+   if (isBatchMode(argc, argv)) {
+      if (!getBatchOptions(argc, argv, &batch_options)) return 1;
+      return runBatch(batch_options, "sobelEdgeDetection", IMREAD_GRAYSCALE, sobelEdgeDetectionBatch, NULL);
+   }
    
    #ifdef ROS
       // Turn off canonical terminal mode and character echoing
@@ -122,6 +138,7 @@ int main() {
          // Create a window for edges
          namedWindow(edge_window_name, WINDOW_AUTOSIZE );
          createTrackbar( "Threshold", edge_window_name, &thresholdValue, max_threshold, sobelEdgeDetection);
+         createTrackbar( "Norm", edge_window_name, &normType, SOBEL_L2, sobelEdgeDetection);
 
          // Show the image
          sobelEdgeDetection(0, 0);
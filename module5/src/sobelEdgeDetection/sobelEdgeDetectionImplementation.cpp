@@ -12,6 +12,18 @@
   --------------------
   Added _kbhit
   18 February 2021
+
+  Replaced Sobel(), cartToPolar(), threshold() and the display conversions with a single fused pass, sobelFused(), 
+  that computes the gradient magnitude, the edge mask, and the quantised orientation of the edge pixels together;
+  the greyscale image is converted only when the input image changes
+  17 October 2026
+
+  sobelFused() thresholds the magnitude saturated to 255, as documented, so that a threshold of 255 gives no edges;
+  removed the time printed on every trackbar event
+  17 October 2026
+
+  Added sobelEdgeDetectionBatch(): the core of the application for headless batch mode
+  17 October 2026
     
 */
  
@@ -26,45 +38,186 @@ void sobelEdgeDetection(int, void*) {
 
    extern Mat inputImage; 
    extern int thresholdValue; 
+   extern int normType; 
    extern char* magnitude_window_name;
    extern char* direction_window_name;
    extern char* edge_window_name;
 
+   static Mat greyscaleImage;            // cached: converted only when the input image changes
+   static uchar *greyscale_source = NULL;
+
+   Mat edgeImage;  
+   Mat magnitude;
+   Mat orientation_gray;
+   Mat magnitude_gray;
+   int maximum_magnitude;
+
+   if (greyscale_source != inputImage.data) {
+      if (inputImage.type() == CV_8UC3) { // colour image
+         cvtColor(inputImage, greyscaleImage, COLOR_BGR2GRAY);
+      } 
+      else {
+         greyscaleImage = inputImage.clone();
+      }
+      greyscale_source = inputImage.data;
+   }
+
+   maximum_magnitude = sobelFused(greyscaleImage, magnitude, orientation_gray, edgeImage, thresholdValue, normType);
+
+   /* scale so that the largest magnitude is displayed as white, as convert_32bit_image_for_display() does by default */
+
+   magnitude_gray = convert_32bit_image_for_display(magnitude, 0.0, 255.0 / max(maximum_magnitude, 1));
+
+   imshow(magnitude_window_name, magnitude_gray);   // DV
+   imshow(direction_window_name, orientation_gray); // DV
+   imshow(edge_window_name, edgeImage);             // DV
+}
+
+
+/* sobelFused()
+
+   Sobel gradient, magnitude, edge mask, and orientation in one pass over an 8-bit greyscale image
+
+   magnitude:   CV_16UC1, |gx| + |gy| (SOBEL_L1) or sqrt(gx^2 + gy^2) rounded to the nearest integer (SOBEL_L2)
+   edges:       CV_8UC1, 255 where the magnitude, saturated to 255, is greater than threshold, 0 elsewhere 
+                (i.e. threshold() with THRESH_BINARY applied to the 8-bit magnitude)
+   orientation: CV_8UC1, the gradient direction of the edge pixels quantised to 0 - 255 over 0 - 2 pi, 0 elsewhere
+
+   The return value is the largest magnitude in the image.
+
+   The 3x3 Sobel operator is separable: gx is the [1 2 1] column smoothing of the [-1 0 1] row derivative,
+   gy is the [-1 0 1] column derivative of the [1 2 1] row smoothing.  The image is processed in bands of rows in 
+   parallel.  Each band keeps the row derivative and row smoothing of the last three rows in small 16-bit buffers 
+   that stay in the cache, so every source row is read once and all outputs for a row are written together,
+   with no full-size intermediate images.  Borders are BORDER_REFLECT_101, as for Sobel().
+*/
+
+int sobelFused(const Mat &grey, Mat &magnitude, Mat &orientation, Mat &edges, int threshold, int norm) {
+
+   Mutex maximum_mutex;
+   int maximum = 0;
+   int cols = grey.cols;
+   int rows = grey.rows;
+
+   CV_Assert(grey.type() == CV_8UC1);
+
+   magnitude.create(grey.size(), CV_16UC1);
+   orientation.create(grey.size(), CV_8UC1);
+   edges.create(grey.size(), CV_8UC1);
+
+   parallel_for_(Range(0, rows), [&](const Range &range) {
+
+      std::vector<uchar> padded(cols + 2);
+      std::vector<short> derivative(3 * cols);   // [-1 0 1] along the row, for rows y-1, y, y+1
+      std::vector<short> smoothed(3 * cols);     // [1 2 1]  along the row, for rows y-1, y, y+1
+      short *d[3], *s[3], *t;
+      int band_maximum = 0;
+      int row, col, k;
+      int gx, gy, m;
+
+      /* row derivative and row smoothing of image row r into dr and sr */
+
+      auto rowPass = [&](int r, short *dr, short *sr) {
+         const uchar *p = grey.ptr<uchar>(r);
+         memcpy(&padded[1], p, cols);
+         padded[0]        = p[cols > 1 ? 1 : 0];
+         padded[cols + 1] = p[cols > 1 ? cols - 2 : 0];
+         for (int x = 0; x < cols; x++) {
+            dr[x] = (short) (padded[x + 2] - padded[x]);
+            sr[x] = (short) (padded[x] + 2 * padded[x + 1] + padded[x + 2]);
+         }
+      };
+
+      for (k = 0; k < 3; k++) {
+         d[k] = &derivative[k * cols];
+         s[k] = &smoothed[k * cols];
+      }
+
+      rowPass(rows > 1 ? abs(range.start - 1) : 0, d[0], s[0]);     // reflect 101 at the top of the image
+      rowPass(range.start, d[1], s[1]);
+
+      for (row = range.start; row < range.end; row++) {
+
+         int next = row + 1 < rows ? row + 1 : (rows > 1 ? rows - 2 : 0); // reflect 101 at the bottom
+         rowPass(next, d[2], s[2]);
+
+         ushort *p_magnitude = magnitude.ptr<ushort>(row);
+         uchar *p_orientation = orientation.ptr<uchar>(row);
+         uchar *p_edges = edges.ptr<uchar>(row);
+
+         for (col = 0; col < cols; col++) {
+
+            gx = d[0][col] + 2 * d[1][col] + d[2][col];
+            gy = s[2][col] - s[0][col];
+
+            if (norm == SOBEL_L1) {
+               m = abs(gx) + abs(gy);
+            }
+            else {
+               m = cvRound(sqrt((float) (gx * gx + gy * gy)));
+            }
+
+            p_magnitude[col] = (ushort) m;
+            if (m > band_maximum) band_maximum = m;
+
+            if (std::min(m, 255) > threshold) {         // the 8-bit magnitude, as threshold() saw it
+               p_edges[col] = 255;
+               p_orientation[col] = (uchar) cvRound(fastAtan2((float) gy, (float) gx) * (SOBEL_ORIENTATION_LEVELS / 360.0f));
+            }
+            else {
+               p_edges[col] = 0;
+               p_orientation[col] = 0;
+            }
+         }
+
+         /* slide the three-row window down one row */
+
+         t = d[0]; d[0] = d[1]; d[1] = d[2]; d[2] = t;
+         t = s[0]; s[0] = s[1]; s[1] = s[2]; s[2] = t;
+      }
+
+      AutoLock lock(maximum_mutex);
+      if (band_maximum > maximum) maximum = band_maximum;
+   });
+
+   return maximum;
+}
+
+
+/*
+ * sobelEdgeDetectionBatch
+ * Batch mode: write the gradient magnitude, a 16-bit image, to <output_stem>_magnitude.png, the orientation of the
+ * edge pixels to <output_stem>_orientation.png, and the edges at the default threshold to <output_stem>_edges.png
+ */
+
+bool sobelEdgeDetectionBatch(const Mat &image, const char *image_filename, const char *output_stem, int worker, void *context) {
+
+   extern int thresholdValue; 
+   extern int normType; 
+
    Mat greyscaleImage;
    Mat edgeImage;  
-   Mat horizontal_partial_derivative;
-   Mat vertical_partial_derivative;
-	Mat l2norm_gradient;
-   Mat orientation; 
+   Mat magnitude;
+   Mat orientation_gray;
+   bool ok;
 
-   if (inputImage.type() == CV_8UC3) { // colour image
-      cvtColor(inputImage, greyscaleImage, COLOR_BGR2GRAY);
+   if (image.type() == CV_8UC3) { // colour image
+      cvtColor(image, greyscaleImage, COLOR_BGR2GRAY);
    } 
    else {
-      greyscaleImage = inputImage.clone();
+      greyscaleImage = image;
    }
-    
-   /*******************************************************************************************************/
-   /*
-    * This code is provided as part of "A Practical Introduction to Computer Vision with OpenCV"
-    * by Kenneth Dawson-Howe © Wiley & Sons Inc. 2014.  All rights reserved.
-    */
-
-	Sobel(greyscaleImage,horizontal_partial_derivative,CV_32F,1,0);
-	Sobel(greyscaleImage,vertical_partial_derivative,CV_32F,0,1);
-	cartToPolar(horizontal_partial_derivative,vertical_partial_derivative,l2norm_gradient,orientation); 
-	Mat l2norm_gradient_gray = convert_32bit_image_for_display( l2norm_gradient );
-   Mat l2norm_gradient_mask, display_orientation;
-	l2norm_gradient.convertTo(l2norm_gradient_mask,CV_8U);
-	threshold(l2norm_gradient_mask,edgeImage,thresholdValue,255,THRESH_BINARY); // DV thresholdValue edgeImage
-	orientation.copyTo(display_orientation, edgeImage);
-	Mat orientation_gray = convert_32bit_image_for_display(display_orientation, 0.0, 255.0/(2.0*PI) ); 
-
-   imshow(magnitude_window_name, l2norm_gradient_gray); // DV
-   imshow(direction_window_name, orientation_gray);     // DV
-   imshow(edge_window_name, edgeImage);                 // DV
+
+   sobelFused(greyscaleImage, magnitude, orientation_gray, edgeImage, thresholdValue, normType);
+
+   ok =       imwrite(string(output_stem) + "_magnitude.png",   magnitude);
+   ok = ok && imwrite(string(output_stem) + "_orientation.png", orientation_gray);
+   ok = ok && imwrite(string(output_stem) + "_edges.png",       edgeImage);
+
+   return ok;
 }
 
+
 void prompt_and_exit(int status) {
    printf("Press any key to continue and close terminal ... \n");
    getchar();